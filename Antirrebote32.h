@@ -0,0 +1,48 @@
+#ifndef ANTIRREBOTE32_H
+#define ANTIRREBOTE32_H
+
+// Antirrebote de hasta 32 entradas a la vez con contadores verticales.
+//
+// Cada entrada tiene un contador de 2 bits, pero los bits no se guardan juntos:
+// c0 tiene el bit bajo de los 32 contadores y c1 el bit alto. Así una muestra
+// se procesa con unas cuantas operaciones lógicas sobre palabras de 32 bits,
+// sin importar cuántas entradas haya: agregar un botón no cuesta nada.
+//
+// Una entrada cambia de estado cuando 4 muestras seguidas difieren del estado
+// aceptado; una sola muestra igual reinicia su contador.
+//
+//   antirrebote32_t botones = {0};
+//   uint32_t cambios = antirrebote32_muestra(&botones, ~GPIO.in, MASCARA);
+//   // botones.estado: entradas ya filtradas, cambios: las que cambiaron ahora
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t c0, c1;     // Contadores verticales (bit bajo y bit alto)
+    uint32_t estado;     // Estado filtrado, 1 = activa
+} antirrebote32_t;
+
+// Procesa una muestra de las entradas de "mascara" (las demás no cambian).
+// Regresa los bits que cambiaron de estado en esta muestra
+static inline uint32_t antirrebote32_muestra(antirrebote32_t *a, uint32_t entrada, uint32_t mascara) {
+    uint32_t diferente = (entrada ^ a->estado) & mascara;
+    uint32_t c0 = a->c0, c1 = a->c1;
+
+    // Las entradas muestreadas e iguales al estado vuelven a 0; las diferentes cuentan 0-1-2-3-0
+    c1 = ((c1 ^ c0) & diferente) | (c1 & ~mascara);
+    c0 = (~c0 & diferente) | (c0 & ~mascara);
+
+    // Después de 4 muestras diferentes el contador dio la vuelta a 0
+    uint32_t cambios = diferente & ~(c0 | c1);
+    a->c0 = c0;
+    a->c1 = c1;
+    a->estado ^= cambios;
+    return cambios;
+}
+
+// Entradas que están contando (rebotando o a punto de cambiar)
+static inline uint32_t antirrebote32_ocupadas(const antirrebote32_t *a) {
+    return a->c0 | a->c1;
+}
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef BANCOSERVOS_H
+#define BANCOSERVOS_H
+
+// Banco de hasta 6 servos en el MCPWM0: los tres timers con sus salidas A y B.
+//
+//   servo 0 = MCPWM0A (timer 0, A)   servo 1 = MCPWM0B (timer 0, B)
+//   servo 2 = MCPWM1A (timer 1, A)   servo 3 = MCPWM1B (timer 1, B)
+//   servo 4 = MCPWM2A (timer 2, A)   servo 5 = MCPWM2B (timer 2, B)
+//
+// Los timers 1 y 2 se sincronizan con el cero del timer 0, así los tres
+// empiezan cada periodo al mismo tiempo. Una sola interrupción por periodo (el
+// cero del timer 0) despierta a la tarea del banco, que avanza el planificador
+// de todos los servos y escribe todos los comparadores. Como el driver carga
+// los comparadores en el siguiente cero, todos los canales cambian en el mismo
+// flanco. Agregar servos no agrega interrupciones ni despertares.
+//
+// Además del cambio directo de objetivo (bancoServos_mover) hay un buzón de
+// órdenes: ISR y tareas publican sin bloquear (en décimas de grado, sin
+// flotantes) y solo cuenta el último objetivo de cada servo. La tarea del
+// banco lo vacía una vez por periodo, así una ráfaga de órdenes no hace pasar
+// al servo por todos los objetivos intermedios.
+//
+// Los pulsos salen de las tablas de MapeoServo.h en ticks del timer (3.2 MHz):
+// antes de incluir este archivo el programa define MAPEO_CALIBRACIONES con una
+// tabla por servo.
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/mcpwm.h"
+#include "soc/mcpwm_struct.h"
+#include "soc/periph_defs.h"
+#include "hal/mcpwm_ll.h"
+#include "esp_intr_alloc.h"
+#include "PlanMovimiento.h"
+#include "MapeoServo.h"
+
+#define BANCO_SERVOS_MAX 6
+#define BANCO_PERIODO_PWM_S (1.0f / 50)
+
+#ifndef BANCO_VELOCIDAD_MAX
+#define BANCO_VELOCIDAD_MAX 180.0f     // Grados/s
+#endif
+#ifndef BANCO_ACELERACION_MAX
+#define BANCO_ACELERACION_MAX 360.0f   // Grados/s^2
+#endif
+
+// Buzón: último objetivo de cada servo (décimas de grado) y un bit por servo con orden nueva
+typedef struct {
+    volatile int32_t objetivos[BANCO_SERVOS_MAX];
+    volatile uint32_t pendientes;
+    volatile uint32_t publicadas;   // Órdenes recibidas
+    volatile uint32_t combinadas;   // Reemplazadas por otra antes de aplicarse
+    volatile uint32_t aplicadas;    // Tomadas por la tarea del banco
+} buzonServos_t;
+
+typedef struct {
+    int n;
+    planMovimiento_t planes[BANCO_SERVOS_MAX];   // Solo los toca la tarea del banco
+    float objetivos[BANCO_SERVOS_MAX];           // Órdenes directas (bancoServos_mover), con el candado
+    uint32_t cambios;              // Un bit por servo con orden directa sin tomar, con el candado
+    portMUX_TYPE candado;          // Los objetivos se cambian todos juntos
+    TaskHandle_t tarea;
+    volatile uint32_t cuadros;     // Periodos en los que se escribieron los comparadores
+    buzonServos_t buzon;
+} bancoServos_t;
+
+static bancoServos_t bancoServos = {.candado = portMUX_INITIALIZER_UNLOCKED};
+
+// Timer 0 del MCPWM en cero (inicio de cada periodo): despierta a la tarea del banco.
+// La línea es compartida: si la interrupción fue de otra fuente no hace nada
+static void IRAM_ATTR bancoServos_inicioPeriodo(void *arg) {
+    if (!MCPWM0.int_st.timer0_tez_int_st) return;
+    MCPWM0.int_clr.timer0_tez_int_clr = 1;
+    BaseType_t despertar = pdFALSE;
+    vTaskNotifyGiveFromISR(bancoServos.tarea, &despertar);
+    if (despertar == pdTRUE) portYIELD_FROM_ISR();
+}
+
+// Escribe el comparador de un servo en ticks; el ángulo se redondea a décimas de grado.
+// mcpwm_set_duty() pide un % en float y lo vuelve a pasar a ticks, así que se
+// escribe el comparador directo. El driver lo dejó con sombra: el valor nuevo
+// entra en el siguiente cero del timer, igual que con mcpwm_set_duty()
+static inline void bancoServos_escribir(int servo, float angulo) {
+    uint32_t ticks = mapeo_ticks(servo, (int)(angulo * 10 + 0.5f));
+    mcpwm_ll_operator_set_compare_value(&MCPWM0, servo / 2, servo % 2, ticks);
+}
+
+// Un paso de todos los servos por periodo. Sin movimiento la interrupción se apaga.
+// Con el candado solo se copian las órdenes directas y se decide la interrupción:
+// el planificador y los comparadores corren sin él
+static void bancoServos_tarea(void *pvParameters) {
+    float objetivos[BANCO_SERVOS_MAX];
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        portENTER_CRITICAL(&bancoServos.candado);
+        uint32_t cambios = bancoServos.cambios;
+        bancoServos.cambios = 0;
+        for (uint32_t bits = cambios; bits; bits &= bits - 1) {
+            int k = __builtin_ctz(bits);
+            objetivos[k] = bancoServos.objetivos[k];
+        }
+        portEXIT_CRITICAL(&bancoServos.candado);
+
+        // Órdenes del buzón: se toman todas de una vez, una por servo
+        buzonServos_t *buzon = &bancoServos.buzon;
+        uint32_t nuevas = __atomic_exchange_n(&buzon->pendientes, 0, __ATOMIC_ACQUIRE);
+
+        for (uint32_t bits = cambios; bits; bits &= bits - 1) {
+            int k = __builtin_ctz(bits);
+            plan_objetivo(&bancoServos.planes[k], objetivos[k]);
+        }
+        for (uint32_t bits = nuevas; bits; bits &= bits - 1) {
+            int k = __builtin_ctz(bits);
+            plan_objetivo(&bancoServos.planes[k], buzon->objetivos[k] / 10.0f);
+        }
+        bool enMovimiento = false;
+        for (int k = 0; k < bancoServos.n; k++) {
+            bancoServos_escribir(k, plan_paso(&bancoServos.planes[k], BANCO_PERIODO_PWM_S));
+            enMovimiento |= plan_enMovimiento(&bancoServos.planes[k]);
+        }
+        bancoServos.cuadros++;
+
+        // Una orden que llegó después de tomar las órdenes enciende la interrupción
+        // con el candado, así que aquí ya se ve su bit
+        portENTER_CRITICAL(&bancoServos.candado);
+        if (!enMovimiento && bancoServos.cambios == 0 &&
+            __atomic_load_n(&bancoServos.buzon.pendientes, __ATOMIC_RELAXED) == 0) {
+            MCPWM0.int_ena.timer0_tez_int_ena = 0;
+        }
+        portEXIT_CRITICAL(&bancoServos.candado);
+
+        if (nuevas) {
+            __atomic_fetch_add(&buzon->aplicadas, __builtin_popcount(nuevas), __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// Configura n servos (pines en orden de canal) quietos en sus ángulos iniciales
+static inline void bancoServos_iniciar(const int pines[], int n, const float angulos[]) {
+    if (n > BANCO_SERVOS_MAX) n = BANCO_SERVOS_MAX;
+    if (n > MAPEO_SERVOS) n = MAPEO_SERVOS;   // Sin tabla de calibración no hay servo
+    bancoServos.n = n;
+
+    for (int k = 0; k < n; k++) {
+        mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM0A + k, pines[k]);
+    }
+
+    mcpwm_config_t pwm_config = {
+        .frequency = 50,    // Frecuencia de 50 Hz (para servos)
+        .cmpr_a = 0,
+        .cmpr_b = 0,
+        .counter_mode = MCPWM_UP_COUNTER,
+        .duty_mode = MCPWM_DUTY_MODE_0,
+    };
+    int timers = (n + 1) / 2;
+    // 16 MHz en el grupo y 3.2 MHz en cada timer: el periodo de 20 ms son 64000
+    // ticks (cabe en 16 bits) y cada tick son 0.3125 us en lugar de 1 us
+    mcpwm_group_set_resolution(MCPWM_UNIT_0, MAPEO_RESOLUCION_GRUPO_HZ);
+    for (int t = 0; t < timers; t++) {
+        mcpwm_timer_set_resolution(MCPWM_UNIT_0, t, MAPEO_RESOLUCION_HZ);
+        mcpwm_init(MCPWM_UNIT_0, t, &pwm_config);
+    }
+
+    // Los timers 1 y 2 se reinician con el cero del timer 0
+    mcpwm_set_timer_sync_output(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_SWSYNC_SOURCE_TEZ);
+    mcpwm_sync_config_t sincronia = {
+        .sync_sig = MCPWM_SELECT_TIMER0_SYNC,
+        .timer_val = 0,
+        .count_direction = MCPWM_TIMER_DIRECTION_UP,
+    };
+    for (int t = 1; t < timers; t++) {
+        mcpwm_sync_configure(MCPWM_UNIT_0, t, &sincronia);
+    }
+
+    for (int k = 0; k < n; k++) {
+        plan_iniciar(&bancoServos.planes[k], angulos[k], BANCO_VELOCIDAD_MAX, BANCO_ACELERACION_MAX);
+        bancoServos_escribir(k, angulos[k]);
+    }
+
+    xTaskCreate(bancoServos_tarea, "BancoServos", 2048, NULL, configMAX_PRIORITIES - 1, &bancoServos.tarea);
+    // El TEZ del timer 0 se enciende y se apaga escribiendo MCPWM0.int_ena
+    // directamente, sin el driver: nadie más puede usar interrupciones del
+    // MCPWM0 (capturas, fallas, el driver nuevo) mientras el banco esté activo
+    ESP_ERROR_CHECK(esp_intr_alloc(ETS_PWM0_INTR_SOURCE, ESP_INTR_FLAG_SHARED | ESP_INTR_FLAG_IRAM,
+                                   bancoServos_inicioPeriodo, NULL, NULL));
+}
+
+// Nuevos objetivos de todos los servos a la vez: la tarea los ve completos en el
+// mismo periodo. Pueden cambiar a mitad de un movimiento
+static inline void bancoServos_mover(const float angulos[]) {
+    portENTER_CRITICAL(&bancoServos.candado);
+    for (int k = 0; k < bancoServos.n; k++) {
+        bancoServos.objetivos[k] = angulos[k];
+    }
+    bancoServos.cambios = (1UL << bancoServos.n) - 1;
+    MCPWM0.int_ena.timer0_tez_int_ena = 1;
+    portEXIT_CRITICAL(&bancoServos.candado);
+}
+
+// Nuevo objetivo de un solo servo
+static inline void bancoServos_moverUno(int servo, float angulo) {
+    portENTER_CRITICAL(&bancoServos.candado);
+    bancoServos.objetivos[servo] = angulo;
+    bancoServos.cambios |= 1UL << servo;
+    MCPWM0.int_ena.timer0_tez_int_ena = 1;
+    portEXIT_CRITICAL(&bancoServos.candado);
+}
+
+// Publica un objetivo en décimas de grado, desde una ISR o una tarea. Sin
+// flotantes: en el ESP32-S3 una ISR no puede usar la FPU. No espera a nadie:
+// si ya había una orden sin aplicar para ese servo, esta la reemplaza.
+// Si la tarea toma el bit justo entre las dos escrituras, la orden se aplica
+// en este periodo y otra vez (igual) en el siguiente
+static inline void IRAM_ATTR bancoServos_publicar(int servo, int32_t decigrados) {
+    buzonServos_t *buzon = &bancoServos.buzon;
+    __atomic_store_n(&buzon->objetivos[servo], decigrados, __ATOMIC_RELAXED);
+    uint32_t antes = __atomic_fetch_or(&buzon->pendientes, 1UL << servo, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&buzon->publicadas, 1, __ATOMIC_RELAXED);
+    if (antes & (1UL << servo)) {
+        __atomic_fetch_add(&buzon->combinadas, 1, __ATOMIC_RELAXED);
+    } else {
+        // Primera orden pendiente: encender la interrupción del periodo
+        portENTER_CRITICAL_SAFE(&bancoServos.candado);
+        MCPWM0.int_ena.timer0_tez_int_ena = 1;
+        portEXIT_CRITICAL_SAFE(&bancoServos.candado);
+    }
+}
+
+// Vuelve a escribir los comparadores en el siguiente periodo (después de
+// cambiar una tabla de calibración con los servos quietos)
+static inline void bancoServos_refrescar(void) {
+    portENTER_CRITICAL(&bancoServos.candado);
+    MCPWM0.int_ena.timer0_tez_int_ena = 1;
+    portEXIT_CRITICAL(&bancoServos.candado);
+}
+
+#endif
@@ -1,24 +1,35 @@
-#include <unistd.h>
 #include "sdkconfig.h"
 #include "driver/gpio.h"
+#include "GeneradorSenal.h"
+#include "PatronRMT.h"
 
 #define pinLED 12
-#define ALTO 1
-#define BAJO 0
+#define SENAL_RMT 0   // 1 = la misma señal con el generador de patrones del RMT
 
 // Definimos los tiempos en microsegundos
-int tiempoBajo = 7500; // 100 ms
-int tiempoAlto = 833; // 100 ms
+int tiempoBajo = 7500; // 7.5 ms
+int tiempoAlto = 833; // 833 us
+
+#if SENAL_RMT
+// Los símbolos se leen mientras se repite el patrón: no pueden estar en la pila
+static rmt_symbol_word_t simbolos[8];
+static patronRMT_t patron;
+#endif
 
 void app_main(void) {
     gpio_reset_pin(pinLED);
-    gpio_set_direction(pinLED, GPIO_MODE_OUTPUT);
-
-    while (true) {
-        gpio_set_level(pinLED, ALTO);
-        usleep(tiempoAlto); // Convertir ms a microsegundos
 
-        gpio_set_level(pinLED, BAJO);
-        usleep(tiempoBajo); // Convertir ms a microsegundos
-    }
+#if SENAL_RMT
+    // Cualquier tabla de (nivel, duración) sirve; esta es la del parpadeo
+    const pulsoRMT_t pulsos[] = {
+        {1, PATRON_US(tiempoAlto)},
+        {0, PATRON_US(tiempoBajo)},
+    };
+    int n = patronRMT_codificarPulsos(pulsos, 2, simbolos, 8);
+    ESP_ERROR_CHECK(patronRMT_iniciar(&patron, pinLED, false));
+    ESP_ERROR_CHECK(patronRMT_enviar(&patron, simbolos, n, -1));
+#else
+    // El LEDC genera la señal solo; app_main termina y el CPU queda libre
+    ESP_ERROR_CHECK(generadorSenal_iniciar(pinLED, tiempoAlto, tiempoBajo));
+#endif
 }
@@ -1,29 +1,27 @@
-#include <unistd.h>
 #include <stdio.h>
 #include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "driver/gpio.h"
-#include "esp_task_wdt.h"
+#include "GeneradorSenal.h"
 
 #define pinLED 12
-#define ALTO 1
-#define BAJO 0
 
 // Definimos los tiempos en microsegundos
-int tiempoBajo = 7500; // 100 ms
-int tiempoAlto = 833; // 100 ms
+int tiempoBajo = 7500; // 7.5 ms
+int tiempoAlto = 833; // 833 us
 
 void app_main(void) {
-    esp_task_wdt_deinit();
+    // La señal la genera el LEDC: ya no hace falta apagar el watchdog
     int cuenta = 0;
     printf("Cuenta: %d\n",cuenta);
     gpio_reset_pin(pinLED);
-    gpio_set_direction(pinLED, GPIO_MODE_OUTPUT);
+    ESP_ERROR_CHECK(generadorSenal_iniciar(pinLED, tiempoAlto, tiempoBajo));
 
+    // El CPU queda libre para contar mientras la señal sigue sin cambios
     while (true) {
-        gpio_set_level(pinLED, ALTO);
-        usleep(tiempoAlto); // Convertir ms a microsegundos
-
-        gpio_set_level(pinLED, BAJO);
-        usleep(tiempoBajo); // Convertir ms a microsegundos
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        cuenta++;
+        printf("Cuenta: %d\n",cuenta);
     }
 }
@@ -0,0 +1,122 @@
+#ifndef DISPLAYDMA_H
+#define DISPLAYDMA_H
+
+// Refresco de seis displays de 7 segmentos por el LCD_CAM, sin usar el CPU.
+//
+// El periférico en modo RGB repite un frame por DMA sin parar. Cada muestra de
+// 16 bits son las líneas D0-D12: D0-D6 = segmentos A-G, D7-D12 = transistores
+// de los displays 0-5. En las sincronías y los porches el LCD_CAM saca todo en
+// 0 (display apagado), así que el frame son muchas líneas cortas con
+// sincronías de un ciclo y sin porches: cada línea pierde un ciclo de hsync y
+// cada frame una línea de vsync.
+//
+// Antes de incluir este archivo se incluye Fuente7Seg.h y se definen los
+// tiempos del frame, por ejemplo:
+//
+//   #define DMA_PCLK_HZ          100000
+//   #define DMA_MUESTRAS_LINEA   40     // h_res
+//   #define DMA_LINEAS_DIGITO    5      // Líneas de cada display
+//   #define DMA_MUESTRAS_APAGADO 4      // Todo apagado al cambiar de display, evita el ghosting
+//   #include "DisplayDMA.h"
+//
+// Hay dos frame buffers. displayDMA_publicar() escribe el que no sale, pide el
+// cambio y espera el vsync con el que el driver empieza a sacarlo: hasta
+// entonces el DMA sigue leyendo el otro, que no se puede tocar.
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_lcd_panel_rgb.h"
+#include "esp_lcd_panel_ops.h"
+
+#define DMA_LINEAS           (6 * DMA_LINEAS_DIGITO)   // v_res
+#define DMA_MUESTRAS_DIGITO  (DMA_LINEAS_DIGITO * DMA_MUESTRAS_LINEA)
+#define DMA_MUESTRAS_FRAME   (6 * DMA_MUESTRAS_DIGITO)
+// Ciclos de reloj de un frame con las sincronías
+#define DMA_CICLOS_FRAME     ((DMA_LINEAS + 1) * (DMA_MUESTRAS_LINEA + 1))
+
+typedef struct {
+    esp_lcd_panel_handle_t panel;
+    uint16_t *frames[2];
+    int libre;                      // El frame que no está saliendo
+    SemaphoreHandle_t vsync;        // Uno por frame terminado
+} displayDMA_t;
+
+displayDMA_t displayDMA = {.libre = 1};
+
+// Genera un frame completo a partir del índice en la fuente de cada display
+void displayDMA_generarFrame(uint16_t *frame, const uint8_t indices[6]) {
+    for (int d = 0; d < 6; d++) {
+        uint16_t palabra = seg7_codigo(indices[d]) | (1 << (7 + d));
+        uint16_t *muestras = frame + d * DMA_MUESTRAS_DIGITO;
+        for (int k = 0; k < DMA_MUESTRAS_DIGITO; k++)
+            muestras[k] = (k < DMA_MUESTRAS_APAGADO) ? 0 : palabra;
+    }
+}
+
+// Fin de un frame: el driver arranca el siguiente con el frame buffer pedido
+static bool IRAM_ATTR displayDMA_finFrame(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *datos,
+                                          void *ctx) {
+    BaseType_t despertar = pdFALSE;
+    xSemaphoreGiveFromISR(displayDMA.vsync, &despertar);
+    return despertar == pdTRUE;
+}
+
+// Configura el LCD_CAM con los pines de los segmentos (A-G) y de los transistores
+void displayDMA_iniciar(const gpio_num_t segmentos[7], const gpio_num_t transistores[6]) {
+    esp_lcd_rgb_panel_config_t config = {
+        .clk_src = LCD_CLK_SRC_DEFAULT,
+        .timings = {
+            .pclk_hz = DMA_PCLK_HZ,
+            .h_res = DMA_MUESTRAS_LINEA,
+            .v_res = DMA_LINEAS,
+            .hsync_pulse_width = 1,
+            .hsync_back_porch = 0,
+            .hsync_front_porch = 0,
+            .vsync_pulse_width = 1,
+            .vsync_back_porch = 0,
+            .vsync_front_porch = 0,
+        },
+        .data_width = 16,
+        .num_fbs = 2,
+        .sram_trans_align = 4,
+        .hsync_gpio_num = GPIO_NUM_NC,
+        .vsync_gpio_num = GPIO_NUM_NC,
+        .de_gpio_num = GPIO_NUM_NC,
+        .pclk_gpio_num = GPIO_NUM_NC,
+        .disp_gpio_num = GPIO_NUM_NC,
+    };
+    for (int i = 0; i < 16; i++)
+        config.data_gpio_nums[i] = GPIO_NUM_NC;
+    for (int i = 0; i < 7; i++)
+        config.data_gpio_nums[i] = segmentos[i];
+    for (int i = 0; i < 6; i++)
+        config.data_gpio_nums[7 + i] = transistores[i];
+
+    displayDMA.vsync = xSemaphoreCreateBinary();
+    ESP_ERROR_CHECK(displayDMA.vsync ? ESP_OK : ESP_ERR_NO_MEM);
+    ESP_ERROR_CHECK(esp_lcd_new_rgb_panel(&config, &displayDMA.panel));
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(displayDMA.panel, 2, (void **)&displayDMA.frames[0],
+                                                       (void **)&displayDMA.frames[1]));
+    const esp_lcd_rgb_panel_event_callbacks_t eventos = {.on_vsync = displayDMA_finFrame};
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(displayDMA.panel, &eventos, NULL));
+    ESP_ERROR_CHECK(esp_lcd_panel_reset(displayDMA.panel));
+    ESP_ERROR_CHECK(esp_lcd_panel_init(displayDMA.panel));
+}
+
+// Escribe el frame libre, pide el cambio y espera a que salga. Un vsync que ya
+// estaba dado (o que llega justo después de pedir el cambio) no prueba que el
+// driver ya tomó el frame nuevo, así que se descarta y se espera el siguiente:
+// a lo más un frame de más. Desde una sola tarea
+void displayDMA_publicar(const uint8_t indices[6]) {
+    uint16_t *frame = displayDMA.frames[displayDMA.libre];
+    displayDMA_generarFrame(frame, indices);
+    ESP_ERROR_CHECK(esp_lcd_panel_draw_bitmap(displayDMA.panel, 0, 0, DMA_MUESTRAS_LINEA, DMA_LINEAS, frame));
+    xSemaphoreTake(displayDMA.vsync, 0);
+    xSemaphoreTake(displayDMA.vsync, portMAX_DELAY);
+    displayDMA.libre ^= 1;
+}
+
+#endif
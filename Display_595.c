@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "driver/gptimer.h"
+#include "driver/spi_master.h"
+#include "esp_attr.h"
+
+// Fuente común de 7 segmentos (solo se usan los códigos, los pines son del 595)
+#include "Fuente7Seg.h"
+
+// Display multiplexado de N dígitos con 74HC595 en cascada por SPI.
+// Solo usa 3 pines sin importar cuántos dígitos haya:
+//   MOSI -> SER del primer 595, SCLK -> SRCLK de todos, CS -> RCLK de todos.
+// El CS sube al terminar cada transferencia, ese flanco es el latch del 595.
+//
+// Cadena (el primer 595 es el más cercano al ESP32):
+//   595 #0: Q0-Q6 = segmentos A-G
+//   595 #1: Q0-Q7 = transistores de los dígitos 0-7
+//   595 #2: Q0-Q7 = transistores de los dígitos 8-15, etc.
+#define PIN_MOSI  11
+#define PIN_SCLK  12
+#define PIN_LATCH 10
+
+#define SPI_RELOJ_HZ (10 * 1000 * 1000)
+
+#ifndef NUM_DIGITOS
+#define NUM_DIGITOS     16
+#endif
+#define BYTES_DIGITOS   ((NUM_DIGITOS + 7) / 8)
+#define BYTES_TRAMA     (BYTES_DIGITOS + 1)     // Transistores + segmentos
+
+// El DMA del SPI lee directo del buffer solo si la dirección y el largo son
+// múltiplos de 4; si no, el driver copia cada trama a un buffer intermedio.
+// Cada trama se completa a 4 bytes con ceros al inicio: salen primero, pasan
+// de largo por toda la cadena y se pierden, así que no cambian nada en los 595
+#define BYTES_RELLENO   ((4 - BYTES_TRAMA % 4) % 4)
+#define BYTES_REGISTRO  (BYTES_RELLENO + BYTES_TRAMA)
+
+// Cada dígito se refresca a la misma frecuencia sin importar NUM_DIGITOS,
+// el periodo por dígito se ajusta solo
+#define REFRESCO_DIGITO_HZ 200
+#define PERIODO_DIGITO_US  (1000000 / (REFRESCO_DIGITO_HZ * NUM_DIGITOS))
+
+spi_device_handle_t display595;
+TaskHandle_t tareaRefresco = NULL;
+
+// Tramas de todo el frame (una por dígito) en memoria interna con DMA, alineadas a 4.
+// Dos frames: la tarea de refresco lee el activo y mostrarTexto escribe el otro
+DMA_ATTR uint8_t tramas[2][NUM_DIGITOS * BYTES_REGISTRO];
+volatile uint8_t frameActivo = 0;
+
+// Arma la trama de SPI de cada dígito a partir de su índice en la fuente.
+// Los bytes salen MSB primero: el primero llega al 595 más lejano y el último
+// (segmentos) se queda en el 595 #0. En cada byte, el bit n queda en Qn.
+void construirTramas(uint8_t *frame, const uint8_t indices[NUM_DIGITOS]) {
+    for (int d = 0; d < NUM_DIGITOS; d++) {
+        uint8_t *registro = frame + d * BYTES_REGISTRO;
+        memset(registro, 0, BYTES_REGISTRO);
+        uint8_t *trama = registro + BYTES_RELLENO;
+        int grupo = d / 8;                                  // 595 #1 + grupo
+        trama[BYTES_DIGITOS - 1 - grupo] = 1 << (d % 8);
+        trama[BYTES_DIGITOS] = seg7_codigo(indices[d]);
+    }
+}
+
+// Publica un texto de hasta NUM_DIGITOS caracteres, alineado a la izquierda
+void mostrarTexto(const char *texto) {
+    uint8_t indices[NUM_DIGITOS];
+    size_t largo = strlen(texto);
+    for (int d = 0; d < NUM_DIGITOS; d++) {
+        indices[d] = ((size_t)d < largo) ? seg7_indice(texto[d]) : SEG7_APAGADO;
+    }
+    uint8_t siguiente = frameActivo ^ 1;
+    construirTramas(tramas[siguiente], indices);
+    frameActivo = siguiente;
+}
+
+// ISR del timer: solo despierta a la tarea de refresco, una vez por dígito
+static bool IRAM_ATTR on_timer_digito(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
+    BaseType_t despertar = pdFALSE;
+    vTaskNotifyGiveFromISR(tareaRefresco, &despertar);
+    return despertar == pdTRUE;
+}
+
+// Envía por DMA la trama del siguiente dígito; el CS al subir cambia de dígito en todos los 595 a la vez
+void task_refresco(void *pvParameters) {
+    spi_transaction_t trans = {
+        .length = BYTES_REGISTRO * 8,
+    };
+    spi_transaction_t *resultado;
+    int digito = 0;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        trans.tx_buffer = tramas[frameActivo] + digito * BYTES_REGISTRO;
+        spi_device_queue_trans(display595, &trans, portMAX_DELAY);
+        spi_device_get_trans_result(display595, &resultado, portMAX_DELAY);
+        digito = (digito + 1) % NUM_DIGITOS;
+    }
+}
+
+void configurarSPI() {
+    spi_bus_config_t bus = {
+        .mosi_io_num = PIN_MOSI,
+        .miso_io_num = -1,
+        .sclk_io_num = PIN_SCLK,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = BYTES_REGISTRO,
+    };
+    ESP_ERROR_CHECK(spi_bus_initialize(SPI2_HOST, &bus, SPI_DMA_CH_AUTO));
+
+    spi_device_interface_config_t dispositivo = {
+        .mode = 0,
+        .clock_speed_hz = SPI_RELOJ_HZ,
+        .spics_io_num = PIN_LATCH,
+        .queue_size = 1,
+    };
+    ESP_ERROR_CHECK(spi_bus_add_device(SPI2_HOST, &dispositivo, &display595));
+}
+
+void configurarTimer() {
+    gptimer_handle_t gptimer = NULL;
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,  // 1 MHz para contar en microsegundos
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &gptimer));
+
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = PERIODO_DIGITO_US,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(gptimer, &alarm_config));
+
+    gptimer_event_callbacks_t cbs = {
+        .on_alarm = on_timer_digito,
+    };
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(gptimer, &cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_enable(gptimer));
+    ESP_ERROR_CHECK(gptimer_start(gptimer));
+}
+
+void app_main(void) {
+    configurarSPI();
+    mostrarTexto("");
+
+    xTaskCreatePinnedToCore(task_refresco, "Refresco595", 2048, NULL, configMAX_PRIORITIES - 1, &tareaRefresco, 1);
+    configurarTimer();
+
+    printf("Display de %d dígitos, %d us por dígito\n", NUM_DIGITOS, PERIODO_DIGITO_US);
+
+    unsigned segundos = 0;
+    char texto[NUM_DIGITOS + 1];
+    while (true) {
+        snprintf(texto, sizeof(texto), "SPI-595 %8u", segundos % 100000000u);
+        mostrarTexto(texto);
+        segundos++;
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef EVENTOSGPIO_H
+#define EVENTOSGPIO_H
+
+// Entrada de eventos de GPIO con una sola ISR para todos los pines.
+//
+// En lugar de gpio_install_isr_service + un gpio_isr_handler_add por pin (el
+// driver recorre pin por pin y llama a cada manejador), se registra una sola
+// ISR con gpio_isr_register. Lee el estado de interrupción del CPU de los dos
+// bancos una vez (solo los pines de la cola), marca el instante con el
+// contador de ciclos y guarda un registro (pin, nivel, ciclo) por cada pin en
+// una cola sin bloqueos de un productor (la ISR) y un consumidor (una tarea
+// que la vacía por lotes).
+//
+// El nivel es el que tiene el pin cuando la ISR lo lee, no el flanco que la
+// disparó: con rebotes, una bajada puede quedar registrada con nivel 1. Quien
+// necesita el flanco lo toma de la configuración del pin (solo bajadas, por
+// ejemplo) o lo deduce del nivel anterior del mismo pin.
+//
+//   colaEventosGPIO_t entradas;
+//   eventosGPIO_instalar(&entradas, (1ULL << BOTON4) | (1ULL << BOTON5), aviso);
+//
+// Los pines se configuran igual que antes (gpio_set_intr_type), pero no se
+// instala el servicio de ISR: las dos formas no se pueden mezclar.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "driver/gpio.h"
+#include "soc/gpio_struct.h"
+#include "esp_cpu.h"
+#include "esp_attr.h"
+#include "PerfilISR.h"
+
+#ifndef EVENTOS_GPIO_TAM
+#define EVENTOS_GPIO_TAM 256   // Potencia de 2
+#endif
+
+#define EVENTO_GPIO_BAJO 0
+#define EVENTO_GPIO_ALTO 1
+
+typedef struct {
+    uint32_t ciclo;    // esp_cpu_get_cycle_count() al entrar a la ISR
+    uint8_t pin;
+    uint8_t nivel;     // Nivel del pin al leerlo en la ISR (no el flanco, ver arriba)
+} eventoGPIO_t;
+
+// Se llama desde la ISR después de guardar los eventos (para despertar al
+// consumidor). Regresa true si hay que ceder el CPU al salir de la ISR
+typedef bool (*avisoEventosGPIO_t)(void);
+
+typedef struct {
+    eventoGPIO_t eventos[EVENTOS_GPIO_TAM];
+    volatile uint32_t escritura;   // Solo la cambia la ISR
+    volatile uint32_t lectura;     // Solo la cambia el consumidor
+    volatile uint32_t perdidos;    // Eventos descartados con la cola llena
+    uint32_t mascara0, mascara1;   // Pines atendidos en el banco 0 (GPIO 0-31) y 1 (32-48)
+    avisoEventosGPIO_t aviso;
+    perfilISR_t perfil;            // Duración de la ISR (no es periódica: sin jitter)
+} colaEventosGPIO_t;
+
+static inline void IRAM_ATTR eventosGPIO_guardar(colaEventosGPIO_t *cola, uint32_t *escritura, uint32_t lectura,
+                                                 uint32_t estado, uint32_t nivel, uint8_t base, uint32_t ciclo) {
+    while (estado) {
+        int bit = __builtin_ctz(estado);
+        estado &= estado - 1;
+        if (*escritura - lectura >= EVENTOS_GPIO_TAM) {
+            cola->perdidos++;
+            continue;
+        }
+        eventoGPIO_t *evento = &cola->eventos[*escritura & (EVENTOS_GPIO_TAM - 1)];
+        evento->ciclo = ciclo;
+        evento->pin = base + bit;
+        evento->nivel = (nivel >> bit) & 1;
+        (*escritura)++;
+    }
+}
+
+static void IRAM_ATTR eventosGPIO_isr(void *arg) {
+    colaEventosGPIO_t *cola = arg;
+    uint32_t ciclo = esp_cpu_get_cycle_count();
+    PERFIL_ISR_ENTRADA(&cola->perfil);
+
+    // GPIO.pcpu_int ya deja fuera los pines con la interrupción apagada. Solo se
+    // toman y se limpian los atendidos: el resto del estado es de quien lo
+    // atiende (otra ISR en la línea compartida, o el pin se activa después)
+    uint32_t estado0 = GPIO.pcpu_int & cola->mascara0;
+    uint32_t estado1 = GPIO.pcpu_int1.val & cola->mascara1;
+    GPIO.status_w1tc = estado0;
+    GPIO.status1_w1tc.val = estado1;
+    uint32_t nivel0 = GPIO.in;
+    uint32_t nivel1 = GPIO.in1.val;
+
+    uint32_t escritura = cola->escritura;
+    uint32_t lectura = __atomic_load_n(&cola->lectura, __ATOMIC_ACQUIRE);
+    eventosGPIO_guardar(cola, &escritura, lectura, estado0 & cola->mascara0, nivel0, 0, ciclo);
+    eventosGPIO_guardar(cola, &escritura, lectura, estado1 & cola->mascara1, nivel1, 32, ciclo);
+    __atomic_store_n(&cola->escritura, escritura, __ATOMIC_RELEASE);
+
+    bool ceder = cola->aviso && cola->aviso();
+    PERFIL_ISR_SALIDA(&cola->perfil);
+    if (ceder) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// Saca hasta "maximo" eventos de una vez; la posición se publica una sola vez por lote
+static inline int eventosGPIO_sacar(colaEventosGPIO_t *cola, eventoGPIO_t *destino, int maximo) {
+    uint32_t lectura = cola->lectura;
+    uint32_t disponibles = __atomic_load_n(&cola->escritura, __ATOMIC_ACQUIRE) - lectura;
+    int n = (disponibles < (uint32_t)maximo) ? (int)disponibles : maximo;
+    for (int i = 0; i < n; i++) {
+        destino[i] = cola->eventos[(lectura + i) & (EVENTOS_GPIO_TAM - 1)];
+    }
+    __atomic_store_n(&cola->lectura, lectura + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+// Registra la ISR única para los pines de la máscara (bit n = GPIO n).
+// Sin ESP_INTR_FLAG_IRAM: el aviso puede usar funciones del driver que están en flash
+static inline esp_err_t eventosGPIO_instalar(colaEventosGPIO_t *cola, uint64_t pines, avisoEventosGPIO_t aviso) {
+    cola->escritura = 0;
+    cola->lectura = 0;
+    cola->perdidos = 0;
+    cola->mascara0 = (uint32_t)pines;
+    cola->mascara1 = (uint32_t)(pines >> 32);
+    cola->aviso = aviso;
+    cola->perfil = (perfilISR_t)PERFIL_ISR_INICIAL("GPIO", 0);
+    return gpio_isr_register(eventosGPIO_isr, cola, 0, NULL);
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef FUENTE7SEG_H
+#define FUENTE7SEG_H
+
+// Fuente única para los displays de 7 segmentos de todas las prácticas.
+//
+// Antes de incluir este archivo se define el mapa de pines de la placa,
+// en orden de segmento A a G, por ejemplo:
+//
+//   #define SEG7_PINES segmento_A, segmento_B, segmento_C, segmento_D, segmento_E, segmento_F, segmento_G
+//   #include "Fuente7Seg.h"
+//
+// Con ese mapa el compilador genera seg7Fuente[], una tabla const (en flash)
+// con las máscaras W1TS/W1TC de cada carácter. En tiempo de ejecución basta
+// una consulta por carácter, no hay que copiar ni calcular nada.
+
+#include <stdint.h>
+
+// X(nombre, caracter, codigo)
+// codigo: bit 0 = A, bit 1 = B, ... bit 6 = G
+// El orden importa: 0-9 y luego A-J van seguidos, así SEG7_0 + n sirve para
+// cualquier dígito hexadecimal y para los índices 0-19 de las prácticas 2 y 3.
+#define SEG7_FUENTE(X)               \
+    X(APAGADO,    ' ',    0x00)      \
+    X(0,          '0',    0x3F)      \
+    X(1,          '1',    0x06)      \
+    X(2,          '2',    0x5B)      \
+    X(3,          '3',    0x4F)      \
+    X(4,          '4',    0x66)      \
+    X(5,          '5',    0x6D)      \
+    X(6,          '6',    0x7D)      \
+    X(7,          '7',    0x07)      \
+    X(8,          '8',    0x7F)      \
+    X(9,          '9',    0x6F)      \
+    X(A,          'A',    0x77)      \
+    X(B,          'B',    0x7C)      \
+    X(C,          'C',    0x39)      \
+    X(D,          'D',    0x5E)      \
+    X(E,          'E',    0x79)      \
+    X(F,          'F',    0x71)      \
+    X(G,          'G',    0x3D)      \
+    X(H,          'H',    0x76)      \
+    X(I,          'I',    0x06)      \
+    X(J,          'J',    0x1E)      \
+    X(L,          'L',    0x38)      \
+    X(N,          'N',    0x54)      \
+    X(O,          'O',    0x5C)      \
+    X(P,          'P',    0x73)      \
+    X(Q,          'Q',    0x67)      \
+    X(R,          'R',    0x50)      \
+    X(S,          'S',    0x6D)      \
+    X(T,          'T',    0x78)      \
+    X(U,          'U',    0x3E)      \
+    X(Y,          'Y',    0x6E)      \
+    X(GUION,      '-',    0x40)      \
+    X(GUION_BAJO, '_',    0x08)      \
+    X(IGUAL,      '=',    0x48)      \
+    X(GRADOS,     '\xB0', 0x63)
+
+// Índice de cada carácter: SEG7_0, SEG7_A, SEG7_GUION, ...
+#define SEG7_INDICE(nombre, caracter, codigo) SEG7_##nombre,
+enum {
+    SEG7_FUENTE(SEG7_INDICE)
+    SEG7_TOTAL
+};
+
+// Máscaras de un carácter para los dos bancos de GPIO del ESP32-S3
+// Banco 0 = GPIO 0-31 (GPIO.out_*), banco 1 = GPIO 32-48 (GPIO.out1_*)
+typedef struct {
+    uint32_t set0, clr0;
+    uint32_t set1, clr1;
+} seg7Mascara_t;
+
+// Bit de un pin dentro de su banco (0 si el pin es del otro banco)
+#define SEG7_BIT0(pin) (((pin) < 32) ? (1UL << ((pin) & 31)) : 0UL)
+#define SEG7_BIT1(pin) (((pin) >= 32) ? (1UL << ((pin) & 31)) : 0UL)
+
+#define SEG7_ENCENDIDO(codigo, n, pin, BIT) ((((codigo) >> (n)) & 1) ? BIT(pin) : 0UL)
+#define SEG7_APAGADO_(codigo, n, pin, BIT)  ((((codigo) >> (n)) & 1) ? 0UL : BIT(pin))
+
+#define SEG7_BANCO(M, codigo, BIT, pA, pB, pC, pD, pE, pF, pG)                  \
+    (M(codigo, 0, pA, BIT) | M(codigo, 1, pB, BIT) | M(codigo, 2, pC, BIT) |    \
+     M(codigo, 3, pD, BIT) | M(codigo, 4, pE, BIT) | M(codigo, 5, pF, BIT) |    \
+     M(codigo, 6, pG, BIT))
+
+#define SEG7_MASCARA(codigo, ...) {                                             \
+    .set0 = SEG7_BANCO(SEG7_ENCENDIDO, codigo, SEG7_BIT0, __VA_ARGS__),         \
+    .clr0 = SEG7_BANCO(SEG7_APAGADO_,  codigo, SEG7_BIT0, __VA_ARGS__),         \
+    .set1 = SEG7_BANCO(SEG7_ENCENDIDO, codigo, SEG7_BIT1, __VA_ARGS__),         \
+    .clr1 = SEG7_BANCO(SEG7_APAGADO_,  codigo, SEG7_BIT1, __VA_ARGS__),         \
+}
+
+// Expande SEG7_PINES a siete argumentos antes de llamar a la macro
+#define SEG7_EXPANDIR(M, ...) M(__VA_ARGS__)
+
+#ifdef SEG7_PINES
+
+// Todos los segmentos de la placa, para apagar el display en una sola escritura
+#define SEG7_SEGMENTOS0 SEG7_EXPANDIR(SEG7_BANCO, SEG7_APAGADO_, 0x00, SEG7_BIT0, SEG7_PINES)
+#define SEG7_SEGMENTOS1 SEG7_EXPANDIR(SEG7_BANCO, SEG7_APAGADO_, 0x00, SEG7_BIT1, SEG7_PINES)
+
+#define SEG7_ENTRADA(nombre, caracter, codigo) \
+    [SEG7_##nombre] = SEG7_EXPANDIR(SEG7_MASCARA, codigo, SEG7_PINES),
+
+static const seg7Mascara_t seg7Fuente[SEG7_TOTAL] = {
+    SEG7_FUENTE(SEG7_ENTRADA)
+};
+
+#endif
+
+// Código de segmentos de cada carácter (bit 0 = A), sin depender de los pines
+#define SEG7_CODIGO(nombre, caracter, codigo) [SEG7_##nombre] = (codigo),
+
+static inline uint8_t seg7_codigo(int indice) {
+    static const uint8_t codigos[SEG7_TOTAL] = { SEG7_FUENTE(SEG7_CODIGO) };
+    return codigos[indice];
+}
+
+// Índice de un carácter ASCII (mayúscula o minúscula); los que no existen se apagan
+#define SEG7_ASCII(nombre, caracter, codigo) [(uint8_t)(caracter)] = SEG7_##nombre,
+
+static inline uint8_t seg7_indice(char caracter) {
+    static const uint8_t indices[256] = { SEG7_FUENTE(SEG7_ASCII) };
+    if (caracter >= 'a' && caracter <= 'z') caracter -= 'a' - 'A';
+    return indices[(uint8_t)caracter];
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef GENERADORSENAL_H
+#define GENERADORSENAL_H
+
+// Generador de señal cuadrada con el LEDC: tiempo en alto y en bajo en us.
+//
+// El periférico genera la forma de onda solo, sin CPU: en lugar de un ciclo con
+// usleep() que ocupa un núcleo (y deja sin tiempo a la tarea idle y al
+// watchdog), se programa una vez el periodo y el ciclo de trabajo. Los flancos
+// salen del reloj del LEDC, sin el jitter del planificador ni la deriva que
+// acumula cada usleep() por el tiempo de gpio_set_level() y del ciclo.
+//
+// La frecuencia del timer es un número entero de Hz: el periodo se redondea a
+// la frecuencia más cercana y el tiempo en alto se cuenta en 1/2^14 del periodo
+// (unos 0.5 us a 120 Hz). Con 14 bits el divisor del reloj de 80 MHz alcanza
+// periodos de unos 200 us hasta 200 ms.
+//
+//   generadorSenal_iniciar(12, 833, 7500);     // 833 us en alto, 7500 us en bajo
+//   generadorSenal_cambiar(1000, 4000);        // Sin pulsos cortados
+
+#include <stdint.h>
+#include "driver/ledc.h"
+
+#define GENERADOR_MODO       LEDC_LOW_SPEED_MODE
+#define GENERADOR_TIMER      LEDC_TIMER_0
+#define GENERADOR_CANAL      LEDC_CHANNEL_0
+#define GENERADOR_BITS       14
+#define GENERADOR_RESOLUCION LEDC_TIMER_14_BIT
+
+// Frecuencia en Hz más cercana al periodo
+static inline uint32_t generadorSenal_frecuencia(uint32_t alto_us, uint32_t bajo_us) {
+    uint32_t periodo_us = alto_us + bajo_us;
+    return (1000000 + periodo_us / 2) / periodo_us;
+}
+
+// Cuentas en alto de 2^14 para la frecuencia real del timer
+static inline uint32_t generadorSenal_cuentas(uint32_t alto_us, uint32_t frecuencia) {
+    uint32_t cuentas = (uint32_t)((((uint64_t)alto_us * frecuencia << GENERADOR_BITS) + 500000) / 1000000);
+    uint32_t maximo = 1UL << GENERADOR_BITS;
+    return cuentas > maximo ? maximo : cuentas;
+}
+
+static inline esp_err_t generadorSenal_iniciar(int pin, uint32_t alto_us, uint32_t bajo_us) {
+    uint32_t frecuencia = generadorSenal_frecuencia(alto_us, bajo_us);
+    ledc_timer_config_t timer = {
+        .speed_mode = GENERADOR_MODO,
+        .duty_resolution = GENERADOR_RESOLUCION,
+        .timer_num = GENERADOR_TIMER,
+        .freq_hz = frecuencia,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    esp_err_t err = ledc_timer_config(&timer);
+    if (err != ESP_OK) return err;
+
+    ledc_channel_config_t canal = {
+        .gpio_num = pin,
+        .speed_mode = GENERADOR_MODO,
+        .channel = GENERADOR_CANAL,
+        .intr_type = LEDC_INTR_DISABLE,
+        .timer_sel = GENERADOR_TIMER,
+        .duty = generadorSenal_cuentas(alto_us, frecuencia),
+        .hpoint = 0,   // El pulso empieza con cada periodo
+    };
+    return ledc_channel_config(&canal);
+}
+
+// Cambia la forma de onda mientras corre. El LEDC carga el divisor y el ciclo
+// de trabajo nuevos en el siguiente desborde del timer, así que el periodo en
+// curso termina completo y no sale ningún pulso cortado. Si las dos escrituras
+// quedan en periodos distintos, un periodo sale con la frecuencia nueva y la
+// proporción anterior, que sigue siendo un pulso completo
+static inline esp_err_t generadorSenal_cambiar(uint32_t alto_us, uint32_t bajo_us) {
+    uint32_t frecuencia = generadorSenal_frecuencia(alto_us, bajo_us);
+    if (frecuencia != ledc_get_freq(GENERADOR_MODO, GENERADOR_TIMER)) {
+        esp_err_t err = ledc_set_freq(GENERADOR_MODO, GENERADOR_TIMER, frecuencia);
+        if (err != ESP_OK) return err;
+    }
+    esp_err_t err = ledc_set_duty(GENERADOR_MODO, GENERADOR_CANAL, generadorSenal_cuentas(alto_us, frecuencia));
+    if (err != ESP_OK) return err;
+    return ledc_update_duty(GENERADOR_MODO, GENERADOR_CANAL);
+}
+
+#endif
@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <math.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "PwmSoftware.h"
+
+// Tira de LEDs con brillo regulable, más canales de los que tiene el LEDC.
+// Todos salen del mismo gptimer con el PWM por software de PwmSoftware.h
+#define NUM_LEDS 16
+#define PASO_ONDA_MS 20     // Actualización de la animación
+
+const int pinesLeds[NUM_LEDS] = {1, 2, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
+
+// Corrección de brillo: el ojo percibe el ciclo de trabajo en escala casi cuadrática
+uint8_t brilloPercibido(float nivel) {
+    return (uint8_t)(nivel * nivel * PWM_MAXIMO + 0.5f);
+}
+
+void app_main(void) {
+    ESP_ERROR_CHECK(pwmSoft_iniciar(pinesLeds, NUM_LEDS));
+
+    // Onda que recorre la tira: cada LED respira con un desfase respecto al anterior
+    float fase = 0;
+    TickType_t ultimo = xTaskGetTickCount();
+    uint32_t pasos = 0;
+    while (true) {
+        for (int k = 0; k < NUM_LEDS; k++) {
+            float nivel = 0.5f + 0.5f * sinf(fase + k * (2 * (float)M_PI / NUM_LEDS));
+            pwmSoft_ciclo(k, brilloPercibido(nivel));
+        }
+        pwmSoft_publicar();
+        fase += 2 * (float)M_PI * PASO_ONDA_MS / 2000.0f;   // Una vuelta cada 2 s
+        if (fase > 2 * (float)M_PI) fase -= 2 * (float)M_PI;
+
+        if (++pasos % (10000 / PASO_ONDA_MS) == 0) {
+            printf("Periodos: %lu, horarios aplicados: %lu\n",
+                   (unsigned long)pwmSoft.periodos, (unsigned long)pwmSoft.cambios);
+        }
+        vTaskDelayUntil(&ultimo, pdMS_TO_TICKS(PASO_ONDA_MS));
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef MAPEOSERVO_H
+#define MAPEOSERVO_H
+
+// Mapeo de ángulo a pulso en punto fijo con calibración por servo.
+//
+// El ángulo entra en décimas de grado (0-1800) y el pulso sale en ticks del
+// timer del MCPWM a 3.2 MHz (0.3125 us, unas 0.03 grados por tick), no en us.
+// Cada servo tiene una tabla de 19 puntos (0, 10, ... 180 grados) y entre
+// puntos se interpola en línea recta; así se corrige la respuesta no lineal
+// de cada servo. Las tablas las calcula el compilador a partir de los us
+// medidos en cada punto, antes de incluir este archivo:
+//
+//   #define MAPEO_CALIBRACIONES { MAPEO_LINEAL(500, 2500), MAPEO_TABLA(540, 640, ..., 2460) }
+//   #include "MapeoServo.h"
+//
+// Los ticks van tal cual al comparador del MCPWM, sin pasar por un % en
+// float. host/medicion_mapeo.c mide mapeo_ticks() contra grados_a_us().
+
+#include <stdint.h>
+
+#define MAPEO_RESOLUCION_GRUPO_HZ 16000000
+#define MAPEO_RESOLUCION_HZ   3200000                      // Ticks por segundo del timer
+#define MAPEO_TICKS_PERIODO   (MAPEO_RESOLUCION_HZ / 50)   // 64000, cabe en el periodo de 16 bits
+#define MAPEO_PUNTOS 19
+#define MAPEO_PASO   100                                   // Décimas de grado entre puntos
+#define MAPEO_MAXIMO ((MAPEO_PUNTOS - 1) * MAPEO_PASO)     // 1800 = 180 grados
+
+// us a ticks redondeado (3.2 ticks por us)
+#define MAPEO_US_A_TICKS(us) ((uint16_t)(((us) * 16 + 2) / 5))
+
+// Tabla medida: el pulso en us en 0, 10, ... 180 grados
+#define MAPEO_T(us) MAPEO_US_A_TICKS(us)
+#define MAPEO_TABLA(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16, a17, a18) { \
+    MAPEO_T(a0), MAPEO_T(a1), MAPEO_T(a2), MAPEO_T(a3), MAPEO_T(a4), MAPEO_T(a5), MAPEO_T(a6),         \
+    MAPEO_T(a7), MAPEO_T(a8), MAPEO_T(a9), MAPEO_T(a10), MAPEO_T(a11), MAPEO_T(a12), MAPEO_T(a13),     \
+    MAPEO_T(a14), MAPEO_T(a15), MAPEO_T(a16), MAPEO_T(a17), MAPEO_T(a18) }
+
+// Servo ideal: recta entre los pulsos de 0 y 180 grados
+#define MAPEO_L(us0, us180, i) \
+    ((uint16_t)((MAPEO_US_A_TICKS(us0) * (18 - (i)) + MAPEO_US_A_TICKS(us180) * (i) + 9) / 18))
+#define MAPEO_LINEAL(us0, us180) {                                                                        \
+    MAPEO_L(us0, us180, 0), MAPEO_L(us0, us180, 1), MAPEO_L(us0, us180, 2), MAPEO_L(us0, us180, 3),       \
+    MAPEO_L(us0, us180, 4), MAPEO_L(us0, us180, 5), MAPEO_L(us0, us180, 6), MAPEO_L(us0, us180, 7),       \
+    MAPEO_L(us0, us180, 8), MAPEO_L(us0, us180, 9), MAPEO_L(us0, us180, 10), MAPEO_L(us0, us180, 11),     \
+    MAPEO_L(us0, us180, 12), MAPEO_L(us0, us180, 13), MAPEO_L(us0, us180, 14), MAPEO_L(us0, us180, 15),   \
+    MAPEO_L(us0, us180, 16), MAPEO_L(us0, us180, 17), MAPEO_L(us0, us180, 18) }
+
+#ifdef MAPEO_CALIBRACIONES
+
+// Forma medida de cada servo (flash) y la tabla en uso, que la calibración reescala
+static const uint16_t mapeoFabrica[][MAPEO_PUNTOS] = MAPEO_CALIBRACIONES;
+static uint16_t mapeoTablas[][MAPEO_PUNTOS] = MAPEO_CALIBRACIONES;
+#define MAPEO_SERVOS ((int)(sizeof(mapeoTablas) / sizeof(mapeoTablas[0])))
+
+// Ticks del pulso para un ángulo en décimas de grado
+static inline uint32_t mapeo_ticks(int servo, int decigrados) {
+    if (decigrados < 0) decigrados = 0;
+    if (decigrados > MAPEO_MAXIMO) decigrados = MAPEO_MAXIMO;
+    const uint16_t *tabla = mapeoTablas[servo];
+    int segmento = decigrados / MAPEO_PASO;
+    if (segmento == MAPEO_PUNTOS - 1) return tabla[segmento];
+    int fraccion = decigrados - segmento * MAPEO_PASO;
+    int32_t pendiente = (int32_t)tabla[segmento + 1] - tabla[segmento];
+    return tabla[segmento] + (pendiente * fraccion + MAPEO_PASO / 2) / MAPEO_PASO;
+}
+
+// Calibración de extremos: los pulsos medidos en 0 y 180 grados estiran la forma
+// de fábrica del servo, los puntos intermedios conservan su proporción
+static inline void mapeo_calibrarExtremos(int servo, uint16_t ticks0, uint16_t ticks180) {
+    const uint16_t *forma = mapeoFabrica[servo];
+    int32_t rangoForma = (int32_t)forma[MAPEO_PUNTOS - 1] - forma[0];
+    int32_t rango = (int32_t)ticks180 - ticks0;
+    for (int i = 0; i < MAPEO_PUNTOS; i++) {
+        int32_t relativo = (int32_t)forma[i] - forma[0];
+        mapeoTablas[servo][i] = ticks0 + (rangoForma ? (relativo * rango + rangoForma / 2) / rangoForma : 0);
+    }
+}
+
+#endif
+
+// Ticks a us, para mostrar
+#define MAPEO_TICKS_A_US(ticks) ((ticks) * 5 / 16)
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef PATRONRMT_H
+#define PATRONRMT_H
+
+// Generador de patrones con el RMT: trenes de pulsos (nivel, duración) o
+// cadenas de bits codificadas (WS2812, códigos IR, estímulos de prueba).
+//
+// El patrón se convierte una vez a símbolos del RMT y el periférico los saca
+// solo, con la precisión de su reloj (0.1 us a 10 MHz) y sin CPU por flanco.
+// Con DMA el patrón puede ser de cualquier largo; sin DMA cabe en la memoria
+// del canal pero se puede repetir por hardware (el driver no repite con DMA).
+//
+//   static rmt_symbol_word_t simbolos[8];
+//   const pulsoRMT_t pulsos[] = {{1, PATRON_US(833)}, {0, PATRON_US(7500)}};
+//   int n = patronRMT_codificarPulsos(pulsos, 2, simbolos, 8);
+//   patronRMT_iniciar(&patron, 12, false);
+//   patronRMT_enviar(&patron, simbolos, n, -1);    // -1 = para siempre
+//
+// Los codificadores son funciones puras sobre arreglos, sin hardware. Los
+// símbolos se leen mientras se transmiten: el arreglo debe seguir vivo hasta
+// que termine el envío.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driver/rmt_tx.h"
+
+#ifndef PATRON_RESOLUCION_HZ
+#define PATRON_RESOLUCION_HZ 10000000                 // 0.1 us por tick
+#endif
+#define PATRON_US(us) ((uint32_t)(us) * (PATRON_RESOLUCION_HZ / 1000000))
+#define PATRON_MITAD_MAX 32767                        // Duración máxima de medio símbolo (15 bits)
+#define PATRON_BLOQUE_SIMBOLOS 96                     // Sin DMA: dos bloques de 48 símbolos
+#define PATRON_BLOQUE_DMA 1024                        // Con DMA: tamaño de cada transferencia
+
+typedef struct {
+    uint8_t nivel;
+    uint32_t duracion;   // Ticks de PATRON_RESOLUCION_HZ
+} pulsoRMT_t;
+
+// Escritura de medios símbolos: cada símbolo del RMT lleva dos (nivel, duración)
+typedef struct {
+    rmt_symbol_word_t *simbolos;
+    int maximo;
+    int n;          // Símbolos completos
+    bool mitad;     // El símbolo n ya tiene su primera mitad
+} escritorRMT_t;
+
+static inline bool patronRMT_mitad(escritorRMT_t *e, uint8_t nivel, uint16_t duracion) {
+    if (!e->mitad) {
+        if (e->n >= e->maximo) return false;
+        e->simbolos[e->n].level0 = nivel;
+        e->simbolos[e->n].duration0 = duracion;
+        e->mitad = true;
+    } else {
+        e->simbolos[e->n].level1 = nivel;
+        e->simbolos[e->n].duration1 = duracion;
+        e->n++;
+        e->mitad = false;
+    }
+    return true;
+}
+
+// Tabla de pulsos a símbolos. Un pulso más largo que medio símbolo se parte en
+// varias mitades del mismo nivel, y los pulsos de duración 0 se omiten (para el
+// RMT una duración 0 marca el fin). Si queda media mitad sola, el último pulso
+// cede un tick para completar el símbolo. Regresa los símbolos escritos o -1 si
+// no caben en "maximo"
+static inline int patronRMT_codificarPulsos(const pulsoRMT_t *pulsos, int n, rmt_symbol_word_t *simbolos, int maximo) {
+    escritorRMT_t e = {.simbolos = simbolos, .maximo = maximo};
+    for (int i = 0; i < n; i++) {
+        uint32_t resto = pulsos[i].duracion;
+        while (resto > 0) {
+            uint16_t mitad = resto > PATRON_MITAD_MAX ? PATRON_MITAD_MAX : resto;
+            if (!patronRMT_mitad(&e, pulsos[i].nivel & 1, mitad)) return -1;
+            resto -= mitad;
+        }
+    }
+    if (e.mitad) {
+        rmt_symbol_word_t *s = &simbolos[e.n];
+        if (s->duration0 > 1) s->duration0--;   // Un pulso de 1 tick crece a 2
+        s->level1 = s->level0;
+        s->duration1 = 1;
+        e.n++;
+    }
+    return e.n;
+}
+
+// Cadena de bits a símbolos, el bit más significativo de cada byte primero.
+// Cada bit es un símbolo completo (p. ej. WS2812: 0 = 0.4 us alto + 0.85 us bajo)
+static inline int patronRMT_codificarBits(const uint8_t *datos, int bits, rmt_symbol_word_t bit0, rmt_symbol_word_t bit1,
+                                          rmt_symbol_word_t *simbolos, int maximo) {
+    if (bits > maximo) return -1;
+    for (int i = 0; i < bits; i++) {
+        simbolos[i] = ((datos[i >> 3] >> (7 - (i & 7))) & 1) ? bit1 : bit0;
+    }
+    return bits;
+}
+
+// Símbolo de un bit: alto y luego bajo, en ticks
+static inline rmt_symbol_word_t patronRMT_simbolo(uint16_t alto, uint16_t bajo) {
+    rmt_symbol_word_t s = {.level0 = 1, .duration0 = alto, .level1 = 0, .duration1 = bajo};
+    return s;
+}
+
+typedef struct {
+    rmt_channel_handle_t canal;
+    rmt_encoder_handle_t copia;   // Los símbolos ya vienen codificados: solo se copian
+} patronRMT_t;
+
+// Canal de salida en el pin. Con DMA se envían patrones largos; sin DMA se
+// pueden repetir en ciclo sin CPU
+static inline esp_err_t patronRMT_iniciar(patronRMT_t *p, int pin, bool dma) {
+    rmt_tx_channel_config_t config = {
+        .gpio_num = pin,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = PATRON_RESOLUCION_HZ,
+        .mem_block_symbols = dma ? PATRON_BLOQUE_DMA : PATRON_BLOQUE_SIMBOLOS,
+        .trans_queue_depth = 4,
+        .flags.with_dma = dma,
+    };
+    esp_err_t err = rmt_new_tx_channel(&config, &p->canal);
+    if (err != ESP_OK) return err;
+    rmt_copy_encoder_config_t copia = {0};
+    err = rmt_new_copy_encoder(&copia, &p->copia);
+    if (err == ESP_OK) {
+        err = rmt_enable(p->canal);
+        if (err == ESP_OK) return ESP_OK;
+        rmt_del_encoder(p->copia);
+    }
+    // Si algo falló se borra lo que ya se creó: el canal del RMT queda libre para otro intento
+    rmt_del_channel(p->canal);
+    p->canal = NULL;
+    p->copia = NULL;
+    return err;
+}
+
+// Pone el patrón en la cola del canal y regresa sin esperar. vueltas: 0 = una
+// vez, n = se repite n veces más, -1 = para siempre (solo sin DMA y si el
+// patrón cabe en la memoria del canal)
+static inline esp_err_t patronRMT_enviar(patronRMT_t *p, const rmt_symbol_word_t *simbolos, int n, int vueltas) {
+    rmt_transmit_config_t envio = {
+        .loop_count = vueltas,
+        .flags.eot_level = 0,   // La salida queda en bajo al terminar
+    };
+    return rmt_transmit(p->canal, p->copia, simbolos, n * sizeof(rmt_symbol_word_t), &envio);
+}
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef PERFILISR_H
+#define PERFILISR_H
+
+// Perfil de ISR: retraso (jitter) y duración de cada interrupción en ciclos de CPU.
+//
+// Cada ISR tiene su perfilISR_t y marca la entrada y la salida con el contador
+// de ciclos. Con eso se llenan dos histogramas en potencias de 2: la desviación
+// del periodo respecto al esperado (qué tan tarde o temprano entró) y el tiempo
+// que tardó en salir. Medir cuesta dos lecturas del contador y unas cuantas
+// sumas, así que puede quedar activo siempre (PERFIL_ISR 0 lo quita del todo).
+//
+//   perfilISR_t perfilDisplay = PERFIL_ISR_INICIAL("display", 2000);   // Periodo en us, 0 = sin periodo
+//   static bool IRAM_ATTR on_timer_alarm(...) {
+//       PERFIL_ISR_ENTRADA(&perfilDisplay);
+//       ...
+//       PERFIL_ISR_SALIDA(&perfilDisplay);
+//   }
+//   perfilISR_imprimir(&perfilDisplay);
+//
+// Solo la ISR escribe su perfil (un escritor, en su núcleo), sin candados: quien
+// lee copia los contadores con perfilISR_consultar() y puede ver una muestra a
+// medias, nunca un valor corrupto. Los ciclos son del núcleo donde corre la ISR.
+
+#include <stdint.h>
+#include <stdio.h>
+#include "sdkconfig.h"
+#include "esp_cpu.h"
+#include "esp_attr.h"
+
+#ifndef PERFIL_ISR
+#define PERFIL_ISR 1
+#endif
+
+#ifdef CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#define PERFIL_CICLOS_US CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#else
+#define PERFIL_CICLOS_US 240
+#endif
+
+#define PERFIL_CUBETAS 16
+#define PERFIL_BASE 6    // Cubeta 0: < 64 ciclos; cubeta i: < 64 << i; la última: el resto
+
+typedef struct {
+    const char *nombre;
+    uint32_t periodoEsperado;          // Ciclos, 0 = sin periodo (p. ej. GPIO)
+    uint32_t entrada;                  // Ciclo de la última entrada, 0 = sin referencia
+    uint32_t inicio;                   // Ciclo de entrada de la interrupción en curso
+    volatile uint32_t muestras;
+    volatile int32_t desviacionMin, desviacionMax;   // Periodo medido - esperado, con signo
+    volatile uint32_t duracionMax;
+    volatile uint32_t jitter[PERFIL_CUBETAS];        // |desviación|
+    volatile uint32_t duracion[PERFIL_CUBETAS];
+} perfilISR_t;
+
+#define PERFIL_ISR_INICIAL(nombre_, periodo_us) \
+    {.nombre = (nombre_), .periodoEsperado = (periodo_us) * PERFIL_CICLOS_US, \
+     .desviacionMin = INT32_MAX, .desviacionMax = INT32_MIN}
+
+static inline int IRAM_ATTR perfilISR_cubeta(uint32_t ciclos) {
+    ciclos >>= PERFIL_BASE;
+    if (ciclos == 0) return 0;
+    int cubeta = 32 - __builtin_clz(ciclos);
+    return cubeta < PERFIL_CUBETAS ? cubeta : PERFIL_CUBETAS - 1;
+}
+
+static inline void IRAM_ATTR perfilISR_entrada(perfilISR_t *p) {
+    uint32_t ahora = esp_cpu_get_cycle_count();
+    if (p->periodoEsperado && p->entrada) {
+        int32_t desviacion = (int32_t)(ahora - p->entrada - p->periodoEsperado);
+        if (desviacion < p->desviacionMin) p->desviacionMin = desviacion;
+        if (desviacion > p->desviacionMax) p->desviacionMax = desviacion;
+        p->jitter[perfilISR_cubeta(desviacion < 0 ? -desviacion : desviacion)]++;
+    }
+    p->entrada = ahora ? ahora : 1;
+    p->inicio = ahora;
+}
+
+static inline void IRAM_ATTR perfilISR_salida(perfilISR_t *p) {
+    uint32_t duracion = esp_cpu_get_cycle_count() - p->inicio;
+    if (duracion > p->duracionMax) p->duracionMax = duracion;
+    p->duracion[perfilISR_cubeta(duracion)]++;
+    p->muestras++;
+}
+
+// La fuente se detuvo a propósito (p. ej. el escaneo en reposo): la siguiente
+// entrada no cuenta como periodo
+static inline void IRAM_ATTR perfilISR_pausa(perfilISR_t *p) {
+    p->entrada = 0;
+}
+
+#if PERFIL_ISR
+#define PERFIL_ISR_ENTRADA(p) perfilISR_entrada(p)
+#define PERFIL_ISR_SALIDA(p) perfilISR_salida(p)
+#define PERFIL_ISR_PAUSA(p) perfilISR_pausa(p)
+#else
+#define PERFIL_ISR_ENTRADA(p) ((void)0)
+#define PERFIL_ISR_SALIDA(p) ((void)0)
+#define PERFIL_ISR_PAUSA(p) ((void)0)
+#endif
+
+// Copia de los contadores para consultarlos sin que la ISR los cambie a medio uso
+static inline void perfilISR_consultar(const perfilISR_t *p, perfilISR_t *copia) {
+    *copia = *p;
+}
+
+// Límite superior (exclusivo) de una cubeta en ciclos; la última no tiene
+static inline uint32_t perfilISR_limite(int cubeta) {
+    return (1UL << PERFIL_BASE) << cubeta;
+}
+
+static inline void perfilISR_imprimirHistograma(const char *titulo, const volatile uint32_t *h) {
+    printf("  %s (ciclos):", titulo);
+    for (int i = 0; i < PERFIL_CUBETAS; i++) {
+        if (h[i] == 0) continue;
+        if (i < PERFIL_CUBETAS - 1) {
+            printf(" <%lu:%lu", (unsigned long)perfilISR_limite(i), (unsigned long)h[i]);
+        } else {
+            printf(" >=%lu:%lu", (unsigned long)perfilISR_limite(i - 1), (unsigned long)h[i]);
+        }
+    }
+    printf("\n");
+}
+
+// Volcado a la consola
+static inline void perfilISR_imprimir(const perfilISR_t *p) {
+    perfilISR_t c;
+    perfilISR_consultar(p, &c);
+    printf("ISR %s: %lu muestras, duración máx %lu ciclos (%lu us)", c.nombre, (unsigned long)c.muestras,
+           (unsigned long)c.duracionMax, (unsigned long)(c.duracionMax / PERFIL_CICLOS_US));
+    if (c.periodoEsperado && c.desviacionMin <= c.desviacionMax) {
+        printf(", desviación del periodo %ld a %ld ciclos", (long)c.desviacionMin, (long)c.desviacionMax);
+    }
+    printf("\n");
+    if (c.periodoEsperado) perfilISR_imprimirHistograma("jitter", c.jitter);
+    perfilISR_imprimirHistograma("duración", c.duracion);
+}
+
+// Empieza una medición nueva (el periodo esperado y el nombre se conservan)
+static inline void perfilISR_reiniciar(perfilISR_t *p) {
+    p->entrada = 0;
+    p->muestras = 0;
+    p->desviacionMin = INT32_MAX;
+    p->desviacionMax = INT32_MIN;
+    p->duracionMax = 0;
+    for (int i = 0; i < PERFIL_CUBETAS; i++) {
+        p->jitter[i] = 0;
+        p->duracion[i] = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef PLANMOVIMIENTO_H
+#define PLANMOVIMIENTO_H
+
+// Planificador de movimiento para servos con aceleración limitada (perfil trapezoidal).
+//
+// En lugar de saltar directo al ángulo nuevo, cada periodo del PWM se avanza un
+// paso: la velocidad sube con aceleración aMax hasta vMax y baja a tiempo para
+// llegar al objetivo en reposo. El perfil se calcula en línea a partir de la
+// posición y velocidad actuales, así un objetivo nuevo a mitad del movimiento
+// se toma sin saltos: el servo frena o acelera suavemente hacia el nuevo punto.
+//
+// Son funciones puras sobre la estructura, sin hardware: quien las usa llama a
+// plan_paso() una vez por periodo y escribe el resultado en el comparador.
+
+#include <stdbool.h>
+#include <math.h>
+
+// Grados: lo que le falta al último paso para llegar se considera redondeo
+#define PLAN_TOLERANCIA 1e-4f
+
+typedef struct {
+    float posicion;    // Grados
+    float velocidad;   // Grados/s, con signo
+    float objetivo;    // Grados
+    float vMax;        // Grados/s
+    float aMax;        // Grados/s^2
+} planMovimiento_t;
+
+static inline void plan_iniciar(planMovimiento_t *plan, float posicion, float vMax, float aMax) {
+    plan->posicion = posicion;
+    plan->velocidad = 0.0f;
+    plan->objetivo = posicion;
+    plan->vMax = vMax;
+    plan->aMax = aMax;
+}
+
+static inline void plan_objetivo(planMovimiento_t *plan, float objetivo) {
+    plan->objetivo = objetivo;
+}
+
+static inline bool plan_enMovimiento(const planMovimiento_t *plan) {
+    return plan->posicion != plan->objetivo || plan->velocidad != 0.0f;
+}
+
+// Avanza dt segundos y regresa la posición nueva
+static inline float plan_paso(planMovimiento_t *plan, float dt) {
+    float distancia = plan->objetivo - plan->posicion;
+    float dv = plan->aMax * dt;   // Cambio de velocidad máximo en un paso
+
+    // Velocidad más alta con la que todavía se frena a tiempo. Frenando a fondo
+    // desde v se avanza v, v - dv, v - 2 dv... por paso: con k pasos antes de
+    // quedar por debajo de dv, la distancia de frenado es dt ((k + 1) v - dv k (k + 1) / 2).
+    // Se despeja v con la distancia que falta; la fórmula continua, sqrt(2 a d),
+    // deja al último paso más rápido de lo que se puede frenar y se pasa del objetivo
+    float porPaso = fabsf(distancia) / dt;
+    float k = floorf(0.5f * (sqrtf(8.0f * porPaso / dv + 1.0f) - 1.0f));
+    float deseada = (porPaso + 0.5f * dv * k * (k + 1.0f)) / (k + 1.0f);
+    if (deseada > plan->vMax) deseada = plan->vMax;
+    if (distancia < 0) deseada = -deseada;
+
+    float anterior = plan->velocidad;
+    float cambio = deseada - anterior;
+    if (cambio > dv) cambio = dv;
+    if (cambio < -dv) cambio = -dv;
+    plan->velocidad += cambio;
+
+    // Último paso: si este paso alcanza el objetivo y se puede llegar justo sin
+    // pasar de aMax, se queda en él; el paso siguiente termina de frenar
+    float avance = plan->velocidad * dt;
+    if (avance * distancia >= 0 && fabsf(avance) + PLAN_TOLERANCIA >= fabsf(distancia) &&
+        fabsf(distancia - anterior * dt) <= dv * dt + PLAN_TOLERANCIA) {
+        plan->posicion = plan->objetivo;
+        plan->velocidad = distancia / dt;
+        return plan->posicion;
+    }
+    plan->posicion += plan->velocidad * dt;
+    return plan->posicion;
+}
+
+#endif
@@ -4,8 +4,13 @@
 #include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "driver/gpio.h"
+#include "driver/gptimer.h"
+#include "soc/gpio_struct.h"
+#include "esp_timer.h"
 #include "esp_log.h"
+#include "Antirrebote32.h"
 
 // Definición de pines
 #define pinPWM 14     // Pin PWM para el servo
@@ -14,119 +19,303 @@
 #define BUTTON_PIN_SPEED 15 // Pin para el botón que ajusta la velocidad
 #define BUTTON_90_DEGREES 16
 
+// Servicio de botones: los flancos despiertan un timer de antirrebote que solo
+// corre mientras algún botón rebota o está presionado
+#define NUM_BOTONES 4
+#define TICK_BOTONES_US 2000       // Muestreo del antirrebote: 4 muestras iguales = 8 ms
+#define MASCARA_BOTONES ((1UL << BUTTON_PIN_INC) | (1UL << BUTTON_PIN_DEC) | \
+                         (1UL << BUTTON_PIN_SPEED) | (1UL << BUTTON_90_DEGREES))
+#define MUESTRAS_QUIETAS 4         // Muestras seguidas sin cuenta para dar por terminado un rebote sin cambio
+#define PULSACION_LARGA_MS 800
+#define REPETICION_NORMAL_MS 1000  // Repetición de inc/dec sostenido
+#define REPETICION_RAPIDA_MS 50    // ... con el botón de velocidad presionado
+#define CUBETAS_LATENCIA 8         // Histograma en potencias de 2 de ms: <1, <2, <4 ... >=64
+
 // Definir la etiqueta para el log
 static const char* TAG = "BOTONES";
 
-// Definición de tiempos en microsegundos para 0 y 180 grados
-int tiempoCeroGrados = 500;    // Tiempo en us para 0 grados
-int tiempo180Grados = 2500;    // Tiempo en us para 180 grados
-
-// Función para inicializar el servomotor
-void init_servo() {
-    mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM0A, pinPWM); // Configura GPIO 4 como salida PWM
-
-    mcpwm_config_t pwm_config;
-    pwm_config.frequency = 50;    // Frecuencia de 50 Hz (para servos)
-    pwm_config.cmpr_a = 0;        // Ciclo de trabajo inicial del canal A
-    pwm_config.cmpr_b = 0;        // No usamos el canal B
-    pwm_config.counter_mode = MCPWM_UP_COUNTER;
-    pwm_config.duty_mode = MCPWM_DUTY_MODE_0;
-    mcpwm_init(MCPWM_UNIT_0, MCPWM_TIMER_0, &pwm_config); // Inicializa el MCPWM con esta configuración
+// Tabla de calibración del servo (us en 0 y 180 grados), se ajusta en el modo de calibración
+#define MAPEO_CALIBRACIONES { MAPEO_LINEAL(500, 2500) }
+#define PASO_CALIBRACION 3         // Ticks por ajuste, ~1 us
+#define PASO_CALIBRACION_RAPIDO 32 // ... con el botón de velocidad presionado, 10 us
+// Ventana segura de los extremos: ningún ajuste lleva el pulso fuera de 400-2600 us
+// ni deja el extremo de 0 grados a menos de 500 us del de 180
+#define EXTREMO_MIN_TICKS MAPEO_US_A_TICKS(400)
+#define EXTREMO_MAX_TICKS MAPEO_US_A_TICKS(2600)
+#define SEPARACION_MIN_TICKS MAPEO_US_A_TICKS(500)
+
+// Banco de servos en el MCPWM0 (aquí solo uno, en MCPWM0A)
+#include "BancoServos.h"
+
+// Botones del servicio, el índice es el que llega en los eventos
+enum { BOTON_INC, BOTON_DEC, BOTON_VELOCIDAD, BOTON_90 };
+const uint8_t pinesBotones[NUM_BOTONES] = {BUTTON_PIN_INC, BUTTON_PIN_DEC, BUTTON_PIN_SPEED, BUTTON_90_DEGREES};
+const char *nombresBotones[NUM_BOTONES] = {"incremento", "decremento", "velocidad", "90 grados"};
+
+typedef enum { EVENTO_PRESION, EVENTO_LIBERACION, EVENTO_LARGA, EVENTO_REPETICION } tipoEvento_t;
+const char *nombresEventos[] = {"presión", "liberación", "pulsación larga", "repetición"};
+
+typedef struct {
+    int64_t tiempo_us;   // Primer flanco (presión y liberación) o instante del evento
+    uint8_t boton;
+    uint8_t tipo;
+} eventoBoton_t;
+
+QueueHandle_t colaBotones;
+gptimer_handle_t timerBotones = NULL;
+volatile bool timerBotonesActivo = false;
+volatile uint32_t eventosPerdidos = 0;
+
+// Estado de cada botón, solo lo tocan los dos ISR (el de GPIO solo marca pendientes)
+volatile uint8_t pendientes = 0;       // Bit por botón: hubo flanco y su interrupción está apagada
+volatile int64_t tiempoFlanco[NUM_BOTONES];
+uint8_t muestrasQuietas[NUM_BOTONES];
+antirrebote32_t antirreboteBotones;    // Todos los botones juntos, en bits de pin del banco 0
+uint8_t presionados = 0;               // Estado ya filtrado, bit por botón
+int64_t siguienteRepeticion[NUM_BOTONES];
+bool largaEmitida[NUM_BOTONES];
+
+static void IRAM_ATTR emitirEvento(uint8_t boton, uint8_t tipo, int64_t tiempo, BaseType_t *despertar) {
+    eventoBoton_t evento = {.tiempo_us = tiempo, .boton = boton, .tipo = tipo};
+    if (xQueueSendFromISR(colaBotones, &evento, despertar) != pdTRUE) {
+        eventosPerdidos++;
+    }
 }
 
-// Función que convierte grados a tiempo en alto (us) para el servo
-uint32_t grados_a_us(int grados) {
-    return (tiempoCeroGrados + ((tiempo180Grados - tiempoCeroGrados) * grados / 180)); // Convierte de 0 a 180 grados en el rango definido
+// Flanco en un botón: se ignora el resto del rebote y se arranca el muestreo
+static void IRAM_ATTR flancoBoton(void *arg) {
+    int boton = (intptr_t)arg;
+    gpio_intr_disable(pinesBotones[boton]);
+    tiempoFlanco[boton] = esp_timer_get_time();
+    muestrasQuietas[boton] = 0;
+    pendientes |= 1 << boton;
+    if (!timerBotonesActivo) {
+        timerBotonesActivo = true;
+        gptimer_set_raw_count(timerBotones, 0);
+        gptimer_start(timerBotones);
+    }
 }
 
-// Función principal
-void app_main(void) {
-    init_servo();
-    int angulo = 90; // Ángulo inicial en grados
-    int delayNormal = 1000;   // Retardo normal en milisegundos
-    int delayRapido = 50;    // Retardo rápido en milisegundos
+// Tick del antirrebote: acepta los cambios estables, genera pulsación larga y
+// repetición de los botones sostenidos, y se detiene cuando todo está suelto
+static bool IRAM_ATTR tickBotones(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
+    BaseType_t despertar = pdFALSE;
+    uint32_t entradas = GPIO.in;
+    int64_t ahora = esp_timer_get_time();
 
-    // Configurar los botones como entrada con pull-up
-    gpio_set_direction(BUTTON_PIN_INC, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(BUTTON_PIN_INC, GPIO_PULLUP_ONLY); // Configuración pull-up para el botón de incremento
+    // Pull-up: 0 = presionado. Los cuatro botones se filtran en una sola operación
+    uint32_t cambios = antirrebote32_muestra(&antirreboteBotones, ~entradas, MASCARA_BOTONES);
+    uint32_t ocupadas = antirrebote32_ocupadas(&antirreboteBotones) & MASCARA_BOTONES;
 
-    gpio_set_direction(BUTTON_PIN_DEC, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(BUTTON_PIN_DEC, GPIO_PULLUP_ONLY); // Configuración pull-up para el botón de decremento
+    for (int b = 0; b < NUM_BOTONES; b++) {
+        uint8_t bit = 1 << b;
+        uint32_t pin = 1UL << pinesBotones[b];
+        // Un cambio sin flanco (llegó con la interrupción apagada) se marca con el tick
+        int64_t tiempo = (pendientes & bit) ? tiempoFlanco[b] : ahora;
 
-    gpio_set_direction(BUTTON_PIN_SPEED, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(BUTTON_PIN_SPEED, GPIO_PULLUP_ONLY); // Configuración pull-up para el botón de velocidad
+        if (cambios & pin) {
+            if (antirreboteBotones.estado & pin) {
+                presionados |= bit;
+                largaEmitida[b] = false;
+                siguienteRepeticion[b] = tiempo + PULSACION_LARGA_MS * 1000LL;
+                emitirEvento(b, EVENTO_PRESION, tiempo, &despertar);
+            } else {
+                presionados &= ~bit;
+                emitirEvento(b, EVENTO_LIBERACION, tiempo, &despertar);
+            }
+        } else if ((presionados & bit) && ahora >= siguienteRepeticion[b]) {
+            // Sostenido: primero la pulsación larga y luego las repeticiones (solo inc/dec)
+            bool rapido = presionados & (1 << BOTON_VELOCIDAD);
+            emitirEvento(b, largaEmitida[b] ? EVENTO_REPETICION : EVENTO_LARGA, ahora, &despertar);
+            largaEmitida[b] = true;
+            if (b == BOTON_INC || b == BOTON_DEC) {
+                siguienteRepeticion[b] = ahora + (rapido ? REPETICION_RAPIDA_MS : REPETICION_NORMAL_MS) * 1000LL;
+            } else {
+                siguienteRepeticion[b] = INT64_MAX;
+            }
+        }
 
-    gpio_set_direction(BUTTON_90_DEGREES, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(BUTTON_90_DEGREES, GPIO_PULLUP_ONLY);
+        // Terminó el rebote: volver a escuchar flancos de este botón. Un cambio
+        // aceptado lo termina; sin cambio hacen falta varias muestras sin cuenta,
+        // porque una sola puede caer a media ráfaga y el siguiente rebote
+        // volvería a interrumpir con una marca de tiempo más tarde
+        if (pendientes & bit) {
+            if (ocupadas & pin) {
+                muestrasQuietas[b] = 0;
+            } else if ((cambios & pin) || ++muestrasQuietas[b] >= MUESTRAS_QUIETAS) {
+                pendientes &= ~bit;
+                gpio_intr_enable(pinesBotones[b]);
+            }
+        }
+    }
 
-    int button_state_inc;
-    int button_state_dec;
-    int button_state_speed;
-    int button_state_90deg;
-    int last_button_state_inc = 1; // Inicialmente el estado es alto debido al pull-up
-    int last_button_state_dec = 1; // Inicialmente el estado es alto debido al pull-up
-    int last_button_state_90deg = 1; 
+    if (!pendientes && !presionados && !ocupadas) {
+        gptimer_stop(timer);
+        timerBotonesActivo = false;
+    }
+    return despertar == pdTRUE;
+}
 
-    while (true) {
-        // Leer el estado de los botones
-        button_state_inc = gpio_get_level(BUTTON_PIN_INC);
-        button_state_dec = gpio_get_level(BUTTON_PIN_DEC);
-        button_state_speed = gpio_get_level(BUTTON_PIN_SPEED);
-        button_state_90deg = gpio_get_level(BUTTON_90_DEGREES);
+void configurarBotones() {
+    colaBotones = xQueueCreate(16, sizeof(eventoBoton_t));
 
-        // Determinar el retardo en función de si el botón de velocidad está presionado
-        int delay = (button_state_speed == 0) ? delayRapido : delayNormal;
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,  // 1 MHz para contar en microsegundos
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &timerBotones));
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = TICK_BOTONES_US,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(timerBotones, &alarm_config));
+    gptimer_event_callbacks_t cbs = {
+        .on_alarm = tickBotones,
+    };
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(timerBotones, &cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_enable(timerBotones));
 
-        // Incrementar ángulo si se presiona el botón de incremento
-        if (button_state_inc == 0 && last_button_state_inc == 1) {
-            ESP_LOGI(TAG, "Botón de incremento presionado");
+    // Botones como entrada con pull-up, interrupción en ambos flancos
+    gpio_install_isr_service(0);
+    for (int b = 0; b < NUM_BOTONES; b++) {
+        gpio_set_direction(pinesBotones[b], GPIO_MODE_INPUT);
+        gpio_set_pull_mode(pinesBotones[b], GPIO_PULLUP_ONLY);
+        gpio_set_intr_type(pinesBotones[b], GPIO_INTR_ANYEDGE);
+        gpio_isr_handler_add(pinesBotones[b], flancoBoton, (void *)(intptr_t)b);
+    }
+}
 
-            // Incrementar el ángulo en 10 grados
-            angulo += 10;
+// Histograma de latencia flanco -> evento recibido por el control del servo
+uint32_t histogramaLatencia[CUBETAS_LATENCIA];
 
-            // Limitar el ángulo a un máximo de 180 grados
-            if (angulo > 180) {
-                angulo = 180;
-            }
+void registrarLatencia(int64_t latencia_us) {
+    int cubeta = 0;
+    int64_t limite = 1000;  // 1 ms
+    while (cubeta < CUBETAS_LATENCIA - 1 && latencia_us >= limite) {
+        cubeta++;
+        limite *= 2;
+    }
+    histogramaLatencia[cubeta]++;
+}
 
-            // Ajusta el ciclo de trabajo para mover el servo
-            uint32_t tiempo = grados_a_us(angulo);
-            mcpwm_set_duty_in_us(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_OPR_A, tiempo);
+void imprimirLatencias() {
+    printf("Latencia flanco -> evento (ms):");
+    for (int i = 0; i < CUBETAS_LATENCIA; i++) {
+        if (i < CUBETAS_LATENCIA - 1) {
+            printf(" <%d:%lu", 1 << i, (unsigned long)histogramaLatencia[i]);
+        } else {
+            printf(" >=%d:%lu", 1 << (i - 1), (unsigned long)histogramaLatencia[i]);
         }
+    }
+    printf(" | perdidos: %lu\n", (unsigned long)eventosPerdidos);
+}
+
+// Mueve el servo al ángulo indicado, limitado a 0-180 grados
+int moverServo(int angulo) {
+    if (angulo > 180) angulo = 180;
+    if (angulo < 0) angulo = 0;
+    bancoServos_moverUno(0, angulo);
+    return angulo;
+}
+
+// Calibración de extremos: pulsación larga del botón de 90 grados. El servo va a
+// 0 grados y inc/dec ajustan el pulso hasta que quede justo en 0; el botón de 90
+// lo registra y pasa a 180 grados, donde se hace lo mismo. Al registrar 180 se
+// imprime la tabla nueva y se regresa a 90 grados
+typedef enum { CALIBRACION_NO, CALIBRACION_0, CALIBRACION_180 } pasoCalibracion_t;
+pasoCalibracion_t pasoCalibracion = CALIBRACION_NO;
+uint16_t extremo0, extremo180;
 
-        // Decrementar ángulo si se presiona el botón de decremento
-        if (button_state_dec == 0 && last_button_state_dec == 1) {
-            ESP_LOGI(TAG, "Botón de decremento presionado");
+void imprimirCalibracion() {
+    printf("Calibración servo 0 (ticks de %d MHz / us):", MAPEO_RESOLUCION_HZ / 1000);
+    for (int i = 0; i < MAPEO_PUNTOS; i++) {
+        printf(" %d:%u/%u", i * 10, mapeoTablas[0][i], MAPEO_TICKS_A_US(mapeoTablas[0][i]));
+    }
+    printf("\n");
+}
 
-            // Disminuir el ángulo en 10 grados
-            angulo -= 10;
+// Limita un valor al intervalo [minimo, maximo]
+static int32_t limitar(int32_t valor, int32_t minimo, int32_t maximo) {
+    if (valor < minimo) return minimo;
+    if (valor > maximo) return maximo;
+    return valor;
+}
 
-            // Limitar el ángulo a un mínimo de 0 grados
-            if (angulo < 0) {
-                angulo = 0;
-            }
+// Mueve el extremo que se calibra sin salir de la ventana segura
+void ajustarExtremo(int ticks) {
+    if (pasoCalibracion == CALIBRACION_0) {
+        extremo0 = limitar((int32_t)extremo0 + ticks, EXTREMO_MIN_TICKS, extremo180 - SEPARACION_MIN_TICKS);
+    } else {
+        extremo180 = limitar((int32_t)extremo180 + ticks, extremo0 + SEPARACION_MIN_TICKS, EXTREMO_MAX_TICKS);
+    }
+    mapeo_calibrarExtremos(0, extremo0, extremo180);
+    bancoServos_refrescar();   // El servo está quieto: reescribir el comparador con la tabla nueva
+    ESP_LOGI(TAG, "Extremo de %d grados: %u us", pasoCalibracion == CALIBRACION_0 ? 0 : 180,
+             MAPEO_TICKS_A_US(pasoCalibracion == CALIBRACION_0 ? extremo0 : extremo180));
+}
 
-            // Ajusta el ciclo de trabajo para mover el servo
-            uint32_t tiempo = grados_a_us(angulo);
-            mcpwm_set_duty_in_us(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_OPR_A, tiempo);
+// Atiende un evento en modo calibración; regresa el ángulo nuevo del servo
+int calibrar(const eventoBoton_t *evento, bool rapido, int angulo) {
+    int paso = rapido ? PASO_CALIBRACION_RAPIDO : PASO_CALIBRACION;
+    if (evento->boton == BOTON_INC) {
+        ajustarExtremo(paso);
+    } else if (evento->boton == BOTON_DEC) {
+        ajustarExtremo(-paso);
+    } else if (evento->boton == BOTON_90 && evento->tipo == EVENTO_PRESION) {
+        if (pasoCalibracion == CALIBRACION_0) {
+            ESP_LOGI(TAG, "0 grados registrado, calibrando 180 grados");
+            pasoCalibracion = CALIBRACION_180;
+            return moverServo(180);
         }
+        ESP_LOGI(TAG, "180 grados registrado, fin de la calibración");
+        pasoCalibracion = CALIBRACION_NO;
+        imprimirCalibracion();
+        return moverServo(90);
+    }
+    return angulo;
+}
 
-        if (button_state_90deg == 0 && last_button_state_90deg == 1) {
-            ESP_LOGI(TAG, "Regresando a 90 grados");
+// Función principal
+void app_main(void) {
+    const int pinesServos[] = {pinPWM};
+    const float angulosIniciales[] = {90};
+    bancoServos_iniciar(pinesServos, 1, angulosIniciales);
+    configurarBotones();
+    int angulo = 90; // Ángulo inicial en grados
 
-            // Disminuir el ángulo en 10 grados
-            angulo = 90; 
+    eventoBoton_t evento;
+    while (true) {
+        // Se duerme hasta el siguiente evento; cada 10 s sin eventos imprime el histograma
+        if (xQueueReceive(colaBotones, &evento, pdMS_TO_TICKS(10000)) != pdTRUE) {
+            imprimirLatencias();
+            continue;
+        }
 
-            // Ajusta el ciclo de trabajo para mover el servo
-            uint32_t tiempo = grados_a_us(angulo);
-            mcpwm_set_duty_in_us(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_OPR_A, tiempo);
+        if (evento.tipo == EVENTO_PRESION || evento.tipo == EVENTO_LIBERACION) {
+            registrarLatencia(esp_timer_get_time() - evento.tiempo_us);
         }
+        ESP_LOGI(TAG, "Botón de %s: %s (%lld us)", nombresBotones[evento.boton],
+                 nombresEventos[evento.tipo], (long long)evento.tiempo_us);
 
-        // Guardar el estado actual de los botones
-        last_button_state_inc = button_state_inc;
-        last_button_state_dec = button_state_dec;
+        // Presión, pulsación larga y repetición mueven el servo; la liberación no
+        if (evento.tipo == EVENTO_LIBERACION) continue;
 
-        // Esperar según el retardo determinado por el botón de velocidad
-        vTaskDelay(delay / portTICK_PERIOD_MS);
+        if (pasoCalibracion != CALIBRACION_NO) {
+            angulo = calibrar(&evento, presionados & (1 << BOTON_VELOCIDAD), angulo);
+        } else if (evento.boton == BOTON_90 && evento.tipo == EVENTO_LARGA) {
+            ESP_LOGI(TAG, "Calibrando 0 grados: inc/dec ajustan, 90 registra");
+            pasoCalibracion = CALIBRACION_0;
+            extremo0 = mapeoTablas[0][0];
+            extremo180 = mapeoTablas[0][MAPEO_PUNTOS - 1];
+            angulo = moverServo(0);
+        } else if (evento.boton == BOTON_INC) {
+            angulo = moverServo(angulo + 10);   // Incrementar el ángulo en 10 grados
+        } else if (evento.boton == BOTON_DEC) {
+            angulo = moverServo(angulo - 10);   // Disminuir el ángulo en 10 grados
+        } else if (evento.boton == BOTON_90 && evento.tipo == EVENTO_PRESION) {
+            ESP_LOGI(TAG, "Regresando a 90 grados");
+            angulo = moverServo(90);
+        }
     }
 }
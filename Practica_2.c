@@ -2,6 +2,7 @@
  #include "freertos/FreeRTOS.h" 
  #include "freertos/task.h" 
  #include "esp_log.h" 
+ #include "soc/gpio_struct.h"
 
  //Pins del led 
  #define A 21 
@@ -27,37 +28,18 @@
      gpio_set_direction(G, GPIO_MODE_OUTPUT); 
  } 
 
- void mostrarNumero(int numero) { 
- uint8_t segmentos[20] = { 
-         0x7E, // 0 
-         0x30, // 1 
-         0x6D, // 2 
-         0x79, // 3 
-         0x33, // 4 
-         0x5B, // 5 
-         0x1F, // 6 
-         0x70, // 7 
-         0x7F, // 8 
-         0x73, // 9 
-         0x77, //A 
-         0x7F, //B 
-         0x4E, //C 
-         0x7E, //D 
-         0x4F, //E 
-         0x47, //F 
-         0x5F, //G 
-         0x37, //H 
-         0x30, //I 
-         0x38, //J  
-         }; 
+ // Fuente común de 7 segmentos con el mapa de pines de esta placa
+ #define SEG7_PINES A, B, C, D, E, F, G
+ #include "Fuente7Seg.h"
 
-     gpio_set_level(A, (segmentos[numero] >> 6) & 1); 
-     gpio_set_level(B, (segmentos[numero] >> 5) & 1); 
-     gpio_set_level(C, (segmentos[numero] >> 4) & 1); 
-     gpio_set_level(D, (segmentos[numero] >> 3) & 1); 
-     gpio_set_level(E, (segmentos[numero] >> 2) & 1); 
-     gpio_set_level(F, (segmentos[numero] >> 1) & 1); 
-     gpio_set_level(G, (segmentos[numero] >> 0) & 1); 
+ // Los índices 0-19 son 0-9 y A-J, seguidos en la fuente a partir de SEG7_0
+ // Escribe el carácter completo con una escritura W1TS y una W1TC por banco
+ void mostrarNumero(int numero) { 
+     const seg7Mascara_t *m = &seg7Fuente[SEG7_0 + numero];
+     GPIO.out_w1tc = m->clr0;
+     GPIO.out1_w1tc.val = m->clr1;
+     GPIO.out_w1ts = m->set0;
+     GPIO.out1_w1ts.val = m->set1;
  } 
 
  void app_main() { 
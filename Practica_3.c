@@ -2,12 +2,15 @@
 #include "freertos/FreeRTOS.h" 
 #include "freertos/task.h" 
 #include "esp_log.h"
+#include "soc/gpio_struct.h"
 #include <stdio.h>
 #include <stdbool.h>
 #include <unistd.h>
 #include "sdkconfig.h"
 #include "driver/mcpwm.h"
 #include "soc/mcpwm_periph.h"
+#include "esp_cpu.h"
+#include "EventosGPIO.h"
 
 //Pins del led 
 #define A 21 
@@ -23,30 +26,26 @@
 #define BOTON6 6 // Pin GPIO al que está conectado el botón
 
 #define pinPWM 14     // Pin PWM para el servo
-// Definición de tiempos en microsegundos para 0 y 180 grados
-int tiempoCeroGrados = 500;    // Tiempo en us para 0 grados
-int tiempo180Grados = 2500;    // Tiempo en us para 180 grados
+// Tabla de calibración del servo: pulso en us en 0 y 180 grados (MapeoServo.h)
+#define MAPEO_CALIBRACIONES { MAPEO_LINEAL(500, 2500) }
 
-volatile uint8_t bandera1 = 0;  // Declaración de la bandera para el primer pin
-volatile uint8_t bandera2 = 0;  // Declaración de la bandera para el segundo pin
-volatile uint8_t bandera3 = 0;  // Declaración de la bandera para el tercer pin
+// Cada botón es una fuente. Una sola ISR para los tres pines guarda cada flanco
+// (pin, ciclo) en la cola de EventosGPIO.h y despierta a la tarea manejador,
+// que los atiende por lotes sin perder ninguno
+#define NUM_FUENTES 3
+#define LOTE_EVENTOS 16
+#define CUBETAS_LATENCIA 12   // Histograma en potencias de 2 de ciclos: <256, <512 ... >=256K
 
-static const char *TAG = "INTERRUPCIONES";  // Tag para identificar los logs
-
-
-// Manejador de interrupción para el primer pin
-static void IRAM_ATTR funcionInterrupcion1(void *arg) {
-    bandera1 = 1;
-}
+TaskHandle_t tareaManejador = NULL;
+colaEventosGPIO_t entradas;
 
-// Manejador de interrupción para el segundo pin
-static void IRAM_ATTR funcionInterrupcion2(void *arg) {
-    bandera2 = 1;
-}
+static const char *TAG = "INTERRUPCIONES";  // Tag para identificar los logs
 
-// Manejador de interrupción para el tercer pin
-static void IRAM_ATTR funcionInterrupcion3(void *arg) {
-    bandera3 = 1;
+// Aviso de la ISR única: despierta al manejador
+static bool IRAM_ATTR avisarManejador(void) {
+    BaseType_t despertar = pdFALSE;
+    vTaskNotifyGiveFromISR(tareaManejador, &despertar);
+    return despertar == pdTRUE;
 }
 
 void configurarDisplay() { 
@@ -59,54 +58,104 @@ void configurarDisplay() {
      gpio_set_direction(G, GPIO_MODE_OUTPUT); 
 } 
 
+// Fuente común de 7 segmentos con el mapa de pines de esta placa
+#define SEG7_PINES A, B, C, D, E, F, G
+#include "Fuente7Seg.h"
+
+// Los índices 0-19 son 0-9 y A-J, seguidos en la fuente a partir de SEG7_0
+// Escribe el carácter completo con una escritura W1TS y una W1TC por banco
 void mostrarNumero(int numero) { 
-    uint8_t segmentos[20] = { 
-         0x7E, // 0 
-         0x30, // 1 
-         0x6D, // 2 
-         0x79, // 3 
-         0x33, // 4 
-         0x5B, // 5 
-         0x1F, // 6 
-         0x70, // 7 
-         0x7F, // 8 
-         0x73, // 9 
-         0x77, //A 
-         0x7F, //B 
-         0x4E, //C 
-         0x7E, //D 
-         0x4F, //E 
-         0x47, //F 
-         0x5F, //G 
-         0x37, //H 
-         0x30, //I 
-         0x38, //J  
-         }; 
-
-     gpio_set_level(A, (segmentos[numero] >> 6) & 1); 
-     gpio_set_level(B, (segmentos[numero] >> 5) & 1); 
-     gpio_set_level(C, (segmentos[numero] >> 4) & 1); 
-     gpio_set_level(D, (segmentos[numero] >> 3) & 1); 
-     gpio_set_level(E, (segmentos[numero] >> 2) & 1); 
-     gpio_set_level(F, (segmentos[numero] >> 1) & 1); 
-     gpio_set_level(G, (segmentos[numero] >> 0) & 1); 
+    const seg7Mascara_t *m = &seg7Fuente[SEG7_0 + numero];
+    GPIO.out_w1tc = m->clr0;
+    GPIO.out1_w1tc.val = m->clr1;
+    GPIO.out_w1ts = m->set0;
+    GPIO.out1_w1ts.val = m->set1;
 } 
 
-void init_servo() {
-    mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM0A, pinPWM); // Configura GPIO 4 como salida PWM
+// Banco de servos en el MCPWM0 (aquí solo uno, en MCPWM0A)
+#include "BancoServos.h"
+
+// Latencia ISR -> manejador en ciclos de CPU
+uint32_t latenciaMin = UINT32_MAX, latenciaMax = 0;
+uint64_t latenciaSuma = 0;
+uint32_t latenciaMuestras = 0;
+uint32_t histogramaLatencia[CUBETAS_LATENCIA];
+
+void registrarLatencia(uint32_t ciclos) {
+    if (ciclos < latenciaMin) latenciaMin = ciclos;
+    if (ciclos > latenciaMax) latenciaMax = ciclos;
+    latenciaSuma += ciclos;
+    latenciaMuestras++;
+
+    int cubeta = 0;
+    uint32_t limite = 256;
+    while (cubeta < CUBETAS_LATENCIA - 1 && ciclos >= limite) {
+        cubeta++;
+        limite *= 2;
+    }
+    histogramaLatencia[cubeta]++;
+}
 
-    mcpwm_config_t pwm_config;
-    pwm_config.frequency = 50;    // Frecuencia de 50 Hz (para servos)
-    pwm_config.cmpr_a = 0;        // Ciclo de trabajo inicial del canal A
-    pwm_config.cmpr_b = 0;        // No usamos el canal B
-    pwm_config.counter_mode = MCPWM_UP_COUNTER;
-    pwm_config.duty_mode = MCPWM_DUTY_MODE_0;
-    mcpwm_init(MCPWM_UNIT_0, MCPWM_TIMER_0, &pwm_config); // Inicializa el MCPWM con esta configuración
+void imprimirLatencias() {
+    if (latenciaMuestras == 0) return;
+    ESP_LOGI(TAG, "Latencia ISR -> manejador: min %lu, prom %lu, max %lu ciclos (%lu muestras)",
+             (unsigned long)latenciaMin, (unsigned long)(latenciaSuma / latenciaMuestras),
+             (unsigned long)latenciaMax, (unsigned long)latenciaMuestras);
+    printf("Histograma (ciclos):");
+    for (int i = 0; i < CUBETAS_LATENCIA; i++) {
+        if (i < CUBETAS_LATENCIA - 1) {
+            printf(" <%lu:%lu", 256UL << i, (unsigned long)histogramaLatencia[i]);
+        } else {
+            printf(" >=%lu:%lu", 256UL << (i - 1), (unsigned long)histogramaLatencia[i]);
+        }
+    }
+    printf("\n");
 }
-// Función que convierte grados a tiempo en alto (us) para el servo
-uint32_t grados_a_us(int grados) {
-    return (tiempoCeroGrados + ((tiempo180Grados - tiempoCeroGrados) * grados / 180)); // Convierte de 0 a 180 grados en el rango definido
+
+// Lo que hace cada fuente: número en el display y ángulo del servo
+const int pinFuente[NUM_FUENTES] = {BOTON4, BOTON5, BOTON6};
+const int numeroFuente[NUM_FUENTES] = {0, 9, 10};
+const int anguloFuente[NUM_FUENTES] = {0, 90, 180};
+
+// Duerme hasta que la ISR lo despierta; cada 10 s sin interrupciones imprime las latencias
+void manejadorInterrupciones(void *pvParameters) {
+    uint32_t conteo[NUM_FUENTES] = {0};
+    eventoGPIO_t lote[LOTE_EVENTOS];
+
+    while (true) {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10000)) == 0) {
+            imprimirLatencias();
+            perfilISR_imprimir(&entradas.perfil);
+            if (entradas.perdidos) {
+                ESP_LOGW(TAG, "Eventos perdidos con la cola llena: %lu", (unsigned long)entradas.perdidos);
+            }
+            ESP_LOGI(TAG, "Órdenes al servo: %lu publicadas, %lu combinadas, %lu aplicadas",
+                     (unsigned long)bancoServos.buzon.publicadas, (unsigned long)bancoServos.buzon.combinadas,
+                     (unsigned long)bancoServos.buzon.aplicadas);
+            continue;
+        }
+
+        int n;
+        while ((n = eventosGPIO_sacar(&entradas, lote, LOTE_EVENTOS)) > 0) {
+            uint32_t ciclo = esp_cpu_get_cycle_count();
+            for (int k = 0; k < n; k++) {
+                registrarLatencia(ciclo - lote[k].ciclo);
+
+                int i = 0;
+                while (i < NUM_FUENTES && pinFuente[i] != lote[k].pin) i++;
+                if (i == NUM_FUENTES) continue;
+                conteo[i]++;
+
+                mostrarNumero(numeroFuente[i]);
+                bancoServos_publicar(0, anguloFuente[i] * 10);   // En una ráfaga solo cuenta el último
+
+                ESP_LOGI(TAG, "Interrupción detectada en pin %d, se ha ejecutado %lu, la funcion de interrupcion",
+                         pinFuente[i], (unsigned long)conteo[i]);
+            }
+        }
+    }
 }
+
 void app_main() {
     // Configuración de los pines de entrada
     gpio_reset_pin(BOTON4);
@@ -121,62 +170,19 @@ void app_main() {
     gpio_set_direction(BOTON6, GPIO_MODE_INPUT);
     gpio_set_intr_type(BOTON6, GPIO_INTR_NEGEDGE);  // Interrupción en flanco de bajada
     
-    // Instalación del servicio ISR
-    gpio_install_isr_service(0);
-    
-    // Asignar manejadores de interrupciones a cada pin
-    gpio_isr_handler_add(BOTON4, funcionInterrupcion1, NULL);
-    gpio_isr_handler_add(BOTON5, funcionInterrupcion2, NULL);
-    gpio_isr_handler_add(BOTON6, funcionInterrupcion3, NULL);
-    int cuentaInt0 = 0;
-    int cuentaInt1 = 0;
-    int cuentaInt2 = 0;
-
     configurarDisplay();
-
-    init_servo();
-    int angulo = 0;
-
-    while (true) {
-        if (bandera1) {  // Revisamos la bandera del primer pin
-            mostrarNumero(0);
-            ESP_LOGI(TAG, "Interrupción detectada en pin %d, se ha ejecutado %d, la funcion de interrupcion", BOTON4, cuentaInt0);
-            
-            // Disminuir el ángulo en 10 grados
-            angulo = 0; 
-            // Ajusta el ciclo de trabajo para mover el servo
-            uint32_t tiempo = grados_a_us(angulo);
-            mcpwm_set_duty_in_us(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_OPR_A, tiempo);
-
-            bandera1 = 0;  // Reiniciar la bandera
-            cuentaInt0++;
-        }
-        if (bandera2) {  // Revisamos la bandera del segundo pin
-            mostrarNumero(9);
-            ESP_LOGI(TAG, "Interrupción detectada en pin %d, se ha ejecutado %d, la funcion de interrupcion", BOTON5, cuentaInt1);
-                        
-            // Disminuir el ángulo en 10 grados
-            angulo = 90; 
-            // Ajusta el ciclo de trabajo para mover el servo
-            uint32_t tiempo = grados_a_us(angulo);
-            mcpwm_set_duty_in_us(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_OPR_A, tiempo);
-
-            bandera2 = 0;  // Reiniciar la bandera
-            cuentaInt1++;
-        }
-        if (bandera3) {  // Revisamos la bandera del tercer pin
-            mostrarNumero(10);
-            ESP_LOGI(TAG, "Interrupción detectada en pin %d, se ha ejecutado %d, la funcion de interrupcion", BOTON6, cuentaInt2);
-                        
-            // Disminuir el ángulo en 10 grados
-            angulo = 180; 
-            // Ajusta el ciclo de trabajo para mover el servo
-            uint32_t tiempo = grados_a_us(angulo);
-            mcpwm_set_duty_in_us(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_OPR_A, tiempo);
-
-            bandera3 = 0;  // Reiniciar la bandera
-            cuentaInt2++;
-        }
-        usleep(500 * 1000);  // Retardo de 500ms
+    const int pinesServos[] = {pinPWM};
+    const float angulosIniciales[] = {0};
+    bancoServos_iniciar(pinesServos, 1, angulosIniciales);
+
+    // El manejador corre en el mismo núcleo que la ISR (la registra este núcleo),
+    // así el contador de ciclos de los dos lados es el mismo
+    xTaskCreatePinnedToCore(manejadorInterrupciones, "Manejador", 3072, NULL, configMAX_PRIORITIES - 2,
+                            &tareaManejador, xPortGetCoreID());
+
+    // Una sola ISR para los tres botones
+    eventosGPIO_instalar(&entradas, (1ULL << BOTON4) | (1ULL << BOTON5) | (1ULL << BOTON6), avisarManejador);
+    for (int i = 0; i < NUM_FUENTES; i++) {
+        gpio_intr_enable(pinFuente[i]);
     }
 }
@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include "esp_task_wdt.h"
 #include "driver/gptimer.h"
+#include "soc/gpio_struct.h"
 
 #define pin_catodo_displayUnidades 12
 #define pin_catodo_displayDecenas  9 
@@ -15,6 +16,11 @@
 #define intervaloTimer_us (2000)
 #define intervaloTimer2_us (100000)
 
+// 1: el ISR del timer multiplexa el display desde frameDisplay (core 1 libre, watchdog activo)
+// 0: la tarea task_core_1 multiplexa por sondeo (modo anterior, para comparar el CPU libre)
+#define MULTIPLEXADO_EN_ISR 1
+#define intervaloMedicion_ms (1000)
+
 #define segmento_A 4
 #define segmento_B 5
 #define segmento_C 6
@@ -23,113 +29,175 @@
 #define segmento_F 16
 #define segmento_G 17
 
-#define cero    0x7E
-#define uno     0x30
-#define dos     0x6D
-#define tres    0x79
-#define cuatro  0x33
-#define cinco   0x5B
-#define seis    0x5F
-#define siete   0x70
-#define ocho    0x7f
-#define nueve   0x7b
-#define todosApagados   0x00
+// Fuente común de 7 segmentos con el mapa de pines de esta placa
+#define SEG7_PINES segmento_A, segmento_B, segmento_C, segmento_D, segmento_E, segmento_F, segmento_G
+#include "Fuente7Seg.h"
 
+// Los dos trabajos periódicos comparten un solo gptimer: el tick de la rueda es
+// el del multiplexado y el contador va cada 50 ticks
+#define TIMERS_SOFT_TICK_US intervaloTimer_us
+#include "TimersSoft.h"
+#include "PerfilISR.h"
 
-uint8_t numerosCodifiados[11] = {cero, uno, dos, tres, cuatro, cinco, seis, siete, ocho, nueve, todosApagados};
+// Máscaras de los catodos y de todo el display, calculadas por el compilador
+const uint32_t mascaraCatodos[3] = {
+    SEG7_BIT0(pin_catodo_displayUnidades), SEG7_BIT0(pin_catodo_displayDecenas), SEG7_BIT0(pin_catodo_displayCentenas)
+};
+#define mascaraDisplay (SEG7_SEGMENTOS0 | SEG7_BIT0(pin_catodo_displayUnidades) | \
+                        SEG7_BIT0(pin_catodo_displayDecenas) | SEG7_BIT0(pin_catodo_displayCentenas))
 
  uint8_t unidades = 0;
  uint8_t decenas  = 0;
  uint8_t centenas = 0;
- uint16_t contador = 0;
+ // Contador en BCD empaquetado, un nibble por dígito (0x123 = 123), y generación que cambia con cada valor nuevo
+ volatile uint16_t contador = 0x000;
+ volatile uint32_t generacionContador = 0;
 
 volatile int activacionDisplays = 0;
 
-static bool IRAM_ATTR on_timer_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
+// Palabra W1TS de cada display (catodo + segmentos), lista para escribirse desde el ISR
+volatile uint32_t frameDisplay[3];
+
+// Recalcula el frame del display para el número dado en BCD, sin divisiones
+static void IRAM_ATTR actualizaFrame(uint16_t bcd) {
+    frameDisplay[0] = mascaraCatodos[0] | seg7Fuente[SEG7_0 + (bcd & 0xF)].set0;
+    frameDisplay[1] = mascaraCatodos[1] | seg7Fuente[SEG7_0 + ((bcd >> 4) & 0xF)].set0;
+    frameDisplay[2] = mascaraCatodos[2] | seg7Fuente[SEG7_0 + ((bcd >> 8) & 0xF)].set0;
+}
+
+// Incrementa un número BCD de 3 dígitos con acarreo entre nibbles (999 -> 000)
+static inline uint16_t IRAM_ATTR incrementaBCD(uint16_t bcd) {
+    bcd++;
+    if ((bcd & 0x00F) > 0x009) bcd += 0x006;  // Acarreo de unidades a decenas
+    if ((bcd & 0x0F0) > 0x090) bcd += 0x060;  // Acarreo de decenas a centenas
+    if ((bcd & 0xF00) > 0x900) bcd = 0x000;
+    return bcd;
+}
+
+timerSoft_t timerMultiplexado, timerContador;
+
+// Retraso y duración de los dos trabajos; el fantasma del display depende del primero
+perfilISR_t perfilMultiplexado = PERFIL_ISR_INICIAL("multiplexado", intervaloTimer_us);
+perfilISR_t perfilContador = PERFIL_ISR_INICIAL("contador", intervaloTimer2_us);
+
+static bool IRAM_ATTR on_timer_alarm(void *arg) {
+    PERFIL_ISR_ENTRADA(&perfilMultiplexado);
+#if MULTIPLEXADO_EN_ISR
+    // El propio ISR enciende el siguiente display, ninguna tarea tiene que sondear
+    GPIO.out_w1tc = mascaraDisplay;
+    GPIO.out_w1ts = frameDisplay[activacionDisplays];
+#endif
     activacionDisplays++;
     if(activacionDisplays >= 3){
         activacionDisplays = 0;
     }
-    return true;
+    PERFIL_ISR_SALIDA(&perfilMultiplexado);
+    return false;
+}
+
+static bool IRAM_ATTR on_timer2_alarm(void *arg) {
+    PERFIL_ISR_ENTRADA(&perfilContador);
+    uint16_t siguiente = incrementaBCD(contador);
+    contador = siguiente;
+    generacionContador++;
+    actualizaFrame(siguiente);
+    PERFIL_ISR_SALIDA(&perfilContador);
+    return false;
 }
 
-static bool IRAM_ATTR on_timer2_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
-    contador++;
-    if(contador>999) contador=0;
-    return true;
+void decodifica_BCD(uint16_t bcd, uint8_t *centenas_var, uint8_t *decenas_var, uint8_t *unidades_var) {
+    *centenas_var = (bcd >> 8) & 0xF; // Extrae las centenas
+    *decenas_var = (bcd >> 4) & 0xF;  // Extrae las decenas
+    *unidades_var = bcd & 0xF;        // Extrae las unidades
 }
 
-void decodifica_Numero(uint16_t numero, uint8_t *centenas_var, uint8_t *decenas_var, uint8_t *unidades_var) {
-    if (numero > 999) {
-        printf("Número fuera de rango. Debe estar entre 0 y 99.\n");
-        return;
+// Porcentaje de tiempo libre de cada núcleo según las estadísticas de ejecución de FreeRTOS
+// Requiere CONFIG_FREERTOS_USE_TRACE_FACILITY y CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+#define maxTareas 16
+
+void imprimeCPULibre() {
+    static uint32_t idleAnterior[2] = {0, 0};
+    static uint32_t totalAnterior = 0;
+    static TaskStatus_t tareas[maxTareas];
+    uint32_t total = 0;
+    uint32_t idle[2] = {idleAnterior[0], idleAnterior[1]};
+
+    UBaseType_t n = uxTaskGetSystemState(tareas, maxTareas, &total);
+    for (UBaseType_t i = 0; i < n; i++) {
+        for (int core = 0; core < 2; core++) {
+            if (tareas[i].xHandle == xTaskGetIdleTaskHandleForCPU(core)) idle[core] = tareas[i].ulRunTimeCounter;
+        }
     }
-    
-    *centenas_var = numero / 100; // Extrae las centenas
-    *decenas_var = (numero % 100) / 10;  // Extrae las decenas
-    *unidades_var = numero % 10;  // Extrae las unidades
+
+    uint32_t transcurrido = total - totalAnterior;
+    if (totalAnterior != 0 && transcurrido > 0) {
+        printf("CPU libre: core 0 %lu%%, core 1 %lu%%\n",
+               (unsigned long)((uint64_t)(idle[0] - idleAnterior[0]) * 100 / transcurrido),
+               (unsigned long)((uint64_t)(idle[1] - idleAnterior[1]) * 100 / transcurrido));
+    }
+    idleAnterior[0] = idle[0];
+    idleAnterior[1] = idle[1];
+    totalAnterior = total;
+}
+#else
+void imprimeCPULibre() {
+    printf("Activar CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS para medir el CPU libre\n");
 }
+#endif
 
 void task_core_0(void *pvParameters) {
+    uint32_t mediciones = 0;
     while (1) {
         printf("Ejecutando en Core 0\n");
-        vTaskDelay(pdMS_TO_TICKS(1000)); // Espera de 1 segundo
+        imprimeCPULibre();
+        if (++mediciones % 10 == 0) {
+            perfilISR_imprimir(&perfilMultiplexado);
+            perfilISR_imprimir(&perfilContador);
+        }
+        vTaskDelay(pdMS_TO_TICKS(intervaloMedicion_ms));
     }
 }
 
-void decodificaSegmentos(uint8_t display){
-    //Parte baja
-   gpio_set_level(segmento_G, (display & 0b00000001) >> 0);  
-   gpio_set_level(segmento_F, (display & 0b00000010) >> 1);  
-   gpio_set_level(segmento_E, (display & 0b00000100) >> 2);  
-   gpio_set_level(segmento_D, (display & 0b00001000) >> 3);  
-
-   //Parte alta
-   gpio_set_level(segmento_C, (display & 0b00010000) >> 4);  
-   gpio_set_level(segmento_B, (display & 0b00100000) >> 5); 
-   gpio_set_level(segmento_A, (display & 0b01000000) >> 6);  
+// Muestra un dígito con dos escrituras: W1TC apaga todo el display y W1TS enciende catodo y segmentos
+void muestraDigito(uint8_t display, uint8_t numero){
+    GPIO.out_w1tc = mascaraDisplay;
+    GPIO.out_w1ts = mascaraCatodos[display] | seg7Fuente[SEG7_0 + numero].set0;
 }
 
+#if !MULTIPLEXADO_EN_ISR
 void task_core_1(void *pvParameters) {   
+    uint32_t ultimaGeneracion = generacionContador - 1;
     while (1) {
-        decodifica_Numero(contador, &centenas, &decenas, &unidades);
+        // Solo se vuelve a decodificar cuando el ISR publicó un valor nuevo
+        uint32_t generacion = generacionContador;
+        if (generacion != ultimaGeneracion) {
+            decodifica_BCD(contador, &centenas, &decenas, &unidades);
+            ultimaGeneracion = generacion;
+        }
         if(activacionDisplays == 0) { 
-            gpio_set_level(pin_catodo_displayUnidades, 1);   
-            gpio_set_level(pin_catodo_displayDecenas, 0);
-            gpio_set_level(pin_catodo_displayCentenas, 0);
-            //Apagar los segmentos
-            decodificaSegmentos(numerosCodifiados[11]);        
-
-            decodificaSegmentos(numerosCodifiados[unidades]);        
+            muestraDigito(0, unidades);
         }
         else if(activacionDisplays == 1){  
-            gpio_set_level(pin_catodo_displayUnidades, 0);   
-            gpio_set_level(pin_catodo_displayDecenas, 1);   
-            gpio_set_level(pin_catodo_displayCentenas, 0);
-            //Apagar los segmentos
-            decodificaSegmentos(numerosCodifiados[11]);  
-
-            decodificaSegmentos(numerosCodifiados[decenas]);         
+            muestraDigito(1, decenas);
         }
         else if(activacionDisplays == 2){
-            gpio_set_level(pin_catodo_displayUnidades, 0);   
-            gpio_set_level(pin_catodo_displayDecenas, 0);   
-            gpio_set_level(pin_catodo_displayCentenas, 1);
-            //Apagar los segmentos
-            decodificaSegmentos(numerosCodifiados[11]);  
-
-            decodificaSegmentos(numerosCodifiados[centenas]);     
+            muestraDigito(2, centenas);
         }
         //printf("Ejecutando en Core 1\n");
         //vTaskDelay(pdMS_TO_TICKS(1000)); // Espera de 1 segundo
     }
 }
+#endif
 
 
 
 
 void app_main(void) {
+#if !MULTIPLEXADO_EN_ISR
+    // task_core_1 nunca cede el core 1, sin esto el watchdog se dispara
     esp_task_wdt_deinit();
+#endif
 
     gpio_reset_pin(pin_catodo_displayUnidades);
     gpio_reset_pin(pin_catodo_displayDecenas);
@@ -153,72 +221,28 @@ void app_main(void) {
     gpio_set_direction(segmento_F, GPIO_MODE_OUTPUT);
     gpio_set_direction(segmento_G, GPIO_MODE_OUTPUT);
 
+    actualizaFrame(contador);
 
     printf("Iniciando programa en ESP32-S3 con FreeRTOS\n");
 
-     // Configuración del timer
-     gptimer_handle_t gptimer = NULL;
-     gptimer_config_t timer_config = {
-         .clk_src = GPTIMER_CLK_SRC_DEFAULT,  // Fuente de reloj por defecto (APB o XTAL)
-         .direction = GPTIMER_COUNT_UP,  // Contar hacia arriba
-         .resolution_hz = 1000000,  // Configurar a 1 MHz para contar en microsegundos
-     };
-     ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &gptimer));  // Crear un nuevo timer con la configuración
- 
-     // Configurar la alarma del timer
-     gptimer_alarm_config_t alarm_config = {
-         .alarm_count = intervaloTimer_us,  // 100 microsegundos
-         .flags.auto_reload_on_alarm = true,  // Recargar automáticamente la alarma
-     };
-     ESP_ERROR_CHECK(gptimer_set_alarm_action(gptimer, &alarm_config));
- 
-     // Registrar la función ISR para la alarma del timer
-     gptimer_event_callbacks_t cbs = {
-         .on_alarm = on_timer_alarm,  // Llamar a la función on_timer_alarm al activarse la alarma
-     };
-     ESP_ERROR_CHECK(gptimer_register_event_callbacks(gptimer, &cbs, NULL));
- 
-     // Iniciar el timer
-     ESP_ERROR_CHECK(gptimer_enable(gptimer));  // Habilitar el timer
-     ESP_ERROR_CHECK(gptimer_start(gptimer));   // Iniciar el timer
-
-
-      // Configuración del segundo timer
-    gptimer_handle_t gptimer2 = NULL;
-    gptimer_config_t timer2_config = {
-        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
-        .direction = GPTIMER_COUNT_UP,
-        .resolution_hz = 1000000,  // 1 MHz para contar en microsegundos
-    };
-    ESP_ERROR_CHECK(gptimer_new_timer(&timer2_config, &gptimer2));  // Crear el segundo timer
-
-    // Configurar la alarma del segundo timer
-    gptimer_alarm_config_t alarm2_config = {
-        .alarm_count = intervaloTimer2_us,  // 1 segundo en microsegundos
-        .flags.auto_reload_on_alarm = true,
-    };
-    ESP_ERROR_CHECK(gptimer_set_alarm_action(gptimer2, &alarm2_config));
-
-    // Registrar la función ISR para el segundo timer
-    gptimer_event_callbacks_t cbs2 = {
-        .on_alarm = on_timer2_alarm,
-    };
-    ESP_ERROR_CHECK(gptimer_register_event_callbacks(gptimer2, &cbs2, NULL));
-
-    // Iniciar el segundo timer
-    ESP_ERROR_CHECK(gptimer_enable(gptimer2));
-    ESP_ERROR_CHECK(gptimer_start(gptimer2));
+    // Un solo gptimer para los dos trabajos, los dos se atienden en su ISR
+    ESP_ERROR_CHECK(timersSoft_iniciar());
+    timerSoft_crear(&timerMultiplexado, on_timer_alarm, NULL, TIMER_SOFT_ISR);
+    timerSoft_armar(&timerMultiplexado, 1, 1);
+    timerSoft_crear(&timerContador, on_timer2_alarm, NULL, TIMER_SOFT_ISR);
+    timerSoft_armar(&timerContador, intervaloTimer2_us / intervaloTimer_us, intervaloTimer2_us / intervaloTimer_us);
     
     xTaskCreatePinnedToCore(
         task_core_0,   // Función de la tarea
         "TaskCore0",   // Nombre de la tarea
-        2048,          // Tamaño del stack en bytes
+        4096,          // Tamaño del stack en bytes: printf con flotantes y la copia de un perfilISR_t
         NULL,          // Parámetro de entrada
         1,             // Prioridad de la tarea
         NULL,          // Handle de la tarea
         0              // Núcleo en el que se ejecutará
     );
 
+#if !MULTIPLEXADO_EN_ISR
     xTaskCreatePinnedToCore(
         task_core_1,   // Función de la tarea
         "TaskCore1",   // Nombre de la tarea
@@ -228,5 +252,5 @@ void app_main(void) {
         NULL,          // Handle de la tarea
         1              // Núcleo en el que se ejecutará
     );
-}
-
+#endif
+}
\ No newline at end of file
@@ -5,8 +5,10 @@
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "driver/gptimer.h"
+#include "soc/gpio_struct.h"
 #include "esp_task_wdt.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include <unistd.h>
 
 
@@ -22,12 +24,28 @@
 #define COL3 36
 #define COL4 35
 
+// Filas y columnas están en el banco 1 de GPIO (32-48): bit = pin - 32
+#define BIT_BANCO1(pin) (1UL << ((pin) - 32))
+#define MASCARA_COLUMNAS (BIT_BANCO1(COL1) | BIT_BANCO1(COL2) | BIT_BANCO1(COL3) | BIT_BANCO1(COL4))
+#define MASCARA_FILAS (BIT_BANCO1(ROW1) | BIT_BANCO1(ROW2) | BIT_BANCO1(ROW3) | BIT_BANCO1(ROW4))
+
+// Escaneo: cada tick del timer lee las filas de una columna y activa la siguiente
+#define periodoEscaneo_us (1000)
+#define teclasColumna0 0x1111     // Bits de las 4 teclas de la columna 0 (bit = fila * 4 + columna)
+#define tamColaEventos 32         // Potencia de 2
+
+// Reposo: sin teclas, todas las columnas en bajo y las filas esperan un flanco.
+// El escaneo solo corre mientras hay actividad (0 = escanear siempre)
+#define REPOSO_TECLADO 1
+#define tiempoQuieto_ms 200       // Tiempo sin ninguna tecla para volver al reposo
+#define ticksQuieto (tiempoQuieto_ms * 1000 / periodoEscaneo_us)
+#define periodoReporte_ms 10000
+
 //Pines del display
 #define pin_catodo_displayUnidades 12
 #define pin_catodo_displayDecenas  9 
 #define pin_catodo_displayCentenas 8
 #define intervaloTimer_us (2000)
-#define intervaloTimer2_us (100000)
 
 #define segmento_A 4
 #define segmento_B 5
@@ -37,30 +55,27 @@
 #define segmento_F 16
 #define segmento_G 17
 
-#define cero    0x7E
-#define uno     0x30
-#define dos     0x6D
-#define tres    0x79
-#define cuatro  0x33
-#define cinco   0x5B
-#define seis    0x5F
-#define siete   0x70
-#define ocho    0x7f
-#define nueve   0x7b
-#define todosApagados   0x00
-
-// Mapeo de caracteres del teclado a valores del display
-#define A 0x77  // Representación de 'A' en el display
-#define B 0x7F  // Representación de 'B' (similar a '8')
-#define C 0x4E  // Representación de 'C'
-#define D 0x3D  // Representación de 'D'
-#define E 0x4F  // Representación de 'E'
-#define F 0x47  // Representación de 'F'
-#define asterisco 0x01  // Representación de '-' en el display
-
-uint8_t numerosCodifiados[16] = {
-    cero, uno, dos, tres, cuatro, cinco, seis, siete, ocho, nueve, A, B, C, D, E, F
+// Fuente común de 7 segmentos con el mapa de pines de esta placa
+#define SEG7_PINES segmento_A, segmento_B, segmento_C, segmento_D, segmento_E, segmento_F, segmento_G
+#include "Fuente7Seg.h"
+#include "Teclado4x4.h"
+#include "EventosGPIO.h"
+#include "Antirrebote32.h"
+
+// El multiplexado del display es un timer por software: la rueda da un tick por
+// display (intervaloTimer_us), la misma tasa que el gptimer que tenía antes. El
+// escaneo conserva su propio gptimer, que se detiene en reposo; en la rueda, su
+// tick de 1 ms seguiría corriendo por el display
+#define TIMERS_SOFT_TICK_US intervaloTimer_us
+#include "TimersSoft.h"
+#include "PerfilISR.h"
+
+// Máscaras de los catodos y de todo el display, calculadas por el compilador
+const uint32_t mascaraCatodos[3] = {
+    SEG7_BIT0(pin_catodo_displayUnidades), SEG7_BIT0(pin_catodo_displayDecenas), SEG7_BIT0(pin_catodo_displayCentenas)
 };
+#define mascaraDisplay (SEG7_SEGMENTOS0 | SEG7_BIT0(pin_catodo_displayUnidades) | \
+                        SEG7_BIT0(pin_catodo_displayDecenas) | SEG7_BIT0(pin_catodo_displayCentenas))
 //PARTE DE LOS DISPLAYS
 
  uint8_t unidades = 0;
@@ -73,81 +88,62 @@ volatile int activacionDisplays = 0;
 volatile char tecla = '-';  // Declaración de la bandera para el primer pin
 volatile bool teclaPresionada = false;
 
-static bool IRAM_ATTR on_timer3_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
+timerSoft_t timerDisplays;
+
+// Retraso y duración de las ISR: el fantasma del display y las lecturas falsas
+// del teclado dependen de que entren a tiempo
+perfilISR_t perfilDisplays = PERFIL_ISR_INICIAL("displays", intervaloTimer_us);
+perfilISR_t perfilEscaneo = PERFIL_ISR_INICIAL("escaneo", periodoEscaneo_us);
+
+static bool IRAM_ATTR on_timer3_alarm(void *arg) {
+    PERFIL_ISR_ENTRADA(&perfilDisplays);
     activacionDisplays++;
     if(activacionDisplays >= 3){
         activacionDisplays = 0;
     }
-    return true;
+    PERFIL_ISR_SALIDA(&perfilDisplays);
+    return false;
 }
 
 
 
-void decodificaSegmentos(uint8_t display){
-    //Parte baja
-   gpio_set_level(segmento_G, (display & 0b00000001) >> 0);  
-   gpio_set_level(segmento_F, (display & 0b00000010) >> 1);  
-   gpio_set_level(segmento_E, (display & 0b00000100) >> 2);  
-   gpio_set_level(segmento_D, (display & 0b00001000) >> 3);  
-
-   //Parte alta
-   gpio_set_level(segmento_C, (display & 0b00010000) >> 4);  
-   gpio_set_level(segmento_B, (display & 0b00100000) >> 5); 
-   gpio_set_level(segmento_A, (display & 0b01000000) >> 6);  
+// Muestra un carácter con dos escrituras: W1TC apaga todo el display y W1TS enciende catodo y segmentos
+void muestraDigito(uint8_t display, uint8_t indice){
+    GPIO.out_w1tc = mascaraDisplay;
+    GPIO.out_w1ts = mascaraCatodos[display] | seg7Fuente[indice].set0;
 }
 
 
 void task_core_1(void *pvParameters) {   
-    uint8_t valorDisplay = asterisco;  // Valor inicial del display (asterisco)
+    uint8_t indiceDisplay = SEG7_GUION;  // Valor inicial del display (asterisco)
     
     while (1) {
         // Decodificar el número o carácter actual
         if (teclaPresionada) {
             teclaPresionada = false;
 
-            // Convertir la tecla presionada al valor del display
-            if (tecla >= '0' && tecla <= '9') {
-                valorDisplay = numerosCodifiados[tecla - '0'];  // Convertir dígito
-                printf("Tecla presionada: %c\n", tecla);
-            } else if (tecla == 'A') {
-                valorDisplay = A;
-                printf("Tecla presionada: %c\n", tecla);
-            } else if (tecla == 'B') {
-                valorDisplay = B;
-                printf("Tecla presionada: %c\n", tecla);
-            } else if (tecla == 'C') {
-                valorDisplay = C;
-                printf("Tecla presionada: %c\n", tecla);
-            } else if (tecla == 'D') {
-                valorDisplay = D;
+            // Convertir la tecla presionada al índice de la fuente
+            if ((tecla >= '0' && tecla <= '9') || (tecla >= 'A' && tecla <= 'D')) {
+                indiceDisplay = seg7_indice(tecla);
                 printf("Tecla presionada: %c\n", tecla);
             } else if (tecla == '*') {
-                valorDisplay = asterisco;  // Mostrar - para '*'
+                indiceDisplay = SEG7_GUION;  // Mostrar - para '*'
                 printf("Tecla presionada: %c\n", tecla);
             } else if (tecla == '#') {
-                valorDisplay = todosApagados;  // Apagar el display para '#'
+                indiceDisplay = SEG7_APAGADO;  // Apagar el display para '#'
                 printf("Tecla presionada: %c\n", tecla);
             } else {
-                valorDisplay = asterisco;  // Valor por defecto
+                indiceDisplay = SEG7_GUION;  // Valor por defecto
             }
         }
 
         // Multiplexar el display
         if (activacionDisplays == 0) { 
-            gpio_set_level(pin_catodo_displayUnidades, 1);   
-            gpio_set_level(pin_catodo_displayDecenas, 0);
-            gpio_set_level(pin_catodo_displayCentenas, 0);
-            decodificaSegmentos(valorDisplay);        
+            muestraDigito(0, indiceDisplay);
         } else if (activacionDisplays == 1) {  
-            gpio_set_level(pin_catodo_displayUnidades, 0);   
-            gpio_set_level(pin_catodo_displayDecenas, 1);   
-            gpio_set_level(pin_catodo_displayCentenas, 0);
-            decodificaSegmentos(valorDisplay);         
+            muestraDigito(1, indiceDisplay);
         } else if (activacionDisplays == 2) {
-            gpio_set_level(pin_catodo_displayUnidades, 0);   
-            gpio_set_level(pin_catodo_displayDecenas, 0);   
-            gpio_set_level(pin_catodo_displayCentenas, 1);
-            decodificaSegmentos(valorDisplay);     
+            muestraDigito(2, indiceDisplay);
         }
     }
 }
@@ -158,7 +154,39 @@ volatile int tiempoRetardo = 10;
 
 uint8_t columnas[4] = {COL1, COL2, COL3, COL4};
 uint8_t filas[4] = {ROW1,ROW2,ROW3,ROW4};
-volatile uint8_t columnaSeleccionada = -1;
+volatile uint8_t columnaSeleccionada = 0;
+
+const uint32_t mascaraColumna[4] = {BIT_BANCO1(COL1), BIT_BANCO1(COL2), BIT_BANCO1(COL3), BIT_BANCO1(COL4)};
+const uint32_t mascaraFila[4] = {BIT_BANCO1(ROW1), BIT_BANCO1(ROW2), BIT_BANCO1(ROW3), BIT_BANCO1(ROW4)};
+
+// Antirrebote de las 16 teclas con contadores verticales: una tecla cambia después
+// de 4 muestras seguidas diferentes (una muestra cada 4 ms por tecla)
+antirrebote32_t antirreboteTeclas;
+uint16_t teclasPresionadas = 0;  // Mapa aceptado en el último barrido completo
+bool fantasmaActivo = false;
+
+// Evento de teclado: todos los cambios de un barrido juntos, con marca de tiempo
+typedef struct {
+    int64_t tiempo_us;
+    uint16_t presionadas;
+    uint16_t liberadas;
+    uint16_t estado;
+    bool fantasma;
+} eventoTecla_t;
+
+// Cola sin bloqueos de un productor (ISR del escaneo) y un consumidor (app_main)
+eventoTecla_t colaEventos[tamColaEventos];
+volatile uint32_t indiceEscritura = 0;  // Solo lo cambia el ISR
+volatile uint32_t indiceLectura = 0;    // Solo lo cambia el consumidor
+volatile uint32_t eventosPerdidos = 0;
+
+// Modo reposo del teclado y contadores de despertares para comparar los dos modos
+gptimer_handle_t timerEscaneo = NULL;
+volatile bool tecladoEnReposo = false;
+volatile uint32_t ticksEscaneo = 0;       // Interrupciones del gptimer del escaneo: cada una despierta al CPU
+volatile uint32_t despertaresFilas = 0;   // Flancos de fila que sacaron al teclado del reposo
+colaEventosGPIO_t flancosFilas;           // Flancos de las filas, los guarda la ISR única de GPIO
+uint32_t ticksSinTeclas = 0;
 
 
 // Mapa del teclado 4x4
@@ -173,59 +201,113 @@ static const char *TAG = "Teclado4x4:";
 
 
 
-static bool IRAM_ATTR on_timer_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
-    columnaSeleccionada++;
-    if(columnaSeleccionada > 3) columnaSeleccionada = -1;
-    
-     if(columnaSeleccionada == 0){
-        gpio_set_level(COL1, 0);
-        gpio_set_level(COL2, 1);
-        gpio_set_level(COL3, 1);
-        gpio_set_level(COL4, 1);
+static inline void IRAM_ATTR encolarEvento(const teclado4x4Cambios_t *cambios, int64_t tiempo) {
+    uint32_t escritura = indiceEscritura;
+    if (escritura - __atomic_load_n(&indiceLectura, __ATOMIC_ACQUIRE) >= tamColaEventos) {
+        eventosPerdidos++;  // Cola llena
+        return;
     }
-    else if(columnaSeleccionada == 1){
-        gpio_set_level(COL1, 1);
-        gpio_set_level(COL2, 0);
-        gpio_set_level(COL3, 1);
-        gpio_set_level(COL4, 1);
-    }
-    else if(columnaSeleccionada == 2){
-        gpio_set_level(COL1, 1);
-        gpio_set_level(COL2, 1);
-        gpio_set_level(COL3, 0);
-        gpio_set_level(COL4, 1);
-    }
-    else if(columnaSeleccionada == 3){
-        gpio_set_level(COL1, 1);
-        gpio_set_level(COL2, 1);
-        gpio_set_level(COL3, 1);
-        gpio_set_level(COL4, 0);
-    }
-    return true;
+    eventoTecla_t *evento = &colaEventos[escritura & (tamColaEventos - 1)];
+    evento->tiempo_us = tiempo;
+    evento->presionadas = cambios->presionadas;
+    evento->liberadas = cambios->liberadas;
+    evento->estado = cambios->estado;
+    evento->fantasma = cambios->fantasma;
+    __atomic_store_n(&indiceEscritura, escritura + 1, __ATOMIC_RELEASE);
 }
 
-static void IRAM_ATTR funcionInterrupcion1(void *arg) {
-    tecla = mapaTeclado[0][columnaSeleccionada];
-    teclaPresionada = true;
+bool sacarEvento(eventoTecla_t *evento) {
+    uint32_t lectura = indiceLectura;
+    if (lectura == __atomic_load_n(&indiceEscritura, __ATOMIC_ACQUIRE)) return false;
+    *evento = colaEventos[lectura & (tamColaEventos - 1)];
+    __atomic_store_n(&indiceLectura, lectura + 1, __ATOMIC_RELEASE);
+    return true;
 }
 
-// Manejador de interrupción para el segundo pin
-static void IRAM_ATTR funcionInterrupcion2(void *arg) {
-    tecla = mapaTeclado[1][columnaSeleccionada];
-    teclaPresionada = true;
+// Arranca el escaneo desde la primera columna con el timer a cero
+static void IRAM_ATTR iniciarEscaneo(void) {
+    tecladoEnReposo = false;
+    ticksSinTeclas = 0;
+    GPIO.out1_w1ts.val = MASCARA_COLUMNAS;
+    GPIO.out1_w1tc.val = mascaraColumna[0];
+    columnaSeleccionada = 0;
+    gptimer_set_raw_count(timerEscaneo, 0);
+    gptimer_start(timerEscaneo);
 }
 
-// Manejador de interrupción para el tercer pin
-static void IRAM_ATTR funcionInterrupcion3(void *arg) {
-     tecla = mapaTeclado[2][columnaSeleccionada];
-    teclaPresionada = true;
+// Aviso de la ISR de las filas en reposo: la primera tecla despierta al escaneo
+static bool IRAM_ATTR despertarTeclado(void) {
+    for (int i = 0; i < 4; i++) {
+        gpio_intr_disable(filas[i]);
+    }
+    if (tecladoEnReposo) {
+        despertaresFilas++;
+        iniciarEscaneo();
+    }
+    return false;
 }
-static void IRAM_ATTR funcionInterrupcion4(void *arg) {
-     tecla = mapaTeclado[3][columnaSeleccionada];
-    teclaPresionada = true;
+
+// Todas las columnas en bajo: cualquier tecla baja su fila y genera un flanco.
+// El timer ya debe estar detenido
+static void IRAM_ATTR entrarReposo(void) {
+    PERFIL_ISR_PAUSA(&perfilEscaneo);   // El hueco del reposo no es jitter
+    GPIO.out1_w1tc.val = MASCARA_COLUMNAS;
+    tecladoEnReposo = true;
+    for (int i = 0; i < 4; i++) {
+        gpio_intr_enable(filas[i]);
+    }
+    // Una tecla que ya estaba abajo no genera flanco, hay que seguir escaneando
+    if ((GPIO.in1.val & MASCARA_FILAS) != MASCARA_FILAS) {
+        despertarTeclado();
+    }
 }
 
+// Todo el teclado se atiende aquí: lee las filas de la columna activa (ya estable
+// desde el tick anterior), filtra cada tecla y luego activa la siguiente columna.
+// Al terminar la última columna compara el mapa completo con el anterior
+static bool IRAM_ATTR on_timer_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
+    PERFIL_ISR_ENTRADA(&perfilEscaneo);
+    uint8_t columna = columnaSeleccionada;
+    uint32_t entradas = GPIO.in1.val;
+    ticksEscaneo++;
+
+    // Las cuatro filas de la columna activa se filtran juntas, las demás teclas no se tocan
+    uint16_t leidas = 0;
+    for (int fila = 0; fila < 4; fila++) {
+        if ((entradas & mascaraFila[fila]) == 0) {
+            leidas |= 1 << (fila * 4 + columna);
+        }
+    }
+    antirrebote32_muestra(&antirreboteTeclas, leidas, teclasColumna0 << columna);
+
+    if (columna == 3) {
+        teclado4x4Cambios_t cambios = teclado4x4_diferencia(teclasPresionadas, antirreboteTeclas.estado);
+        if (cambios.presionadas || cambios.liberadas || cambios.fantasma != fantasmaActivo) {
+            encolarEvento(&cambios, esp_timer_get_time());
+        }
+        teclasPresionadas = cambios.estado;
+        fantasmaActivo = cambios.fantasma;
+    }
 
+#if REPOSO_TECLADO
+    // Después de tiempoQuieto_ms sin ninguna tecla, apagar el escaneo
+    if (antirrebote32_ocupadas(&antirreboteTeclas) || antirreboteTeclas.estado || teclasPresionadas) {
+        ticksSinTeclas = 0;
+    } else if (++ticksSinTeclas >= ticksQuieto) {
+        gptimer_stop(timerEscaneo);
+        PERFIL_ISR_SALIDA(&perfilEscaneo);
+        entrarReposo();
+        return false;
+    }
+#endif
+
+    columna = (columna + 1) & 3;
+    GPIO.out1_w1ts.val = MASCARA_COLUMNAS;
+    GPIO.out1_w1tc.val = mascaraColumna[columna];
+    columnaSeleccionada = columna;
+    PERFIL_ISR_SALIDA(&perfilEscaneo);
+    return false;
+}
 
 void configurarTeclado(){
     //Configurar como salida a las columnas.
@@ -236,31 +318,21 @@ void configurarTeclado(){
         gpio_set_level(columnas[i],1);
     }
 
-    gpio_reset_pin(ROW1);
-    gpio_set_direction(ROW1, GPIO_MODE_INPUT);
-    gpio_set_intr_type(ROW1, GPIO_INTR_NEGEDGE);  // Interrupción en flanco de bajada
-
-    gpio_reset_pin(ROW2);
-    gpio_set_direction(ROW2, GPIO_MODE_INPUT);
-    gpio_set_intr_type(ROW2, GPIO_INTR_NEGEDGE);  // Interrupción en flanco de bajada
-
-    gpio_reset_pin(ROW3);
-    gpio_set_direction(ROW3, GPIO_MODE_INPUT);
-    gpio_set_intr_type(ROW3, GPIO_INTR_NEGEDGE);  // Interrupción en flanco de bajada
-
-    gpio_reset_pin(ROW4);
-    gpio_set_direction(ROW4, GPIO_MODE_INPUT);
-    gpio_set_intr_type(ROW4, GPIO_INTR_NEGEDGE);  // Interrupción en flanco de bajada
-
-    // Instalación del servicio ISR
-    gpio_install_isr_service(0);
-    
-    // Asignar manejadores de interrupciones a cada pin
-    gpio_isr_handler_add(ROW1, funcionInterrupcion1, NULL);
-    gpio_isr_handler_add(ROW2, funcionInterrupcion2, NULL);
-    gpio_isr_handler_add(ROW3, funcionInterrupcion3, NULL);
-    gpio_isr_handler_add(ROW4, funcionInterrupcion4, NULL);
+    // Filas como entradas con pull-up: las lee el ISR del escaneo y, en reposo,
+    // cualquier flanco lo despierta
+    for(int i = 0; i<4; i++){
+        gpio_reset_pin(filas[i]);
+        gpio_set_direction(filas[i], GPIO_MODE_INPUT);
+        gpio_set_pull_mode(filas[i], GPIO_PULLUP_ONLY);
+        gpio_set_intr_type(filas[i], GPIO_INTR_ANYEDGE);
+        gpio_intr_disable(filas[i]);
+    }
+    // Una sola ISR para las cuatro filas
+    eventosGPIO_instalar(&flancosFilas, (1ULL << ROW1) | (1ULL << ROW2) | (1ULL << ROW3) | (1ULL << ROW4),
+                         despertarTeclado);
 
+    // La primera columna queda activa para el primer tick
+    gpio_set_level(columnas[0], 0);
 }
 //Maquinas de estado FSM (Finite State Machine)
 void rotaBit(uint8_t estadoActual){
@@ -281,31 +353,41 @@ int8_t leerFilas(){
 
 void configurarTimer(){
       // Configuración del timer
-    gptimer_handle_t gptimer = NULL;
     gptimer_config_t timer_config = {
         .clk_src = GPTIMER_CLK_SRC_DEFAULT,  // Fuente de reloj por defecto (APB o XTAL)
         .direction = GPTIMER_COUNT_UP,  // Contar hacia arriba
         .resolution_hz = 1000000,  // Configurar a 1 MHz para contar en microsegundos
     };
-    gptimer_new_timer(&timer_config, &gptimer);  // Crear un nuevo timer con la configuración
+    gptimer_new_timer(&timer_config, &timerEscaneo);  // Crear un nuevo timer con la configuración
 
     // Configurar la alarma del timer
     gptimer_alarm_config_t alarm_config = {
-        .alarm_count = 50000,  // 1 segundo en microsegundos
+        .alarm_count = periodoEscaneo_us,  // Una columna por tick
         .reload_count = 0,  // Reiniciar el contador a 0 después de alcanzar la alarma
         .flags.auto_reload_on_alarm = true,  // Recargar automáticamente la alarma
     };
-    gptimer_set_alarm_action(gptimer, &alarm_config);
+    gptimer_set_alarm_action(timerEscaneo, &alarm_config);
 
     // Registrar la función ISR para la alarma del timer
     gptimer_event_callbacks_t cbs = {
         .on_alarm = on_timer_alarm,  // Llamar a la función on_timer_alarm al activarse la alarma
     };
-    gptimer_register_event_callbacks(gptimer, &cbs, NULL);
+    gptimer_register_event_callbacks(timerEscaneo, &cbs, NULL);
+
+    gptimer_enable(timerEscaneo);  // Habilitar el timer
+#if REPOSO_TECLADO
+    entrarReposo();                // El escaneo arranca con la primera tecla
+#else
+    gptimer_start(timerEscaneo);   // Iniciar el timer
+#endif
+}
 
-    // Iniciar el timer
-    gptimer_enable(gptimer);  // Habilitar el timer
-    gptimer_start(gptimer);   // Iniciar el timer
+// Rotación de displays en cada tick de la rueda (intervaloTimer_us); el
+// antiguo gptimer2 corría sin callback y ya no se crea
+void configurarDisplays(){
+    ESP_ERROR_CHECK(timersSoft_iniciar());
+    timerSoft_crear(&timerDisplays, on_timer3_alarm, NULL, TIMER_SOFT_ISR);
+    timerSoft_armar(&timerDisplays, 1, 1);
 }
 
 void app_main() {
@@ -338,52 +420,7 @@ void app_main() {
 
     printf("Iniciando programa en ESP32-S3 con FreeRTOS\n");
 
-     // Configuración del timer
-     gptimer_handle_t gptimer = NULL;
-     gptimer_config_t timer_config = {
-         .clk_src = GPTIMER_CLK_SRC_DEFAULT,  // Fuente de reloj por defecto (APB o XTAL)
-         .direction = GPTIMER_COUNT_UP,  // Contar hacia arriba
-         .resolution_hz = 1000000,  // Configurar a 1 MHz para contar en microsegundos
-     };
-     ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &gptimer));  // Crear un nuevo timer con la configuración
- 
-     // Configurar la alarma del timer
-     gptimer_alarm_config_t alarm_config = {
-         .alarm_count = intervaloTimer_us,  // 100 microsegundos
-         .flags.auto_reload_on_alarm = true,  // Recargar automáticamente la alarma
-     };
-     ESP_ERROR_CHECK(gptimer_set_alarm_action(gptimer, &alarm_config));
- 
-     // Registrar la función ISR para la alarma del timer
-     gptimer_event_callbacks_t cbs = {
-         .on_alarm = on_timer3_alarm,  // Llamar a la función on_timer_alarm al activarse la alarma
-     };
-     ESP_ERROR_CHECK(gptimer_register_event_callbacks(gptimer, &cbs, NULL));
- 
-     // Iniciar el timer
-     ESP_ERROR_CHECK(gptimer_enable(gptimer));  // Habilitar el timer
-     ESP_ERROR_CHECK(gptimer_start(gptimer));   // Iniciar el timer
-
-
-      // Configuración del segundo timer
-    gptimer_handle_t gptimer2 = NULL;
-    gptimer_config_t timer2_config = {
-        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
-        .direction = GPTIMER_COUNT_UP,
-        .resolution_hz = 1000000,  // 1 MHz para contar en microsegundos
-    };
-    ESP_ERROR_CHECK(gptimer_new_timer(&timer2_config, &gptimer2));  // Crear el segundo timer
-
-    // Configurar la alarma del segundo timer
-    gptimer_alarm_config_t alarm2_config = {
-        .alarm_count = intervaloTimer2_us,  // 1 segundo en microsegundos
-        .flags.auto_reload_on_alarm = true,
-    };
-    ESP_ERROR_CHECK(gptimer_set_alarm_action(gptimer2, &alarm2_config));
-
-    // Iniciar el segundo timer
-    ESP_ERROR_CHECK(gptimer_enable(gptimer2));
-    ESP_ERROR_CHECK(gptimer_start(gptimer2));
+    configurarDisplays();
     
     xTaskCreatePinnedToCore(
         task_core_1,   // Función de la tarea
@@ -396,10 +433,58 @@ void app_main() {
     );
 
 
+    eventoTecla_t evento;
+    const char *teclas = &mapaTeclado[0][0];  // Las 16 teclas en orden de bit
+    char texto[17];
+    uint32_t ticksAnterior = 0, displayAnterior = 0, filasAnterior = 0;
+    uint32_t ciclosReporte = 0;
+    eventoGPIO_t flancos[8];
+    uint32_t flancosRegistrados = 0;  // Flancos de fila (con rebotes) que atendió la ISR única
     while (true) {
-        if (teclaPresionada) {
-            ESP_LOGI(TAG, "Tecla presionada: %c", tecla);
-            teclaPresionada = false;
+        // Único consumidor de la cola de eventos del teclado
+        while (sacarEvento(&evento)) {
+            if (evento.presionadas) {
+                teclado4x4_texto(evento.presionadas, teclas, texto);
+                ESP_LOGI(TAG, "Presionadas: %s (%lld us)", texto, (long long)evento.tiempo_us);
+                tecla = teclas[__builtin_ctz(evento.presionadas)];
+                teclaPresionada = true;  // Aviso para el display
+            }
+            if (evento.liberadas) {
+                teclado4x4_texto(evento.liberadas, teclas, texto);
+                ESP_LOGI(TAG, "Liberadas: %s (%lld us)", texto, (long long)evento.tiempo_us);
+            }
+            if (evento.fantasma) {
+                teclado4x4_texto(evento.estado, teclas, texto);
+                ESP_LOGW(TAG, "Combinación ambigua, se retienen teclas nuevas (aceptadas: %s)", texto);
+            }
+        }
+
+        int n;
+        while ((n = eventosGPIO_sacar(&flancosFilas, flancos, 8)) > 0) {
+            flancosRegistrados += n;
+        }
+
+        // Interrupciones que despertaron al CPU, extrapoladas a una hora para comparar
+        // reposo y escaneo continuo: las del gptimer del escaneo, los ticks de la
+        // rueda del display y los flancos de fila en reposo
+        if (++ciclosReporte * tiempoRetardo >= periodoReporte_ms) {
+            uint32_t ticks = ticksEscaneo, display = timersSoft.ticks, despertares = despertaresFilas;
+            uint32_t total = (ticks - ticksAnterior) + (display - displayAnterior) + (despertares - filasAnterior);
+            uint64_t porHora = (uint64_t)total * 3600000 / (ciclosReporte * tiempoRetardo);
+            ESP_LOGI(TAG, "Despertares: %llu/h (%lu del escaneo, %lu del display, %lu flancos en reposo)%s",
+                     (unsigned long long)porHora, (unsigned long)(ticks - ticksAnterior),
+                     (unsigned long)(display - displayAnterior), (unsigned long)(despertares - filasAnterior),
+                     tecladoEnReposo ? ", en reposo" : "");
+            ESP_LOGI(TAG, "Flancos de fila: %lu registrados, %lu perdidos",
+                     (unsigned long)flancosRegistrados, (unsigned long)flancosFilas.perdidos);
+            perfilISR_imprimir(&perfilEscaneo);
+            perfilISR_imprimir(&perfilDisplays);
+            perfilISR_imprimir(&flancosFilas.perfil);
+            flancosRegistrados = 0;
+            ticksAnterior = ticks;
+            displayAnterior = display;
+            filasAnterior = despertares;
+            ciclosReporte = 0;
         }
         vTaskDelay(pdMS_TO_TICKS(tiempoRetardo));        
     }
@@ -8,6 +8,8 @@
 #include "freertos/queue.h"
 #include "esp_task_wdt.h"
 #include "driver/timer.h"
+#include "driver/gptimer.h"
+#include "soc/gpio_struct.h"
 
 // Pines de los displays de 7 segmentos
 #define SEG_A 4
@@ -38,26 +40,77 @@
 // Pin del LED Alarma
 #define LED_ALARMA 21
 
+// Refresco del display: 1 ms por dígito = 333 Hz por dígito, sin importar el muestreo
+#define INTERVALO_REFRESCO_US 1000
+#define PERIODO_MUESTREO_MS 100
+
+// Teclado: barrido cada 10 ms mientras hay actividad; después de TECLADO_QUIETO_MS
+// sin teclas queda en reposo hasta un flanco en las filas (0 = barrer siempre)
+#define REPOSO_TECLADO 1
+#define PERIODO_TECLADO_MS 10
+#define TECLADO_QUIETO_MS 200
+
+// Autorrepetición de la tecla sostenida (la última que se presionó)
+#define REPETICION_RETARDO_MS 500   // Tiempo sostenida antes de la primera repetición
+#define REPETICION_PERIODO_MS 100   // Después, una repetición cada 100 ms
+
 float tempo = 0.0; // Variable para almacenar la temperatura actual
 
 // Variables globales
 volatile float temperatura = 0.0;  // Temperatura actual
 volatile bool mostrarCelsius = true;  // Modo de temperatura (Celsius o Fahrenheit)
-QueueHandle_t colaTeclado;  // Cola para manejar las teclas presionadas
-
-// Mapeo de números a segmentos del display
-const uint8_t numerosCodificados[10] = {
-    0b0111111,  // 0
-    0b0000110,  // 1
-    0b1011011,  // 2
-    0b1001111,  // 3
-    0b1100110,  // 4
-    0b1101101,  // 5
-    0b1111101,  // 6
-    0b0000111,  // 7
-    0b1111111,  // 8
-    0b1101111   // 9
-};
+QueueHandle_t colaTeclado;  // Cola de cambios del teclado (teclado4x4Cambios_t)
+
+// Fuente común de 7 segmentos con el mapa de pines de esta placa
+#define SEG7_PINES SEG_A, SEG_B, SEG_C, SEG_D, SEG_E, SEG_F, SEG_G
+#include "Fuente7Seg.h"
+#include "Teclado4x4.h"
+#include "Antirrebote32.h"
+
+// Máscaras de los catodos y de todo el display, calculadas por el compilador
+const uint32_t mascaraCatodos[3] = {SEG7_BIT0(CATODO_UNIDADES), SEG7_BIT0(CATODO_DECENAS), SEG7_BIT0(CATODO_CENTENAS)};
+#define MASCARA_DISPLAY (SEG7_SEGMENTOS0 | SEG7_BIT0(CATODO_UNIDADES) | SEG7_BIT0(CATODO_DECENAS) | SEG7_BIT0(CATODO_CENTENAS))
+
+// Frame publicado para el refresco: dos buffers, el ISR lee el activo y
+// task_temperatura escribe el otro antes de intercambiarlos
+volatile uint32_t framesDisplay[2][3];
+volatile uint8_t frameActivo = 0;
+volatile uint8_t digitoActivo = 0;
+volatile uint32_t contadorRefrescos = 0;
+
+// ISR del timer de refresco: apaga el display y enciende el siguiente dígito del frame activo
+static bool IRAM_ATTR refrescarDisplay(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
+    uint8_t digito = digitoActivo;
+    GPIO.out_w1tc = MASCARA_DISPLAY;
+    GPIO.out_w1ts = framesDisplay[frameActivo][digito];
+    digitoActivo = (digito + 1) % 3;
+    contadorRefrescos++;
+    return false;
+}
+
+// Configurar el timer que refresca el display en segundo plano
+void configurarRefresco() {
+    gptimer_handle_t gptimer = NULL;
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,  // 1 MHz para contar en microsegundos
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &gptimer));
+
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = INTERVALO_REFRESCO_US,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(gptimer, &alarm_config));
+
+    gptimer_event_callbacks_t cbs = {
+        .on_alarm = refrescarDisplay,
+    };
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(gptimer, &cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_enable(gptimer));
+    ESP_ERROR_CHECK(gptimer_start(gptimer));
+}
 
 // Configuración de pines GPIO
 void configurarGPIO() {
@@ -103,63 +156,155 @@ float leerTemperatura() {
     vTaskDelay(pdMS_TO_TICKS(100));  // Esperar un poco antes de la siguiente lectura
 }
 
-// Decodificar y mostrar un número en los displays
+// Publicar un número en el display, el refresco lo hace el timer en segundo plano
 void mostrarNumero(int numero) {
-    int unidades = numero % 10;
-    int decenas = (numero / 10) % 10;
-    int centenas = (numero / 100) % 10;
+    if (numero < 0) numero = 0;  // El display no tiene signo
+    uint8_t siguiente = frameActivo ^ 1;
+    framesDisplay[siguiente][0] = mascaraCatodos[0] | seg7Fuente[SEG7_0 + numero % 10].set0;
+    framesDisplay[siguiente][1] = mascaraCatodos[1] | seg7Fuente[SEG7_0 + (numero / 10) % 10].set0;
+    framesDisplay[siguiente][2] = mascaraCatodos[2] | seg7Fuente[SEG7_0 + (numero / 100) % 10].set0;
+    frameActivo = siguiente;
+}
 
-    uint8_t pinesCatodos[] = {CATODO_UNIDADES, CATODO_DECENAS, CATODO_CENTENAS};
-    int valores[] = {unidades, decenas, centenas};
+// Teclas en orden de bit del mapa (bit = fila * 4 + columna)
+const char mapaTeclado[16] = {
+    '1', '2', '3', 'A',
+    '4', '5', '6', 'B',
+    '7', '8', '9', 'C',
+    '*', '0', '#', 'D'
+};
 
-    for (int i = 0; i < 3; i++) {
-        // Encender el catodo correspondiente
-        gpio_set_level(pinesCatodos[i], 1);
+TaskHandle_t tareaTeclado = NULL;
+volatile uint32_t barridosTeclado = 0;     // Despertares de task_teclado por su periodo
+volatile uint32_t despertaresTeclado = 0;  // Flancos de fila que lo sacaron del reposo
+volatile uint32_t teclasPerdidas = 0;      // Mensajes descartados con colaTeclado llena
+
+const uint8_t filasTeclado[4] = {FIL_1, FIL_2, FIL_3, FIL_4};
+
+// ISR de las filas en reposo: despierta a task_teclado con la primera tecla
+static void IRAM_ATTR despertarTeclado(void *arg) {
+    for (int i = 0; i < 4; i++) {
+        gpio_intr_disable(filasTeclado[i]);
+    }
+    despertaresTeclado++;
+    BaseType_t despertar = pdFALSE;
+    vTaskNotifyGiveFromISR(tareaTeclado, &despertar);
+    if (despertar == pdTRUE) portYIELD_FROM_ISR();
+}
+
+// Interrupciones de las filas para el reposo del teclado, deshabilitadas hasta usarlas
+void configurarReposoTeclado() {
+    gpio_install_isr_service(0);
+    for (int i = 0; i < 4; i++) {
+        gpio_set_intr_type(filasTeclado[i], GPIO_INTR_ANYEDGE);
+        gpio_isr_handler_add(filasTeclado[i], despertarTeclado, NULL);
+        gpio_intr_disable(filasTeclado[i]);
+    }
+}
 
-        // Decodificar el número y encender los segmentos
-        uint8_t segmentos = numerosCodificados[valores[i]];
-        gpio_set_level(SEG_A, segmentos & 0x01);
-        gpio_set_level(SEG_B, segmentos & 0x02);
-        gpio_set_level(SEG_C, segmentos & 0x04);
-        gpio_set_level(SEG_D, segmentos & 0x08);
-        gpio_set_level(SEG_E, segmentos & 0x10);
-        gpio_set_level(SEG_F, segmentos & 0x20);
-        gpio_set_level(SEG_G, segmentos & 0x40);
+// Reposo del teclado: todas las columnas en bajo y la tarea dormida hasta que
+// una fila cambie. Regresa con las columnas otra vez en alto
+void esperarTecla(const uint8_t columnas[4]) {
+    for (int col = 0; col < 4; col++) {
+        gpio_set_level(columnas[col], 0);
+    }
+    ulTaskNotifyTake(pdTRUE, 0);  // Descartar avisos viejos
+    for (int i = 0; i < 4; i++) {
+        gpio_intr_enable(filasTeclado[i]);
+    }
+
+    // Si ya hay una tecla abajo no llegará el flanco
+    bool filasEnAlto = true;
+    for (int i = 0; i < 4; i++) {
+        if (gpio_get_level(filasTeclado[i]) == 0) filasEnAlto = false;
+    }
+    if (filasEnAlto) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    } else {
+        for (int i = 0; i < 4; i++) {
+            gpio_intr_disable(filasTeclado[i]);
+        }
+    }
 
-        // Esperar un breve tiempo para multiplexar
-        vTaskDelay(pdMS_TO_TICKS(15));
+    for (int col = 0; col < 4; col++) {
+        gpio_set_level(columnas[col], 1);
+    }
+}
 
-        // Apagar el catodo
-        gpio_set_level(pinesCatodos[i], 0);
+// Entrega sin bloquear: si el consumidor va atrasado el mensaje se cuenta y se
+// descarta, el barrido nunca se detiene
+void enviarCambios(const teclado4x4Cambios_t *cambios) {
+    if (xQueueSend(colaTeclado, cambios, 0) != pdTRUE) {
+        teclasPerdidas++;
     }
 }
 
-// Tarea para manejar el teclado matricial
+// Tarea para manejar el teclado matricial: cada barrido lee las 16 teclas y
+// manda en un solo mensaje todas las que cambiaron, así se pueden combinar
 void task_teclado(void *pvParameters) {
     uint8_t columnas[] = {COL_1, COL_2, COL_3, COL_4};
     uint8_t filas[] = {FIL_1, FIL_2, FIL_3, FIL_4};
-    char mapaTeclado[4][4] = {
-        {'1', '2', '3', 'A'},
-        {'4', '5', '6', 'B'},
-        {'7', '8', '9', 'C'},
-        {'*', '0', '#', 'D'}
-    };
+    antirrebote32_t antirrebote = {0};
+    uint16_t teclasPresionadas = 0;
+    bool fantasmaActivo = false;
+    int barridosSinTeclas = 0;
+    uint16_t teclaRepetida = 0;       // Bit de la tecla que se autorrepite (0 = ninguna)
+    TickType_t siguienteRepeticion = 0;
+    TickType_t ultimoBarrido = xTaskGetTickCount();
 
     while (1) {
+        barridosTeclado++;
+        uint16_t lectura = 0;
         for (int col = 0; col < 4; col++) {
             gpio_set_level(columnas[col], 0);  // Activar columna
             for (int fila = 0; fila < 4; fila++) {
-                if (gpio_get_level(filas[fila]) == 0) {  // Detectar tecla presionada
-                    char tecla = mapaTeclado[fila][col];
-                    xQueueSend(colaTeclado, &tecla, portMAX_DELAY);
-                    while (gpio_get_level(filas[fila]) == 0) {
-                        vTaskDelay(pdMS_TO_TICKS(10));  // Esperar a que se suelte
-                    }
+                if (gpio_get_level(filas[fila]) == 0) {
+                    lectura |= 1 << (fila * 4 + col);
                 }
             }
             gpio_set_level(columnas[col], 1);  // Desactivar columna
         }
-        vTaskDelay(pdMS_TO_TICKS(10));
+
+        // Antirrebote de las 16 teclas a la vez: una tecla cambia después de 4 barridos
+        // seguidos diferentes; el mapa filtrado se compara solo cuando algo cambió
+        if (antirrebote32_muestra(&antirrebote, lectura, 0xFFFF)) {
+            teclado4x4Cambios_t cambios = teclado4x4_diferencia(teclasPresionadas, antirrebote.estado);
+            if (cambios.presionadas || cambios.liberadas || cambios.fantasma != fantasmaActivo) {
+                enviarCambios(&cambios);
+            }
+            if (cambios.presionadas) {
+                teclaRepetida = cambios.presionadas & -cambios.presionadas;
+                siguienteRepeticion = xTaskGetTickCount() + pdMS_TO_TICKS(REPETICION_RETARDO_MS);
+            }
+            teclasPresionadas = cambios.estado;
+            fantasmaActivo = cambios.fantasma;
+        }
+
+        // Autorrepetición: la tecla sostenida se vuelve a mandar como presionada
+        if (!(teclasPresionadas & teclaRepetida)) {
+            teclaRepetida = 0;
+        } else if ((int32_t)(xTaskGetTickCount() - siguienteRepeticion) >= 0) {
+            teclado4x4Cambios_t repeticion = {
+                .presionadas = teclaRepetida,
+                .estado = teclasPresionadas,
+                .fantasma = fantasmaActivo,
+            };
+            enviarCambios(&repeticion);
+            siguienteRepeticion += pdMS_TO_TICKS(REPETICION_PERIODO_MS);
+        }
+
+#if REPOSO_TECLADO
+        if (lectura || antirrebote.estado || antirrebote32_ocupadas(&antirrebote)) {
+            barridosSinTeclas = 0;
+        } else if (++barridosSinTeclas >= TECLADO_QUIETO_MS / PERIODO_TECLADO_MS) {
+            esperarTecla(columnas);
+            barridosSinTeclas = 0;
+            ultimoBarrido = xTaskGetTickCount();
+            continue;  // Barrer de inmediato la tecla que despertó
+        }
+#endif
+        // Periodo fijo aunque el barrido o la entrega tarden distinto
+        vTaskDelayUntil(&ultimoBarrido, pdMS_TO_TICKS(PERIODO_TECLADO_MS));
     }
 }
 
@@ -168,27 +313,56 @@ void task_temperatura(void *pvParameters) {
     while (1) {
         temperatura = leerTemperatura();  // Leer temperatura del LM35
         int tempMostrar = (int)(mostrarCelsius ? temperatura : (temperatura * 9.0 / 5.0) + 32.0);
-        mostrarNumero(tempMostrar);  // Mostrar temperatura en el display
+        mostrarNumero(tempMostrar);  // Publicar temperatura para el display
         tempo = tempMostrar;  // Guardar temperatura para la alarma
+        vTaskDelay(pdMS_TO_TICKS(PERIODO_MUESTREO_MS));
     }
 }
 
 // Tarea para manejar las teclas presionadas
 void task_manejar_teclas(void *pvParameters) {
-    char tecla;
+    teclado4x4Cambios_t cambios;
+    char texto[17];
     while (1) {
-        if (xQueueReceive(colaTeclado, &tecla, portMAX_DELAY)) {
-            if (tecla == '1') {
-                mostrarCelsius = true;  // Cambiar a Celsius
-            } else if (tecla == '2') {
-                mostrarCelsius = false;  // Cambiar a Fahrenheit
+        if (xQueueReceive(colaTeclado, &cambios, portMAX_DELAY)) {
+            if (cambios.fantasma) {
+                printf("Combinación ambigua en el teclado, se ignoran teclas nuevas\n");
+            }
+            // Todas las teclas nuevas del barrido, en orden
+            int n = teclado4x4_texto(cambios.presionadas, mapaTeclado, texto);
+            for (int i = 0; i < n; i++) {
+                if (texto[i] == '1') {
+                    mostrarCelsius = true;  // Cambiar a Celsius
+                } else if (texto[i] == '2') {
+                    mostrarCelsius = false;  // Cambiar a Fahrenheit
+                }
             }
         }
     }
 }
 
 void task_alarma(void *pvParameters) {
+    uint32_t refrescosAnterior = contadorRefrescos;
+    uint32_t barridosAnterior = 0, despertaresAnterior = 0;
+    int segundos = 0;
     while (1) {
+        // Despertares del teclado por hora, medidos cada minuto
+        if (++segundos == 60) {
+            uint32_t barridos = barridosTeclado, despertares = despertaresTeclado;
+            printf("Teclado: %lu despertares/h (%lu barridos, %lu flancos en reposo), %lu mensajes perdidos\n",
+                   (unsigned long)((barridos - barridosAnterior + despertares - despertaresAnterior) * 60),
+                   (unsigned long)(barridos - barridosAnterior), (unsigned long)(despertares - despertaresAnterior),
+                   (unsigned long)teclasPerdidas);
+            barridosAnterior = barridos;
+            despertaresAnterior = despertares;
+            segundos = 0;
+        }
+
+        // Frecuencia de refresco por dígito en el último segundo
+        uint32_t refrescos = contadorRefrescos;
+        printf("Refresco por dígito: %lu Hz\n", (unsigned long)((refrescos - refrescosAnterior) / 3));
+        refrescosAnterior = refrescos;
+
         int limiteTemperatura = mostrarCelsius ? 37 : 98.6;  // Limite de temperatura en Celsius o Fahrenheit
         if (tempo > limiteTemperatura) {
             gpio_set_level(LED_ALARMA, 1);  // Encender LED de alarma si la temperatura es alta
@@ -203,13 +377,16 @@ void task_alarma(void *pvParameters) {
 void app_main() {
     esp_task_wdt_deinit();
     configurarGPIO();
+    configurarReposoTeclado();
+    mostrarNumero(0);
+    configurarRefresco();
 
     // Configurar ADC para el LM35
     adc1_config_width(ADC_WIDTH_BIT_12);
     adc1_config_channel_atten(LM35_ADC_CHANNEL, ADC_ATTEN_DB_11);
 
     // Crear cola para el teclado
-    colaTeclado = xQueueCreate(10, sizeof(char));
+    colaTeclado = xQueueCreate(10, sizeof(teclado4x4Cambios_t));
 
     //Para el LED de alarma
     gpio_reset_pin(LED_ALARMA);
@@ -221,7 +398,7 @@ void app_main() {
     }
 
     // Crear tareas
-    xTaskCreate(task_teclado, "Teclado", 2048, NULL, 1, NULL);
+    xTaskCreate(task_teclado, "Teclado", 2048, NULL, 1, &tareaTeclado);
     xTaskCreate(task_temperatura, "Temperatura", 2048, NULL, 1, NULL);
     xTaskCreate(task_manejar_teclas, "ManejarTeclas", 2048, NULL, 1, NULL);
     xTaskCreate(task_alarma, "Alarma", 2048, NULL, 1, NULL);
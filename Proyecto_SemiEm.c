@@ -2,17 +2,26 @@
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "driver/gpio.h"
 #include "driver/i2c.h"
 #include "esp_timer.h"
 #include "esp_task_wdt.h"
+#include "soc/gpio_struct.h"
 
-// Segmentos de GPIO
-const gpio_num_t segment_pins[7] = {4, 5, 6, 7, 15, 16, 17};
+// 1: el periférico LCD_CAM saca el frame completo por DMA circular, sin usar el CPU
+// 0: la tarea MultiDisplays multiplexa con escrituras W1TS/W1TC
+#define REFRESCO_DMA 1
+
+// Segmentos de GPIO, de A a G. La fuente común de 7 segmentos toma el mismo mapa
+#define SEG7_PINES 4, 5, 6, 7, 15, 16, 17
+const gpio_num_t segment_pins[7] = {SEG7_PINES};
 
 // Para los transistores
 const gpio_num_t digit_pins[6] = {36, 48, 21, 8, 9, 12};
 
+#include "Fuente7Seg.h"
+
 // Configuración del I2C
 #define I2C_MASTER_NUM         I2C_NUM_0
 #define I2C_MASTER_SDA_IO      42
@@ -23,32 +32,63 @@ const gpio_num_t digit_pins[6] = {36, 48, 21, 8, 9, 12};
 // Para el Botón
 #define BUTTON_PIN 40
 
-// Para el antirrebote
-#define DEBOUNCE_TIME_MS 200
-
-// Números en hexadecimal para los displays
-const uint8_t digit_to_segments[10] = {
-    0x3F, // 0
-    0x06, // 1
-    0x5B, // 2
-    0x4F, // 3
-    0x66, // 4
-    0x6D, // 5
-    0x7D, // 6
-    0x07, // 7
-    0x7F, // 8
-    0x6F  // 9
-};
-
-uint8_t display_chars[6] = {0};
+// Para el antirrebote: el flanco arma un timer de una sola vez que confirma el nivel
+#define DEBOUNCE_TIME_MS 30
+#define LONG_PRESS_MS    1000   // Pulsación larga: entrar/salir del modo de ajuste
+
+// Frame DMA (DisplayDMA.h): 1271 ciclos con las sincronías, 12.7 ms (79 Hz).
+// Las sincronías se llevan menos del 6% del tiempo
+#define DMA_PCLK_HZ          100000
+#define DMA_MUESTRAS_LINEA   40     // h_res: 0.4 ms por línea a 100 kHz
+#define DMA_LINEAS_DIGITO    5      // 2 ms por display
+#define DMA_MUESTRAS_APAGADO 4      // Todo apagado al cambiar de display, evita el ghosting
+#if REFRESCO_DMA
+#include "DisplayDMA.h"
+#endif
+
+// Máscaras precalculadas para los registros W1TS/W1TC
+// Banco 0 = GPIO 0-31 (GPIO.out_*), banco 1 = GPIO 32-48 (GPIO.out1_*)
+uint32_t digit_pin_masks0[6];
+uint32_t digit_pin_masks1[6];
+uint32_t display_off_mask0 = 0;
+uint32_t display_off_mask1 = 0;
+
+// Máscara de segmentos de cada display, lista para escribirse
+volatile uint32_t display_chars[6] = {0};
 volatile bool show_time = true;
-int64_t last_button_press_time = 0;
+volatile bool modo_ajuste = false;
+
+// Botón: sin tareas periódicas, solo la ISR del flanco y dos timers de una vez
+typedef enum { BOTON_CORTO, BOTON_LARGO } evento_boton_t;
+QueueHandle_t cola_boton;
+esp_timer_handle_t timer_confirmar;
+esp_timer_handle_t timer_larga;
+bool boton_presionado = false;   // Solo lo tocan los callbacks de esp_timer
+bool larga_emitida = false;
 
 // Convertir BCD a Decimal
 uint8_t bcd_a_dec(uint8_t val) {
     return ((val / 16 * 10) + (val % 16));
 }
 
+// Máscara del banco correspondiente para un pin
+uint32_t pin_mask(gpio_num_t pin, int bank) {
+    if (bank == 0)
+        return (pin < 32) ? (1UL << pin) : 0;
+    return (pin >= 32) ? (1UL << (pin - 32)) : 0;
+}
+
+// Precalcular las máscaras de cada transistor
+void init_masks() {
+    display_off_mask0 = SEG7_SEGMENTOS0;
+    for (int i = 0; i < 6; i++) {
+        digit_pin_masks0[i] = pin_mask(digit_pins[i], 0);
+        digit_pin_masks1[i] = pin_mask(digit_pins[i], 1);
+        display_off_mask0 |= digit_pin_masks0[i];
+        display_off_mask1 |= digit_pin_masks1[i];
+    }
+}
+
 // Inicializar puertos
 void init_gpio() {
     gpio_config_t io_conf = {
@@ -70,6 +110,61 @@ void init_gpio() {
     gpio_pullup_en(BUTTON_PIN);
 }
 
+// Flanco del botón: se ignora el resto del rebote y se confirma después
+static void IRAM_ATTR boton_isr(void *arg) {
+    gpio_intr_disable(BUTTON_PIN);
+    esp_timer_start_once(timer_confirmar, DEBOUNCE_TIME_MS * 1000);
+}
+
+// Ya pasó el rebote: el nivel decide si fue presión, liberación o ruido
+void confirmar_boton(void *arg) {
+    int level = gpio_get_level(BUTTON_PIN);
+
+    if (!boton_presionado && level == 0) {
+        boton_presionado = true;
+        larga_emitida = false;
+        esp_timer_start_once(timer_larga, LONG_PRESS_MS * 1000);
+        gpio_set_intr_type(BUTTON_PIN, GPIO_INTR_POSEDGE);   // Ahora esperar la liberación
+    } else if (boton_presionado && level == 1) {
+        boton_presionado = false;
+        esp_timer_stop(timer_larga);
+        if (!larga_emitida) {
+            evento_boton_t evento = BOTON_CORTO;
+            xQueueSend(cola_boton, &evento, 0);
+        }
+        gpio_set_intr_type(BUTTON_PIN, GPIO_INTR_NEGEDGE);
+    }
+    gpio_intr_enable(BUTTON_PIN);
+
+    // Si el nivel cambió mientras la interrupción estaba apagada no habrá flanco
+    if (gpio_get_level(BUTTON_PIN) == (boton_presionado ? 1 : 0)) {
+        gpio_intr_disable(BUTTON_PIN);
+        esp_timer_start_once(timer_confirmar, DEBOUNCE_TIME_MS * 1000);
+    }
+}
+
+// Sigue presionado después de LONG_PRESS_MS: pulsación larga, la liberación ya no cuenta
+void pulsacion_larga(void *arg) {
+    if (boton_presionado) {
+        larga_emitida = true;
+        evento_boton_t evento = BOTON_LARGO;
+        xQueueSend(cola_boton, &evento, 0);
+    }
+}
+
+void init_boton() {
+    cola_boton = xQueueCreate(4, sizeof(evento_boton_t));
+
+    esp_timer_create_args_t confirmar = {.callback = confirmar_boton, .name = "boton"};
+    esp_timer_create(&confirmar, &timer_confirmar);
+    esp_timer_create_args_t larga = {.callback = pulsacion_larga, .name = "boton_largo"};
+    esp_timer_create(&larga, &timer_larga);
+
+    gpio_set_intr_type(BUTTON_PIN, GPIO_INTR_NEGEDGE);
+    gpio_install_isr_service(0);
+    gpio_isr_handler_add(BUTTON_PIN, boton_isr, NULL);
+}
+
 // Inicializar I2C
 void i2c_master_init() {
     i2c_config_t conf = {
@@ -107,6 +202,19 @@ void read_ds3231(uint8_t *hours, uint8_t *minutes, uint8_t *seconds,
     *year    =bcd_a_dec(data[6]);
 }
 
+// Escribir los minutos en el DS3231 y reiniciar los segundos
+void write_ds3231_minutes(uint8_t minutes) {
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (DS3231_ADDR << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_write_byte(cmd, 0x00, true); // Registro de segundos, luego minutos
+    i2c_master_write_byte(cmd, 0x00, true);
+    i2c_master_write_byte(cmd, ((minutes / 10) << 4) | (minutes % 10), true);
+    i2c_master_stop(cmd);
+    i2c_master_cmd_begin(I2C_MASTER_NUM, cmd, pdMS_TO_TICKS(1000));
+    i2c_cmd_link_delete(cmd);
+}
+
 // Actualizar el display cada vez que pasa un segundo
 void MostrarHoraFecha() {
     uint8_t h, m, s, d, mo, y;
@@ -130,50 +238,58 @@ void MostrarHoraFecha() {
         digits[5] = y % 10;
     }
 
+#if REFRESCO_DMA
+    uint8_t indices[6];
     for (int i = 0; i < 6; i++) {
-        display_chars[i] = digit_to_segments[digits[i]];
+        indices[i] = SEG7_0 + digits[i];
     }
-}
-
-// Para el multiplexado
-void ConfigurarMulti() {
+    displayDMA_publicar(indices);
+#else
     for (int i = 0; i < 6; i++) {
-        gpio_set_level(digit_pins[i], 0);
+        display_chars[i] = seg7Fuente[SEG7_0 + digits[i]].set0;
     }
+#endif
 }
 
-// Para mostrar números en los displays
-void MostrarNumero(uint8_t value) {
-    for (int i = 0; i < 7; i++) {
-        gpio_set_level(segment_pins[i], (value >> i) & 0x01);
-    }
+// Mostrar un display: apagar todo (W1TC) y encender segmentos y transistor juntos (W1TS)
+void MostrarDigito(int i) {
+    GPIO.out_w1tc = display_off_mask0;
+    GPIO.out1_w1tc.val = display_off_mask1;
+    GPIO.out_w1ts = display_chars[i] | digit_pin_masks0[i];
+    if (digit_pin_masks1[i])
+        GPIO.out1_w1ts.val = digit_pin_masks1[i];
 }
 
 // Multiplexar los displays
 void MultiDisplays(void *pvParameters) {
     while (1) {
         for (int i = 0; i < 6; i++) {
-            ConfigurarMulti();
-            MostrarNumero(display_chars[i]);
-            gpio_set_level(digit_pins[i], 1);
+            MostrarDigito(i);
             vTaskDelay(pdMS_TO_TICKS(2));
         }
     }
 }
 
-// Chequeo de botón con protección contra rebote
+// Eventos del botón: corto cambia hora/fecha, largo entra o sale del modo de ajuste.
+// En ajuste cada pulsación corta suma un minuto. Duerme hasta que llega un evento
 void TareaBoton(void *pvParameters) {
+    evento_boton_t evento;
     while (1) {
-        int level = gpio_get_level(BUTTON_PIN);
-        int64_t current_time = esp_timer_get_time() / 1000; // Convert to milliseconds
-
-        if (level == 0 && (current_time - last_button_press_time) > DEBOUNCE_TIME_MS) { // Button pressed
-            last_button_press_time = current_time; // Update the last press time
+        xQueueReceive(cola_boton, &evento, portMAX_DELAY);
+
+        if (evento == BOTON_LARGO) {
+            modo_ajuste = !modo_ajuste;
+            show_time = true;
+            printf("Long press, modo_ajuste: %d\n", modo_ajuste);
+        } else if (modo_ajuste) {
+            uint8_t h, m, s, d, mo, y;
+            read_ds3231(&h, &m, &s, &d, &mo, &y);
+            write_ds3231_minutes((m + 1) % 60);
+            printf("Minutes set to %02d\n", (m + 1) % 60);
+        } else {
             show_time = !show_time; // Toggle the display mode
             printf("Button pressed, show_time: %d\n", show_time);
         }
-
-        vTaskDelay(pdMS_TO_TICKS(10)); // Small delay to avoid excessive CPU usage
     }
 }
 
@@ -201,12 +317,20 @@ void app_main() {
     // Quitar el watchdog del task
     esp_task_wdt_deinit();
     init_gpio();
+    init_boton();
+#if REFRESCO_DMA
+    displayDMA_iniciar(segment_pins, digit_pins);
+#else
+    init_masks();
+#endif
     i2c_master_init();
 
     MostrarHoraFecha();
 
     // Crear tareas
+#if !REFRESCO_DMA
     xTaskCreatePinnedToCore(MultiDisplays, "MultiDisplays", 2048, NULL, 5, NULL, 1);
+#endif
     xTaskCreate(TareaBoton, "TareaBoton", 2048, NULL, 5, NULL);
     xTaskCreate(LeerFechaHora, "LeerFechaHora", 2048, NULL, 5, NULL);
 
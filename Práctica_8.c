@@ -3,23 +3,62 @@
 #include "freertos/task.h"
 #include "driver/gpio.h"
 #include "esp_task_wdt.h"
+#include "soc/gpio_struct.h"
 
+// 1: el periférico LCD_CAM saca el frame completo por DMA circular, sin usar el CPU
+// 0: la tarea MostrarNumero multiplexa con escrituras W1TS/W1TC
+#define REFRESCO_DMA 1
 
-// Pins de los segmentos de los displays
-const gpio_num_t DisplayPins[7] = {4, 5, 6, 7, 15, 16, 17};
+// Pins de los segmentos de los displays, de A a G. La fuente común de 7
+// segmentos toma el mismo mapa para sus máscaras
+#define SEG7_PINES 4, 5, 6, 7, 15, 16, 17
+const gpio_num_t DisplayPins[7] = {SEG7_PINES};
 
 // Pins de los transistores de los displays
 const gpio_num_t TransPins[6] = {36, 48, 21, 8, 9, 12};
 
-// Codificación de los caracteres a mostrar en el display 7 segmentos
-const uint8_t Letras[6] = {
-    0x1E, // J
-    0x79, // E
-    0x6D, // S
-    0x3E, // U
-    0x6D, // S
-    0x66  // 4
-};
+#include "Fuente7Seg.h"
+
+// Caracteres a mostrar en el display 7 segmentos
+const uint8_t Letras[6] = {SEG7_J, SEG7_E, SEG7_S, SEG7_U, SEG7_S, SEG7_4};
+
+// Frame DMA (DisplayDMA.h): 1581 ciclos con las sincronías, 31.6 ms
+#define DMA_PCLK_HZ          50000
+#define DMA_MUESTRAS_LINEA   50     // h_res: 1 ms por línea a 50 kHz
+#define DMA_LINEAS_DIGITO    5      // 5 ms por display
+#define DMA_MUESTRAS_APAGADO 2      // Todo apagado al cambiar de display, evita el ghosting
+#if REFRESCO_DMA
+#include "DisplayDMA.h"
+#endif
+
+#if !REFRESCO_DMA
+// Máscaras precalculadas para los registros W1TS/W1TC
+// Banco 0 = GPIO 0-31 (GPIO.out_*), banco 1 = GPIO 32-48 (GPIO.out1_*)
+uint32_t MascaraTrans0[6];
+uint32_t MascaraTrans1[6];
+uint32_t MascaraApagar0 = 0;
+uint32_t MascaraApagar1 = 0;
+
+// Máscara del banco correspondiente para un pin
+uint32_t MascaraPin(gpio_num_t pin, int banco)
+{
+    if (banco == 0)
+        return (pin < 32) ? (1UL << pin) : 0;
+    return (pin >= 32) ? (1UL << (pin - 32)) : 0;
+}
+
+// Calcula una sola vez las máscaras de cada transistor
+void PrecalculaMascaras()
+{
+    for (int i = 0; i < 6; i++) {
+        MascaraTrans0[i] = MascaraPin(TransPins[i], 0);
+        MascaraTrans1[i] = MascaraPin(TransPins[i], 1);
+        MascaraApagar0 |= MascaraTrans0[i];
+        MascaraApagar1 |= MascaraTrans1[i];
+    }
+    MascaraApagar0 |= SEG7_SEGMENTOS0;
+}
+#endif
 
 void init_gpio()
 {
@@ -42,22 +81,16 @@ void init_gpio()
     gpio_config(&io_conf);
 }
 
-// Para decodificar el valor hexadecimal a los segmentos del display
-void DecodificaSegmentos(uint8_t hex_value)
-{
-    for (int i = 0; i < 7; i++) {
-        // Extract each bit from the hex value and set the corresponding segment
-        gpio_set_level(DisplayPins[i], (hex_value >> i) & 0x01);
-    }
-}
-
-// Para el multiplexado de los displays
-// Se apagan todos los transistores
-void MultiPins()
+#if !REFRESCO_DMA
+// Para mostrar un caracter completo: primero se apaga todo (W1TC) y luego
+// se encienden los segmentos y el transistor juntos (W1TS), sin glifos a medias
+void MostrarDigito(int i)
 {
-    for (int i = 0; i < 6; i++) {
-        gpio_set_level(TransPins[i], 0);
-    }
+    GPIO.out_w1tc = MascaraApagar0;
+    GPIO.out1_w1tc.val = MascaraApagar1;
+    GPIO.out_w1ts = seg7Fuente[Letras[i]].set0 | MascaraTrans0[i];
+    if (MascaraTrans1[i])
+        GPIO.out1_w1ts.val = MascaraTrans1[i];
 }
 
 // Visualización de los caracteres en el display
@@ -65,17 +98,22 @@ void MostrarNumero(void *pvParameters)
 {
     while (1) {
         for (int i = 0; i < 6; i++) {
-            MultiPins();
-            DecodificaSegmentos(Letras[i]);
-            gpio_set_level(TransPins[i], 1);
+            MostrarDigito(i);
             vTaskDelay(pdMS_TO_TICKS(5));     // El delay para el multiplexado
         }
     }
 }
+#endif
 
 void app_main(void)
 {
     esp_task_wdt_deinit(); // Delete the watchdog for this task
     init_gpio();
+#if REFRESCO_DMA
+    displayDMA_iniciar(DisplayPins, TransPins);
+    displayDMA_publicar(Letras);
+#else
+    PrecalculaMascaras();
     xTaskCreate(MostrarNumero, "MostrarNumero", 2048, NULL, 5, NULL);
+#endif
 }
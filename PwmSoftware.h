@@ -0,0 +1,209 @@
+#ifndef PWMSOFTWARE_H
+#define PWMSOFTWARE_H
+
+// PWM por software para muchos LEDs con un solo gptimer.
+//
+// Hasta 32 canales de 8 bits a 200 Hz en cualquier pin de salida. Al inicio de
+// cada periodo una sola escritura W1TS por banco enciende todos los canales, y
+// luego cada canal se apaga en su punto de comparación. Los puntos ya vienen
+// ordenados en un horario precalculado y los canales con el mismo ciclo de
+// trabajo comparten evento, así cada interrupción apaga varios pines con una
+// escritura W1TC por banco. Como mucho hay 33 interrupciones por periodo, sin
+// importar el número de canales.
+//
+// Los cambios de ciclo de trabajo arman un horario nuevo en un segundo búfer;
+// la ISR lo cambia por el activo solo al inicio de un periodo, así nunca sale
+// un periodo con la mitad de los canales viejos y la mitad nuevos.
+//
+//   const int pines[] = {4, 5, 6, 7};
+//   pwmSoft_iniciar(pines, 4);
+//   pwmSoft_ciclo(2, 128);      // Canal 2 a la mitad
+//   pwmSoft_publicar();         // Se aplica en el siguiente periodo
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "driver/gptimer.h"
+#include "soc/gpio_struct.h"
+#include "esp_attr.h"
+
+#define PWM_CANALES_MAX 32
+#define PWM_FRECUENCIA_HZ 200
+#define PWM_PERIODO_US (1000000 / PWM_FRECUENCIA_HZ)   // 5000 ticks de 1 us, 19.6 us por paso de 8 bits
+#define PWM_MAXIMO 255                                 // Ciclo 255 = siempre encendido
+#define PWM_MARGEN_US 4     // Eventos a menos de esto se atienden en la misma interrupción
+
+// Un punto de comparación: los canales que se apagan en ese instante, por banco
+typedef struct {
+    uint32_t tiempo;    // us desde el inicio del periodo
+    uint32_t apagar0, apagar1;
+} eventoPwm_t;
+
+typedef struct {
+    uint32_t encender0, encender1;   // Canales con ciclo > 0, al inicio del periodo
+    uint32_t apagar0, apagar1;       // Canales en 0: se apagan al inicio (por si venían encendidos)
+    int n;
+    eventoPwm_t eventos[PWM_CANALES_MAX];
+} horarioPwm_t;
+
+typedef struct {
+    int canales;
+    uint8_t pines[PWM_CANALES_MAX];
+    uint8_t ciclos[PWM_CANALES_MAX];
+    horarioPwm_t horarios[2];
+    volatile int activo;             // Horario que usa la ISR
+    volatile bool pendiente;         // El otro horario está listo para el siguiente periodo
+    int siguiente;                   // Índice del siguiente evento (n = fin del periodo)
+    uint64_t inicio;                 // Cuenta del timer al inicio del periodo actual
+    gptimer_handle_t timer;
+    volatile uint32_t periodos;      // Estadísticas
+    volatile uint32_t cambios;
+} pwmSoft_t;
+
+static pwmSoft_t pwmSoft;
+
+// Arma el horario de los ciclos de trabajo: ordena los canales por su punto de
+// apagado y junta los que coinciden. Función pura, sin hardware
+static inline void pwmSoft_construir(horarioPwm_t *h, const uint8_t *pines, const uint8_t *ciclos, int canales) {
+    uint8_t orden[PWM_CANALES_MAX];
+    int n = 0;
+    h->encender0 = h->encender1 = 0;
+    h->apagar0 = h->apagar1 = 0;
+
+    for (int k = 0; k < canales; k++) {
+        uint32_t bit0 = pines[k] < 32 ? 1UL << pines[k] : 0;
+        uint32_t bit1 = pines[k] < 32 ? 0 : 1UL << (pines[k] - 32);
+        if (ciclos[k] == 0) {
+            h->apagar0 |= bit0;
+            h->apagar1 |= bit1;
+            continue;
+        }
+        h->encender0 |= bit0;
+        h->encender1 |= bit1;
+        if (ciclos[k] == PWM_MAXIMO) continue;   // No se apaga en todo el periodo
+
+        // Inserción ordenada por ciclo de trabajo (32 canales como mucho)
+        int i = n++;
+        while (i > 0 && ciclos[orden[i - 1]] > ciclos[k]) {
+            orden[i] = orden[i - 1];
+            i--;
+        }
+        orden[i] = k;
+    }
+
+    h->n = 0;
+    for (int i = 0; i < n; i++) {
+        int k = orden[i];
+        uint32_t tiempo = (ciclos[k] * PWM_PERIODO_US + PWM_MAXIMO / 2) / PWM_MAXIMO;
+        if (h->n == 0 || h->eventos[h->n - 1].tiempo != tiempo) {
+            h->eventos[h->n++] = (eventoPwm_t){.tiempo = tiempo};
+        }
+        eventoPwm_t *e = &h->eventos[h->n - 1];
+        if (pines[k] < 32) {
+            e->apagar0 |= 1UL << pines[k];
+        } else {
+            e->apagar1 |= 1UL << (pines[k] - 32);
+        }
+    }
+}
+
+// Alarma del timer: atiende todos los eventos que ya vencieron y programa el siguiente.
+// El timer corre libre; las alarmas son absolutas para no acumular la latencia de la ISR
+static bool IRAM_ATTR pwmSoft_alarma(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
+    pwmSoft_t *p = &pwmSoft;
+    const horarioPwm_t *h = &p->horarios[p->activo];
+    uint64_t ahora = edata->count_value;
+
+    while (true) {
+        uint32_t tiempo = p->siguiente < h->n ? h->eventos[p->siguiente].tiempo : PWM_PERIODO_US;
+        if (p->inicio + tiempo > ahora + PWM_MARGEN_US) break;
+
+        if (p->siguiente < h->n) {
+            const eventoPwm_t *e = &h->eventos[p->siguiente++];
+            GPIO.out_w1tc = e->apagar0;
+            GPIO.out1_w1tc.val = e->apagar1;
+            continue;
+        }
+
+        // Inicio de periodo: aquí, y solo aquí, se toma el horario nuevo
+        p->inicio += PWM_PERIODO_US;
+        p->periodos++;
+        if (p->pendiente) {
+            p->activo ^= 1;
+            h = &p->horarios[p->activo];
+            __atomic_store_n(&p->pendiente, false, __ATOMIC_RELEASE);
+            p->cambios++;
+        }
+        GPIO.out_w1tc = h->apagar0;
+        GPIO.out1_w1tc.val = h->apagar1;
+        GPIO.out_w1ts = h->encender0;
+        GPIO.out1_w1ts.val = h->encender1;
+        p->siguiente = 0;
+    }
+
+    uint32_t tiempo = p->siguiente < h->n ? h->eventos[p->siguiente].tiempo : PWM_PERIODO_US;
+    gptimer_alarm_config_t alarma = {.alarm_count = p->inicio + tiempo};
+    gptimer_set_alarm_action(timer, &alarma);
+    return false;
+}
+
+// Cambia el ciclo de trabajo de un canal (0-255); no se ve hasta pwmSoft_publicar()
+static inline void pwmSoft_ciclo(int canal, uint8_t ciclo) {
+    pwmSoft.ciclos[canal] = ciclo;
+}
+
+// Arma el horario con los ciclos actuales en el búfer libre y lo entrega a la ISR.
+// Si el anterior todavía no se toma, espera al siguiente periodo (5 ms como mucho)
+static inline void pwmSoft_publicar(void) {
+    while (__atomic_load_n(&pwmSoft.pendiente, __ATOMIC_ACQUIRE)) {
+        vTaskDelay(1);
+    }
+    horarioPwm_t *libre = &pwmSoft.horarios[pwmSoft.activo ^ 1];
+    pwmSoft_construir(libre, pwmSoft.pines, pwmSoft.ciclos, pwmSoft.canales);
+    __atomic_store_n(&pwmSoft.pendiente, true, __ATOMIC_RELEASE);
+}
+
+// Configura los pines como salida (todos apagados) y arranca el timer a 1 MHz
+static inline esp_err_t pwmSoft_iniciar(const int pines[], int canales) {
+    if (canales > PWM_CANALES_MAX) canales = PWM_CANALES_MAX;
+    pwmSoft.canales = canales;
+    for (int k = 0; k < canales; k++) {
+        pwmSoft.pines[k] = pines[k];
+        pwmSoft.ciclos[k] = 0;
+        gpio_reset_pin(pines[k]);
+        gpio_set_direction(pines[k], GPIO_MODE_OUTPUT);
+        gpio_set_level(pines[k], 0);
+    }
+    pwmSoft_construir(&pwmSoft.horarios[0], pwmSoft.pines, pwmSoft.ciclos, canales);
+    pwmSoft.activo = 0;
+    pwmSoft.pendiente = false;
+    // El primer periodo sale todo apagado; el siguiente evento es su fin
+    pwmSoft.siguiente = pwmSoft.horarios[0].n;
+    pwmSoft.inicio = 0;
+
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,  // 1 MHz para contar en microsegundos
+    };
+    esp_err_t err = gptimer_new_timer(&timer_config, &pwmSoft.timer);
+    if (err != ESP_OK) return err;
+
+    // Sin recarga automática: el timer corre libre y cada alarma es absoluta
+    gptimer_alarm_config_t alarma = {.alarm_count = PWM_PERIODO_US};
+    err = gptimer_set_alarm_action(pwmSoft.timer, &alarma);
+    if (err != ESP_OK) return err;
+
+    gptimer_event_callbacks_t cbs = {
+        .on_alarm = pwmSoft_alarma,
+    };
+    err = gptimer_register_event_callbacks(pwmSoft.timer, &cbs, NULL);
+    if (err != ESP_OK) return err;
+    err = gptimer_enable(pwmSoft.timer);
+    if (err != ESP_OK) return err;
+    return gptimer_start(pwmSoft.timer);
+}
+
+#endif
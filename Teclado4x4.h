@@ -0,0 +1,67 @@
+#ifndef TECLADO4X4_H
+#define TECLADO4X4_H
+
+// Núcleo del teclado matricial 4x4, común a las prácticas 6 y 7.
+//
+// Cada barrido completo arma un mapa de 16 bits con todas las teclas que se
+// leyeron presionadas, bit k = fila * 4 + columna (el mismo orden que
+// mapaTeclado[fila][columna]). Comparando con el mapa anterior por XOR salen
+// de una vez todas las teclas que se presionaron y se soltaron, así se pueden
+// combinar teclas (por ejemplo '*' + un dígito) sin perder ninguna.
+//
+// Son funciones puras, sin GPIO ni estado: el barrido lo hace cada práctica.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TECLADO4X4_FILA(mapa, fila) (((mapa) >> ((fila) * 4)) & 0xF)
+
+// Cambios de un barrido al siguiente, un bit por tecla
+typedef struct {
+    uint16_t presionadas;   // Teclas nuevas
+    uint16_t liberadas;     // Teclas que se soltaron
+    uint16_t estado;        // Mapa aceptado (el "anterior" del siguiente barrido)
+    bool fantasma;          // El mapa leído es ambiguo
+} teclado4x4Cambios_t;
+
+// Sin diodos, tres esquinas de un rectángulo presionadas encienden la cuarta.
+// Por eso cualquier par de filas que comparta dos o más columnas es ambiguo:
+// no se sabe cuál de las cuatro esquinas es la tecla fantasma.
+static inline bool teclado4x4_fantasma(uint16_t mapa) {
+    for (int a = 0; a < 3; a++) {
+        for (int b = a + 1; b < 4; b++) {
+            uint8_t comunes = TECLADO4X4_FILA(mapa, a) & TECLADO4X4_FILA(mapa, b);
+            if (comunes & (comunes - 1)) return true;  // Más de un bit en común
+        }
+    }
+    return false;
+}
+
+// Compara el mapa leído con el aceptado en el barrido anterior.
+// Si el mapa leído es ambiguo se reportan las teclas que se soltaron, pero
+// las nuevas se retienen hasta que el patrón vuelva a ser claro.
+static inline teclado4x4Cambios_t teclado4x4_diferencia(uint16_t anterior, uint16_t leido) {
+    teclado4x4Cambios_t cambios;
+    cambios.fantasma = teclado4x4_fantasma(leido);
+    uint16_t aceptado = cambios.fantasma ? (anterior & leido) : leido;
+    uint16_t diferencia = anterior ^ aceptado;
+    cambios.presionadas = diferencia & aceptado;
+    cambios.liberadas = diferencia & anterior;
+    cambios.estado = aceptado;
+    return cambios;
+}
+
+// Escribe los caracteres de las teclas de un mapa ("*5", "12A", ...).
+// teclas: los 16 caracteres del teclado en orden de bit; texto: 17 bytes
+static inline int teclado4x4_texto(uint16_t mapa, const char *teclas, char *texto) {
+    int n = 0;
+    while (mapa) {
+        int k = __builtin_ctz(mapa);
+        texto[n++] = teclas[k];
+        mapa &= mapa - 1;
+    }
+    texto[n] = '\0';
+    return n;
+}
+
+#endif
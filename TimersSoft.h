@@ -0,0 +1,321 @@
+#ifndef TIMERSSOFT_H
+#define TIMERSSOFT_H
+
+// Timers por software sobre un solo gptimer, con una rueda de tiempo jerárquica.
+//
+// El gptimer da un tick fijo (TIMERS_SOFT_TICK_US) y cada tick avanza la rueda.
+// Los timers son nodos de listas doblemente enlazadas colgados de la casilla de
+// su vencimiento, así armar y cancelar cuestan lo mismo con 10 timers que con
+// 10000. La rueda tiene cuatro niveles: 256 casillas de un tick y tres niveles
+// de 64 casillas que cubren 2^14, 2^20 y 2^26 ticks; un retardo más largo se
+// queda en el último nivel y vuelve a bajar las veces que haga falta. Cuando el nivel 0 da la
+// vuelta, los timers de la siguiente casilla del nivel 1 bajan al nivel 0 (y así
+// con los demás), de modo que cada timer se mueve como mucho tres veces.
+//
+// Cada timer se atiende en la ISR del tick (para trabajo corto, como multiplexar
+// un display) o en la tarea de timers (para lo que puede bloquear o imprimir).
+// Cualquier número de trabajos periódicos cuesta una sola fuente de interrupción.
+// Sin timers armados el gptimer se detiene en el siguiente tick y
+// timerSoft_armar() lo vuelve a arrancar: una rueda vacía no despierta al CPU.
+// Armar desde una ISR arranca el gptimer desde la ISR, así que hace falta
+// CONFIG_GPTIMER_CTRL_FUNC_IN_IRAM.
+//
+//   #define TIMERS_SOFT_TICK_US 2000   // Opcional, antes de incluir
+//   #include "TimersSoft.h"
+//   timerSoft_t parpadeo;
+//   timersSoft_iniciar();
+//   timerSoft_crear(&parpadeo, parpadear, NULL, TIMER_SOFT_TAREA);
+//   timerSoft_armar(&parpadeo, TIMERS_SOFT_MS(500), TIMERS_SOFT_MS(500));
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+
+#ifndef TIMERS_SOFT_TICK_US
+#define TIMERS_SOFT_TICK_US 1000
+#endif
+#ifndef TIMERS_SOFT_COLA
+#define TIMERS_SOFT_COLA 32         // Disparos pendientes para la tarea
+#endif
+#define TIMERS_SOFT_MS(ms) (((ms) * 1000 + TIMERS_SOFT_TICK_US - 1) / TIMERS_SOFT_TICK_US)
+
+#define RUEDA_BITS0 8
+#define RUEDA_BITS 6
+#define RUEDA_CASILLAS0 (1 << RUEDA_BITS0)
+#define RUEDA_CASILLAS (1 << RUEDA_BITS)
+#define RUEDA_NIVELES 3             // Niveles de 64 casillas además del nivel 0
+#define RUEDA_MAXIMO ((1UL << (RUEDA_BITS0 + RUEDA_NIVELES * RUEDA_BITS)) - 1)
+
+typedef enum { TIMER_SOFT_ISR, TIMER_SOFT_TAREA } modoTimerSoft_t;
+
+// Igual que los callbacks del gptimer: en la ISR regresa true si despertó a una tarea
+typedef bool (*funcionTimerSoft_t)(void *arg);
+
+// Enlaces de las listas. Las cabezas de las casillas y los timers usan el mismo
+// tipo: si la cabeza fuera otro struct, el compilador podría suponer que
+// escribir en un timer no cambia la cabeza (aliasing estricto)
+typedef struct nodoTimer {
+    struct nodoTimer *siguiente, *anterior;
+} nodoTimer_t;
+
+// Cabeza de una lista circular
+typedef nodoTimer_t listaTimers_t;
+
+typedef struct timerSoft {
+    nodoTimer_t nodo;                         // Primero; siguiente = NULL: no está armado
+    uint32_t vence;                           // Tick absoluto
+    uint32_t periodo;                         // Ticks, 0 = una sola vez
+    funcionTimerSoft_t funcion;
+    void *arg;
+    uint8_t modo;
+} timerSoft_t;
+
+typedef struct {
+    listaTimers_t nivel0[RUEDA_CASILLAS0];
+    listaTimers_t niveles[RUEDA_NIVELES][RUEDA_CASILLAS];
+    uint32_t ahora;                  // Siguiente tick por atender
+    portMUX_TYPE candado;
+    gptimer_handle_t timer;
+    bool corriendo;                  // El gptimer está arrancado, con el candado
+    uint32_t armados;                // Timers en la rueda o por atender en este tick, con el candado
+    QueueHandle_t cola;              // Timers vencidos para la tarea
+    volatile uint32_t ticks;
+    volatile uint32_t disparos;
+    volatile uint32_t perdidos;      // Disparos para la tarea con la cola llena
+    volatile uint32_t maximoPorTick;
+} timersSoft_t;
+
+static timersSoft_t timersSoft = {.candado = portMUX_INITIALIZER_UNLOCKED};
+
+static inline void IRAM_ATTR lista_vaciar(listaTimers_t *l) {
+    l->siguiente = l->anterior = l;
+}
+
+static inline bool IRAM_ATTR lista_vacia(const listaTimers_t *l) {
+    return l->siguiente == l;
+}
+
+// El nodo es el primer campo del timer
+static inline timerSoft_t *IRAM_ATTR lista_primero(const listaTimers_t *l) {
+    return (timerSoft_t *)l->siguiente;
+}
+
+static inline void IRAM_ATTR lista_agregar(listaTimers_t *l, timerSoft_t *t) {
+    nodoTimer_t *n = &t->nodo;
+    n->siguiente = l;
+    n->anterior = l->anterior;
+    l->anterior->siguiente = n;
+    l->anterior = n;
+}
+
+static inline void IRAM_ATTR lista_quitar(timerSoft_t *t) {
+    nodoTimer_t *n = &t->nodo;
+    n->anterior->siguiente = n->siguiente;
+    n->siguiente->anterior = n->anterior;
+    n->siguiente = n->anterior = NULL;
+}
+
+// Cuelga el timer de la casilla de su vencimiento. Con el candado tomado
+static inline void IRAM_ATTR rueda_insertar(timersSoft_t *r, timerSoft_t *t) {
+    uint32_t faltan = t->vence - r->ahora;
+    if ((int32_t)faltan < 0) {   // Ya venció: al siguiente tick
+        t->vence = r->ahora;
+        faltan = 0;
+    }
+    if (faltan > RUEDA_MAXIMO) {
+        // Más lejos de lo que cubre la rueda: espera en la casilla del último
+        // nivel que baja más tarde (entre 63 * 2^20 y 2^26 ticks) y al bajar se
+        // vuelve a colgar con lo que le falte
+        int corrimiento = RUEDA_BITS0 + (RUEDA_NIVELES - 1) * RUEDA_BITS;
+        int casilla = ((r->ahora >> corrimiento) - 1) & (RUEDA_CASILLAS - 1);
+        lista_agregar(&r->niveles[RUEDA_NIVELES - 1][casilla], t);
+        return;
+    }
+    if (faltan < RUEDA_CASILLAS0) {
+        lista_agregar(&r->nivel0[t->vence & (RUEDA_CASILLAS0 - 1)], t);
+        return;
+    }
+    for (int n = 0; n < RUEDA_NIVELES; n++) {
+        int corrimiento = RUEDA_BITS0 + (n + 1) * RUEDA_BITS;
+        if (n == RUEDA_NIVELES - 1 || faltan < (1UL << corrimiento)) {
+            int casilla = (t->vence >> (corrimiento - RUEDA_BITS)) & (RUEDA_CASILLAS - 1);
+            lista_agregar(&r->niveles[n][casilla], t);
+            return;
+        }
+    }
+}
+
+// Baja los timers de una casilla de un nivel alto; regresa el índice de la casilla
+static inline int IRAM_ATTR rueda_bajar(timersSoft_t *r, int nivel) {
+    int casilla = (r->ahora >> (RUEDA_BITS0 + nivel * RUEDA_BITS)) & (RUEDA_CASILLAS - 1);
+    listaTimers_t *l = &r->niveles[nivel][casilla];
+    while (!lista_vacia(l)) {
+        timerSoft_t *t = lista_primero(l);
+        lista_quitar(t);
+        rueda_insertar(r, t);
+    }
+    return casilla;
+}
+
+// Tick del gptimer: avanza la rueda y atiende la casilla del tick actual. Los
+// callbacks de la ISR corren sin el candado: así el otro núcleo puede armar y
+// cancelar mientras tanto y un callback largo no lo deja esperando
+static bool IRAM_ATTR timersSoft_tick(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
+    timersSoft_t *r = &timersSoft;
+    BaseType_t despertar = pdFALSE;
+    uint32_t disparos = 0;
+
+    portENTER_CRITICAL_ISR(&r->candado);
+    int indice = r->ahora & (RUEDA_CASILLAS0 - 1);
+    if (indice == 0) {
+        for (int n = 0; n < RUEDA_NIVELES && rueda_bajar(r, n) == 0; n++) {
+        }
+    }
+
+    // La casilla se pasa a una lista local. Solo se toca con el candado, así que
+    // mientras corre un callback se pueden armar o cancelar timers (incluso de
+    // esta misma lista): uno que se cancela antes de salir de la lista ya no dispara
+    listaTimers_t vencidos;
+    listaTimers_t *casilla = &r->nivel0[indice];
+    if (lista_vacia(casilla)) {
+        lista_vaciar(&vencidos);
+    } else {
+        vencidos = *casilla;
+        vencidos.siguiente->anterior = &vencidos;
+        vencidos.anterior->siguiente = &vencidos;
+        lista_vaciar(casilla);
+    }
+    r->ahora++;
+
+    while (!lista_vacia(&vencidos)) {
+        timerSoft_t *t = lista_primero(&vencidos);
+        lista_quitar(t);
+        if (t->periodo) {
+            t->vence += t->periodo;   // Sin deriva: relativo al vencimiento, no al tick actual
+            rueda_insertar(r, t);
+        } else {
+            r->armados--;
+        }
+        disparos++;
+        if (t->modo == TIMER_SOFT_ISR) {
+            portEXIT_CRITICAL_ISR(&r->candado);
+            if (t->funcion(t->arg)) despertar = pdTRUE;
+            portENTER_CRITICAL_ISR(&r->candado);
+        } else if (xQueueSendFromISR(r->cola, &t, &despertar) != pdTRUE) {
+            r->perdidos++;
+        }
+    }
+    // Nada armado: el gptimer se detiene hasta el siguiente timerSoft_armar()
+    if (r->armados == 0 && r->corriendo) {
+        r->corriendo = false;
+        gptimer_stop(r->timer);
+    }
+    portEXIT_CRITICAL_ISR(&r->candado);
+
+    r->ticks++;
+    r->disparos += disparos;
+    if (disparos > r->maximoPorTick) r->maximoPorTick = disparos;
+    return despertar == pdTRUE;
+}
+
+// Los timers en modo tarea se atienden aquí, en el orden en que vencieron
+static void timersSoft_tarea(void *pvParameters) {
+    timerSoft_t *t;
+    while (1) {
+        if (xQueueReceive(timersSoft.cola, &t, portMAX_DELAY) == pdTRUE) {
+            t->funcion(t->arg);
+        }
+    }
+}
+
+static inline void timerSoft_crear(timerSoft_t *t, funcionTimerSoft_t funcion, void *arg, modoTimerSoft_t modo) {
+    t->nodo.siguiente = t->nodo.anterior = NULL;
+    t->funcion = funcion;
+    t->arg = arg;
+    t->modo = modo;
+}
+
+// Vence dentro de "retardo" ticks (al menos uno) y luego cada "periodo" (0 = una vez).
+// Los dos deben ser menores que 2^31 ticks (24 días con ticks de 1 ms); más allá
+// de RUEDA_MAXIMO (18.6 h) el timer da vueltas extra en el último nivel, sin
+// adelantarse. Si ya estaba armado se rearma. Se puede llamar desde una tarea o una ISR.
+// Con la rueda detenida arranca el gptimer, que sigue desde la cuenta en que se
+// detuvo: el primer tick llega como si nunca se hubiera detenido
+static inline void IRAM_ATTR timerSoft_armar(timerSoft_t *t, uint32_t retardo, uint32_t periodo) {
+    timersSoft_t *r = &timersSoft;
+    portENTER_CRITICAL_SAFE(&r->candado);
+    if (t->nodo.siguiente) {
+        lista_quitar(t);
+    } else {
+        r->armados++;
+    }
+    t->periodo = periodo;
+    t->vence = r->ahora + (retardo ? retardo - 1 : 0);
+    rueda_insertar(r, t);
+    if (!r->corriendo) {
+        r->corriendo = true;
+        gptimer_start(r->timer);
+    }
+    portEXIT_CRITICAL_SAFE(&r->candado);
+}
+
+// Desarma el timer. Un disparo que ya está en la cola de la tarea todavía se
+// ejecuta, igual que un callback de ISR que el tick ya sacó de la rueda
+static inline void IRAM_ATTR timerSoft_cancelar(timerSoft_t *t) {
+    portENTER_CRITICAL_SAFE(&timersSoft.candado);
+    if (t->nodo.siguiente) {
+        lista_quitar(t);
+        timersSoft.armados--;
+    }
+    portEXIT_CRITICAL_SAFE(&timersSoft.candado);
+}
+
+static inline bool timerSoft_armado(const timerSoft_t *t) {
+    return t->nodo.siguiente != NULL;
+}
+
+// Crea el gptimer del tick y la tarea de timers (prioridad alta, un poco abajo de las ISR).
+// El gptimer queda habilitado pero detenido hasta que se arme el primer timer
+static inline esp_err_t timersSoft_iniciar(void) {
+    timersSoft_t *r = &timersSoft;
+    for (int i = 0; i < RUEDA_CASILLAS0; i++) lista_vaciar(&r->nivel0[i]);
+    for (int n = 0; n < RUEDA_NIVELES; n++) {
+        for (int i = 0; i < RUEDA_CASILLAS; i++) lista_vaciar(&r->niveles[n][i]);
+    }
+    r->ahora = 0;
+    r->armados = 0;
+    r->corriendo = false;
+    r->cola = xQueueCreate(TIMERS_SOFT_COLA, sizeof(timerSoft_t *));
+    if (r->cola == NULL) return ESP_ERR_NO_MEM;
+    if (xTaskCreate(timersSoft_tarea, "TimersSoft", 3072, NULL, configMAX_PRIORITIES - 2, NULL) != pdPASS) {
+        vQueueDelete(r->cola);
+        r->cola = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,  // 1 MHz para contar en microsegundos
+    };
+    esp_err_t err = gptimer_new_timer(&timer_config, &r->timer);
+    if (err != ESP_OK) return err;
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = TIMERS_SOFT_TICK_US,
+        .flags.auto_reload_on_alarm = true,
+    };
+    err = gptimer_set_alarm_action(r->timer, &alarm_config);
+    if (err != ESP_OK) return err;
+    gptimer_event_callbacks_t cbs = {
+        .on_alarm = timersSoft_tick,
+    };
+    err = gptimer_register_event_callbacks(r->timer, &cbs, NULL);
+    if (err != ESP_OK) return err;
+    return gptimer_enable(r->timer);
+}
+
+#endif
@@ -0,0 +1,525 @@
+// Implementaciones falsas del ESP-IDF para las pruebas en la PC.
+//
+// Los registros son variables y las funciones del driver hacen lo mínimo
+// para que los programas corran sin hardware. Solo está lo que alguna prueba
+// usa; lo demás ni se enlaza.
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "falsos.h"
+
+// ---------------------------------------------------------------- GPIO
+
+volatile gpio_dev_t gpioFalso;
+uint32_t gpioFalsoAccesos;
+uint32_t gpioFalsoLlamadas;
+
+static void gpioFalso_aplicar(void) {
+    gpioFalso.out = (gpioFalso.out & ~gpioFalso.out_w1tc) | gpioFalso.out_w1ts;
+    gpioFalso.out1.val = (gpioFalso.out1.val & ~gpioFalso.out1_w1tc.val) | gpioFalso.out1_w1ts.val;
+    gpioFalso.status &= ~gpioFalso.status_w1tc;
+    gpioFalso.status1.val &= ~gpioFalso.status1_w1tc.val;
+    gpioFalso.pcpu_int &= gpioFalso.status;
+    gpioFalso.pcpu_int1.val &= gpioFalso.status1.val;
+    gpioFalso.out_w1ts = gpioFalso.out_w1tc = 0;
+    gpioFalso.out1_w1ts.val = gpioFalso.out1_w1tc.val = 0;
+    gpioFalso.status_w1tc = gpioFalso.status1_w1tc.val = 0;
+}
+
+volatile gpio_dev_t *gpioFalso_registro(void) {
+    gpioFalso_aplicar();
+    gpioFalsoAccesos++;
+    return &gpioFalso;
+}
+
+uint64_t gpioFalso_salidas(void) {
+    gpioFalso_aplicar();
+    return gpioFalso.out | (uint64_t)gpioFalso.out1.val << 32;
+}
+
+void gpioFalso_reiniciar(void) {
+    memset((void *)&gpioFalso, 0, sizeof(gpioFalso));
+    gpioFalsoAccesos = 0;
+    gpioFalsoLlamadas = 0;
+}
+
+void (*gpioFalso_alEscribir)(void);
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t nivel) {
+    gpioFalso_aplicar();
+    gpioFalsoLlamadas++;
+    volatile uint32_t *out = pin < 32 ? &gpioFalso.out : &gpioFalso.out1.val;
+    uint32_t bit = 1UL << (pin & 31);
+    *out = nivel ? (*out | bit) : (*out & ~bit);
+    if (gpioFalso_alEscribir) gpioFalso_alEscribir();
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin) {
+    uint32_t entradas = pin < 32 ? gpioFalso.in : gpioFalso.in1.val;
+    return (entradas >> (pin & 31)) & 1;
+}
+
+esp_err_t gpio_config(const gpio_config_t *c) { return ESP_OK; }
+esp_err_t gpio_reset_pin(gpio_num_t pin) { return ESP_OK; }
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t modo) { return ESP_OK; }
+esp_err_t gpio_set_pull_mode(gpio_num_t pin, gpio_pull_mode_t modo) { return ESP_OK; }
+esp_err_t gpio_pullup_en(gpio_num_t pin) { return ESP_OK; }
+
+// Interrupciones: ISR única (gpio_isr_register) o manejadores por pin (servicio de ISR del driver)
+void (*gpioFalsoIsr)(void *);
+void *gpioFalsoIsrArg;
+gpio_int_type_t gpioFalsoTipoIntr[GPIO_PINES_FALSOS];
+bool gpioFalsoIntrActiva[GPIO_PINES_FALSOS];
+uint32_t gpioFalsoInterrupciones;
+static gpio_isr_t gpioFalsoManejador[GPIO_PINES_FALSOS];
+static void *gpioFalsoArg[GPIO_PINES_FALSOS];
+
+esp_err_t gpio_isr_register(void (*fn)(void *), void *arg, int flags, gpio_isr_handle_t *handle) {
+    gpioFalsoIsr = fn;
+    gpioFalsoIsrArg = arg;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t tipo) {
+    gpioFalsoTipoIntr[pin] = tipo;
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int flags) { return ESP_OK; }
+
+// GPIO.pcpu_int: el estado de los pines con la interrupción activa hacia el CPU
+static void gpioFalso_intrCpu(int pin, bool activa) {
+    volatile uint32_t *estado = pin < 32 ? &gpioFalso.status : &gpioFalso.status1.val;
+    volatile uint32_t *cpu = pin < 32 ? &gpioFalso.pcpu_int : &gpioFalso.pcpu_int1.val;
+    uint32_t bit = 1UL << (pin & 31);
+    gpioFalsoIntrActiva[pin] = activa;
+    *cpu = activa ? (*cpu | (*estado & bit)) : (*cpu & ~bit);
+}
+
+// Como el driver: agregar el manejador también activa la interrupción del pin
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t manejador, void *arg) {
+    gpioFalsoManejador[pin] = manejador;
+    gpioFalsoArg[pin] = arg;
+    gpioFalso_intrCpu(pin, true);
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t pin) {
+    gpioFalsoManejador[pin] = NULL;
+    gpioFalso_intrCpu(pin, false);
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t pin) {
+    gpioFalso_intrCpu(pin, true);
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t pin) {
+    gpioFalso_intrCpu(pin, false);
+    return ESP_OK;
+}
+
+void gpioFalso_entrada(int pin, int nivel) {
+    volatile uint32_t *in = pin < 32 ? &gpioFalso.in : &gpioFalso.in1.val;
+    uint32_t bit = 1UL << (pin & 31);
+    int antes = (*in & bit) != 0;
+    *in = nivel ? (*in | bit) : (*in & ~bit);
+    if (nivel == antes || !gpioFalsoIntrActiva[pin]) return;
+
+    gpio_int_type_t tipo = gpioFalsoTipoIntr[pin];
+    bool dispara = tipo == GPIO_INTR_ANYEDGE || (tipo == GPIO_INTR_POSEDGE && nivel) ||
+                   (tipo == GPIO_INTR_NEGEDGE && !nivel) || (tipo == GPIO_INTR_HIGH_LEVEL && nivel) ||
+                   (tipo == GPIO_INTR_LOW_LEVEL && !nivel);
+    if (!dispara) return;
+    gpioFalsoInterrupciones++;
+    if (gpioFalsoManejador[pin]) {
+        gpioFalsoManejador[pin](gpioFalsoArg[pin]);   // El servicio del driver limpia el estado
+    } else if (gpioFalsoIsr) {
+        volatile uint32_t *estado = pin < 32 ? &gpioFalso.status : &gpioFalso.status1.val;
+        volatile uint32_t *cpu = pin < 32 ? &gpioFalso.pcpu_int : &gpioFalso.pcpu_int1.val;
+        *estado |= bit;
+        *cpu |= bit;
+        gpioFalsoIsr(gpioFalsoIsrArg);
+    }
+}
+
+// ---------------------------------------------------------------- Relojes
+
+int64_t relojFalso_us;
+uint32_t ciclosFalsos;
+
+int64_t esp_timer_get_time(void) { return relojFalso_us; }
+uint32_t esp_cpu_get_cycle_count(void) { return ciclosFalsos; }
+
+// ---------------------------------------------------------------- FreeRTOS
+
+int memoriaFalsa = -1;
+
+// Una creación de tarea o de cola gasta una unidad de memoriaFalsa; con 0 falla
+static bool memoriaFalsa_tomar(void) {
+    if (memoriaFalsa == 0) return false;
+    if (memoriaFalsa > 0) memoriaFalsa--;
+    return true;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t f, const char *nombre, uint32_t pila, void *arg, UBaseType_t prioridad,
+                       TaskHandle_t *tarea) {
+    if (!memoriaFalsa_tomar()) return pdFALSE;
+    if (tarea) *tarea = (TaskHandle_t)f;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t f, const char *nombre, uint32_t pila, void *arg,
+                                   UBaseType_t prioridad, TaskHandle_t *tarea, BaseType_t nucleo) {
+    return xTaskCreate(f, nombre, pila, arg, prioridad, tarea);
+}
+
+void vTaskDelete(TaskHandle_t tarea) {}
+
+uint32_t notificacionesFalsas;
+int seccionCriticaFalsa;
+
+// Sin avisos pendientes. Las pruebas que corren una tarea la reemplazan con la
+// suya para dejarla dar las vueltas que quieran
+__attribute__((weak)) uint32_t ulTaskNotifyTake(BaseType_t limpiar, TickType_t espera) { return 0; }
+
+void vTaskDelay(TickType_t ticks) { relojFalso_us += (int64_t)ticks * 1000; }
+
+void vTaskNotifyGiveFromISR(TaskHandle_t tarea, BaseType_t *despertar) {
+    notificacionesFalsas++;
+    if (despertar) *despertar = pdTRUE;
+}
+
+// Colas: FIFO de copias, nunca bloquean. Una espera distinta de 0 con la cola
+// llena (o vacía al recibir) se cuenta, porque en la placa la tarea se dormiría
+
+QueueHandle_t xQueueCreate(UBaseType_t largo, UBaseType_t tamano) {
+    if (!memoriaFalsa_tomar()) return NULL;
+    colaFalsa_t *c = calloc(1, sizeof(colaFalsa_t));
+    c->datos = calloc(largo, tamano);
+    c->largo = largo;
+    c->tamano = tamano;
+    return c;
+}
+
+void vQueueDelete(QueueHandle_t cola) {
+    colaFalsa_t *c = cola;
+    free(c->datos);
+    free(c);
+}
+
+static BaseType_t colaFalsa_meter(colaFalsa_t *c, const void *dato, TickType_t espera) {
+    if (c->cuenta == c->largo) {
+        c->llenas++;
+        if (espera) c->bloqueos++;
+        return pdFALSE;
+    }
+    memcpy(c->datos + ((c->cabeza + c->cuenta) % c->largo) * c->tamano, dato, c->tamano);
+    c->cuenta++;
+    if (c->cuenta > c->maximo) c->maximo = c->cuenta;
+    return pdTRUE;
+}
+
+BaseType_t xQueueSend(QueueHandle_t cola, const void *dato, TickType_t espera) {
+    return colaFalsa_meter(cola, dato, espera);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t cola, const void *dato, BaseType_t *despertar) {
+    return colaFalsa_meter(cola, dato, 0);
+}
+
+void (*colaFalsa_alEsperar)(colaFalsa_t *c);
+
+BaseType_t xQueueReceive(QueueHandle_t cola, void *dato, TickType_t espera) {
+    colaFalsa_t *c = cola;
+    if (c->cuenta == 0 && espera) {
+        c->bloqueos++;
+        if (colaFalsa_alEsperar) colaFalsa_alEsperar(c);
+    }
+    if (c->cuenta == 0) return pdFALSE;
+    memcpy(dato, c->datos + c->cabeza * c->tamano, c->tamano);
+    c->cabeza = (c->cabeza + 1) % c->largo;
+    c->cuenta--;
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t cola) { return ((colaFalsa_t *)cola)->cuenta; }
+
+// Semáforos binarios: colas de un lugar con un byte que no significa nada
+static uint8_t semaforoFalso_ficha;
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) { return xQueueCreate(1, 1); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaforo, TickType_t espera) {
+    uint8_t ficha;
+    return xQueueReceive(semaforo, &ficha, espera);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaforo) { return colaFalsa_meter(semaforo, &semaforoFalso_ficha, 0); }
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaforo, BaseType_t *despertar) {
+    return colaFalsa_meter(semaforo, &semaforoFalso_ficha, 0);
+}
+
+// ---------------------------------------------------------------- gptimer
+
+gptimerFalso_t gptimersFalsos[GPTIMERS_FALSOS];
+int gptimersFalsosCreados;
+
+esp_err_t gptimer_new_timer(const gptimer_config_t *config, gptimer_handle_t *timer) {
+    if (gptimersFalsosCreados == GPTIMERS_FALSOS) return ESP_ERR_NO_MEM;
+    gptimerFalso_t *t = &gptimersFalsos[gptimersFalsosCreados++];
+    memset(t, 0, sizeof(*t));
+    t->resolucion_hz = config->resolution_hz;
+    *timer = t;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_set_alarm_action(gptimer_handle_t timer, const gptimer_alarm_config_t *config) {
+    gptimerFalso_t *t = timer;
+    t->alarma = config ? config->alarm_count : 0;
+    t->recarga = config && config->flags.auto_reload_on_alarm;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_register_event_callbacks(gptimer_handle_t timer, const gptimer_event_callbacks_t *cbs, void *ctx) {
+    gptimerFalso_t *t = timer;
+    t->alarma_cb = cbs->on_alarm;
+    t->ctx = ctx;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_enable(gptimer_handle_t timer) { return ESP_OK; }
+
+esp_err_t gptimer_start(gptimer_handle_t timer) {
+    ((gptimerFalso_t *)timer)->corriendo = true;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_stop(gptimer_handle_t timer) {
+    ((gptimerFalso_t *)timer)->corriendo = false;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_set_raw_count(gptimer_handle_t timer, uint64_t cuenta) {
+    ((gptimerFalso_t *)timer)->cuenta = cuenta;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_get_raw_count(gptimer_handle_t timer, uint64_t *cuenta) {
+    *cuenta = ((gptimerFalso_t *)timer)->cuenta;
+    return ESP_OK;
+}
+
+// Avanza la cuenta; cada vez que pasa por la alarma llama al callback
+bool gptimerFalso_avanzar(gptimerFalso_t *t, uint64_t cuentas) {
+    bool despertar = false;
+    while (cuentas && t->corriendo) {
+        if (!t->alarma_cb || t->cuenta >= t->alarma || t->cuenta + cuentas < t->alarma) {
+            t->cuenta += cuentas;
+            break;
+        }
+        cuentas -= t->alarma - t->cuenta;
+        t->cuenta = t->alarma;
+        gptimer_alarm_event_data_t datos = {.count_value = t->cuenta, .alarm_value = t->alarma};
+        if (t->recarga) t->cuenta = 0;
+        t->alarmas++;
+        despertar |= t->alarma_cb(t, &datos, t->ctx);
+    }
+    return despertar;
+}
+
+// ---------------------------------------------------------------- Interrupciones
+
+int intrFalsoFuente = -1;
+int intrFalsoFlags;
+void (*intrFalsoManejador)(void *);
+
+esp_err_t esp_intr_alloc(int fuente, int flags, void (*manejador)(void *), void *arg, intr_handle_t *handle) {
+    intrFalsoFuente = fuente;
+    intrFalsoFlags = flags;
+    intrFalsoManejador = manejador;
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------- MCPWM
+
+volatile mcpwm_dev_t MCPWM0, MCPWM1;
+uint32_t mcpwmFalsoComparadores[MCPWM_TIMER_MAX][MCPWM_OPR_MAX];
+uint32_t mcpwmFalsoEscrituras;
+void (*mcpwmFalso_alEscribir)(void);
+
+void mcpwm_ll_operator_set_compare_value(volatile mcpwm_dev_t *mcpwm, int operador, int comparador, uint32_t ticks) {
+    mcpwmFalsoComparadores[operador][comparador] = ticks;
+    mcpwmFalsoEscrituras++;
+    if (mcpwmFalso_alEscribir) mcpwmFalso_alEscribir();
+}
+
+esp_err_t mcpwm_gpio_init(mcpwm_unit_t unidad, mcpwm_io_signals_t senal, int pin) { return ESP_OK; }
+esp_err_t mcpwm_init(mcpwm_unit_t unidad, mcpwm_timer_t timer, const mcpwm_config_t *config) { return ESP_OK; }
+esp_err_t mcpwm_group_set_resolution(mcpwm_unit_t unidad, unsigned long int hz) { return ESP_OK; }
+esp_err_t mcpwm_timer_set_resolution(mcpwm_unit_t unidad, mcpwm_timer_t timer, unsigned long int hz) { return ESP_OK; }
+esp_err_t mcpwm_set_timer_sync_output(mcpwm_unit_t unidad, mcpwm_timer_t timer, mcpwm_timer_sync_trigger_t fuente) {
+    return ESP_OK;
+}
+esp_err_t mcpwm_sync_configure(mcpwm_unit_t unidad, mcpwm_timer_t timer, const mcpwm_sync_config_t *config) {
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------- LEDC
+
+int ledcFalsoPin = -1;
+uint32_t ledcFalsoFrecuencia;
+uint32_t ledcFalsoDuty;
+static uint32_t ledcFalsoDutyNuevo;
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *config) {
+    ledcFalsoFrecuencia = config->freq_hz;
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *config) {
+    ledcFalsoPin = config->gpio_num;
+    ledcFalsoDuty = ledcFalsoDutyNuevo = config->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_freq(ledc_mode_t modo, ledc_timer_t timer, uint32_t hz) {
+    ledcFalsoFrecuencia = hz;
+    return ESP_OK;
+}
+
+uint32_t ledc_get_freq(ledc_mode_t modo, ledc_timer_t timer) { return ledcFalsoFrecuencia; }
+
+esp_err_t ledc_set_duty(ledc_mode_t modo, ledc_channel_t canal, uint32_t duty) {
+    ledcFalsoDutyNuevo = duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t modo, ledc_channel_t canal) {
+    ledcFalsoDuty = ledcFalsoDutyNuevo;
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------- LCD_CAM (panel RGB)
+
+esp_lcd_rgb_panel_config_t lcdFalsoConfig;
+uint16_t *lcdFalsoFrames[2];
+int lcdFalsoActivo;
+int lcdFalsoPedido;
+uint32_t lcdFalsoVsyncs;
+static esp_lcd_rgb_panel_event_callbacks_t lcdFalsoEventos;
+static void *lcdFalsoCtx;
+
+esp_err_t esp_lcd_new_rgb_panel(const esp_lcd_rgb_panel_config_t *config, esp_lcd_panel_handle_t *panel) {
+    lcdFalsoConfig = *config;
+    size_t bytes = (config->bits_per_pixel ? config->bits_per_pixel : config->data_width) / 8;
+    for (size_t i = 0; i < config->num_fbs && i < 2; i++) {
+        free(lcdFalsoFrames[i]);
+        lcdFalsoFrames[i] = calloc(config->timings.h_res * config->timings.v_res, bytes);
+    }
+    lcdFalsoActivo = lcdFalsoPedido = 0;
+    lcdFalsoEventos = (esp_lcd_rgb_panel_event_callbacks_t){0};
+    *panel = (esp_lcd_panel_handle_t)&lcdFalsoConfig;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_rgb_panel_get_frame_buffer(esp_lcd_panel_handle_t panel, uint32_t n, void **fb0, ...) {
+    va_list args;
+    va_start(args, fb0);
+    *fb0 = lcdFalsoFrames[0];
+    if (n > 1) *va_arg(args, void **) = lcdFalsoFrames[1];
+    va_end(args);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_rgb_panel_register_event_callbacks(esp_lcd_panel_handle_t panel,
+                                                     const esp_lcd_rgb_panel_event_callbacks_t *eventos, void *ctx) {
+    lcdFalsoEventos = *eventos;
+    lcdFalsoCtx = ctx;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel) { return ESP_OK; }
+esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel) { return ESP_OK; }
+
+// Con los frame buffers del driver, dibujar uno de ellos solo lo pide para el siguiente frame
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x0, int y0, int x1, int y1, const void *datos) {
+    const esp_lcd_rgb_timing_t *t = &lcdFalsoConfig.timings;
+    if (x0 != 0 || y0 != 0 || x1 != (int)t->h_res || y1 != (int)t->v_res) return ESP_ERR_INVALID_ARG;
+    for (int i = 0; i < 2; i++) {
+        if (datos == lcdFalsoFrames[i]) lcdFalsoPedido = i;
+    }
+    return ESP_OK;
+}
+
+void lcdFalso_vsync(void) {
+    lcdFalsoActivo = lcdFalsoPedido;
+    lcdFalsoVsyncs++;
+    if (lcdFalsoEventos.on_vsync) lcdFalsoEventos.on_vsync(&lcdFalsoConfig, NULL, lcdFalsoCtx);
+}
+
+// Cada línea: hsync, porche trasero, área activa, porche delantero.
+// Cada frame: líneas de vsync, porche trasero, líneas activas, porche delantero
+static uint32_t lcdFalso_ciclosLinea(void) {
+    const esp_lcd_rgb_timing_t *t = &lcdFalsoConfig.timings;
+    return t->hsync_pulse_width + t->hsync_back_porch + t->h_res + t->hsync_front_porch;
+}
+
+uint32_t lcdFalso_ciclosFrame(void) {
+    const esp_lcd_rgb_timing_t *t = &lcdFalsoConfig.timings;
+    return lcdFalso_ciclosLinea() * (t->vsync_pulse_width + t->vsync_back_porch + t->v_res + t->vsync_front_porch);
+}
+
+uint16_t lcdFalso_salida(uint32_t ciclo) {
+    const esp_lcd_rgb_timing_t *t = &lcdFalsoConfig.timings;
+    int32_t linea = ciclo / lcdFalso_ciclosLinea() - t->vsync_pulse_width - t->vsync_back_porch;
+    int32_t columna = ciclo % lcdFalso_ciclosLinea() - t->hsync_pulse_width - t->hsync_back_porch;
+    if (linea < 0 || linea >= (int32_t)t->v_res || columna < 0 || columna >= (int32_t)t->h_res) return 0;
+    return lcdFalsoFrames[lcdFalsoActivo][linea * t->h_res + columna];
+}
+
+// ---------------------------------------------------------------- RMT
+
+int rmtFalsoFalla;
+int rmtFalsoCanales, rmtFalsoCodificadores;
+static int rmtFalsoLlamadas;
+
+// La llamada número rmtFalsoFalla (contando desde 1) regresa ESP_ERR_NO_MEM
+static esp_err_t rmtFalso_llamada(void) {
+    return ++rmtFalsoLlamadas == rmtFalsoFalla ? ESP_ERR_NO_MEM : ESP_OK;
+}
+
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *config, rmt_channel_handle_t *canal) {
+    if (rmtFalso_llamada() != ESP_OK) return ESP_ERR_NO_MEM;
+    rmtFalsoCanales++;
+    *canal = (rmt_channel_handle_t)&rmtFalsoCanales;
+    return ESP_OK;
+}
+
+esp_err_t rmt_new_copy_encoder(const rmt_copy_encoder_config_t *config, rmt_encoder_handle_t *codificador) {
+    if (rmtFalso_llamada() != ESP_OK) return ESP_ERR_NO_MEM;
+    rmtFalsoCodificadores++;
+    *codificador = (rmt_encoder_handle_t)&rmtFalsoCodificadores;
+    return ESP_OK;
+}
+
+esp_err_t rmt_enable(rmt_channel_handle_t canal) { return rmtFalso_llamada(); }
+
+esp_err_t rmt_del_channel(rmt_channel_handle_t canal) {
+    rmtFalsoCanales--;
+    return ESP_OK;
+}
+
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t codificador) {
+    rmtFalsoCodificadores--;
+    return ESP_OK;
+}
+
+void rmtFalso_reiniciar(int falla) {
+    rmtFalsoFalla = falla;
+    rmtFalsoLlamadas = 0;
+}
@@ -0,0 +1,103 @@
+#ifndef FALSOS_H
+#define FALSOS_H
+
+// Estado de los periféricos falsos de falsos.c, para que las pruebas lo
+// controlen (reloj, entradas) y lo revisen (salidas, accesos, llamadas).
+
+#include <stdint.h>
+#include "esp_falso.h"
+
+// Bloque GPIO: accesos al bloque de registros y llamadas a gpio_set_level()
+extern uint32_t gpioFalsoAccesos;
+extern uint32_t gpioFalsoLlamadas;
+uint64_t gpioFalso_salidas(void);        // out | out1 << 32, con las escrituras ya aplicadas
+void gpioFalso_reiniciar(void);
+// Si no es NULL, corre después de cada gpio_set_level(): sirve para que las
+// entradas sigan a las salidas, como las filas de un teclado a sus columnas
+extern void (*gpioFalso_alEscribir)(void);
+// Interrupciones por pin: tipo, si está activa y cuántas veces se disparó.
+// gpioFalso_entrada cambia el nivel de una entrada y, si el cambio dispara su
+// interrupción, llama al manejador del pin (servicio de ISR del driver) o marca
+// el pin en GPIO.status y GPIO.pcpu_int y llama a la ISR de gpio_isr_register().
+// Limpiar el estado o apagar la interrupción del pin lo quita de GPIO.pcpu_int
+#define GPIO_PINES_FALSOS 49
+extern gpio_int_type_t gpioFalsoTipoIntr[GPIO_PINES_FALSOS];
+extern bool gpioFalsoIntrActiva[GPIO_PINES_FALSOS];
+extern uint32_t gpioFalsoInterrupciones;
+void gpioFalso_entrada(int pin, int nivel);
+
+// ISR única registrada con gpio_isr_register(): la prueba la llama cuando hay estado pendiente
+extern void (*gpioFalsoIsr)(void *);
+extern void *gpioFalsoIsrArg;
+
+// Relojes: esp_timer_get_time() y esp_cpu_get_cycle_count()
+extern int64_t relojFalso_us;
+extern uint32_t ciclosFalsos;
+
+// FreeRTOS: avisos dados con vTaskNotifyGiveFromISR(). seccionCriticaFalsa
+// (en stubs/esp_falso.h) es la profundidad de portENTER_CRITICAL en cada momento.
+// memoriaFalsa: tareas y colas que todavía se pueden crear (-1 = sin límite)
+extern uint32_t notificacionesFalsas;
+extern int memoriaFalsa;
+
+// Colas: largo fijo, copias de tamano bytes. llenas cuenta los envíos
+// rechazados y bloqueos las llamadas que en la placa habrían dormido a la tarea
+typedef struct {
+    uint8_t *datos;
+    UBaseType_t largo, tamano, cabeza, cuenta, maximo;
+    uint32_t llenas, bloqueos;
+} colaFalsa_t;
+// Si no es NULL, corre cuando una recepción con espera encuentra la cola vacía
+// (en la placa la tarea se dormiría): la prueba hace avanzar el mundo y la
+// recepción se intenta otra vez. Los semáforos binarios son colas de un lugar
+extern void (*colaFalsa_alEsperar)(colaFalsa_t *c);
+
+// gptimer: la prueba avanza la cuenta y las alarmas llaman al callback, con
+// recarga automática si se pidió. Los timers quedan en orden de creación
+#define GPTIMERS_FALSOS 4
+typedef struct {
+    uint32_t resolucion_hz;
+    uint64_t cuenta, alarma;
+    bool recarga, corriendo;
+    gptimer_alarm_cb_t alarma_cb;
+    void *ctx;
+    uint32_t alarmas;
+} gptimerFalso_t;
+extern gptimerFalso_t gptimersFalsos[GPTIMERS_FALSOS];
+extern int gptimersFalsosCreados;
+bool gptimerFalso_avanzar(gptimerFalso_t *t, uint64_t cuentas);   // true si algún callback despertó una tarea
+
+// Última interrupción pedida con esp_intr_alloc()
+extern int intrFalsoFuente;
+extern int intrFalsoFlags;
+extern void (*intrFalsoManejador)(void *);
+
+// MCPWM (driver viejo): último comparador de cada salida en ticks y cuántas
+// escrituras hubo. alEscribir, si no es NULL, corre después de cada escritura:
+// sirve para simular una ISR que llega a media tarea
+extern uint32_t mcpwmFalsoComparadores[MCPWM_TIMER_MAX][MCPWM_OPR_MAX];
+extern uint32_t mcpwmFalsoEscrituras;
+extern void (*mcpwmFalso_alEscribir)(void);
+
+// LEDC: pin del canal, frecuencia del timer y ciclo de trabajo (en cuentas)
+// que quedaron después de ledc_update_duty()
+extern int ledcFalsoPin;
+extern uint32_t ledcFalsoFrecuencia;
+extern uint32_t ledcFalsoDuty;
+
+// RMT: canales y codificadores vivos. reiniciar(n) hace que la llamada n de
+// rmt_new_tx_channel / rmt_new_copy_encoder / rmt_enable (desde 1) falle, 0 = ninguna
+extern int rmtFalsoCanales, rmtFalsoCodificadores;
+void rmtFalso_reiniciar(int falla);
+
+// Panel RGB del LCD_CAM: configuración recibida, frame buffers y el que sale por DMA
+extern esp_lcd_rgb_panel_config_t lcdFalsoConfig;
+extern uint16_t *lcdFalsoFrames[2];
+extern int lcdFalsoActivo;
+extern int lcdFalsoPedido;                    // El que pidió draw_bitmap: sale desde el siguiente vsync
+extern uint32_t lcdFalsoVsyncs;
+void lcdFalso_vsync(void);                    // Fin de un frame: cambia al pedido y llama a on_vsync
+uint32_t lcdFalso_ciclosFrame(void);          // Ciclos de reloj por frame, con sincronías y porches
+uint16_t lcdFalso_salida(uint32_t ciclo);     // Bus de datos en un ciclo del frame (0 fuera del área activa)
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef FRAMEDMA_H
+#define FRAMEDMA_H
+
+// Análisis de lo que saca el LCD_CAM con un frame de displays de 7 segmentos
+// (D0-D6 = segmentos A-G, D7-D12 = transistores). Recorre dos frames seguidos
+// ciclo por ciclo, con sincronías y porches, y mide qué tan seguido y cuánto
+// tiempo se enciende cada display. Se incluye después de DisplayDMA.h.
+
+#include "prueba.h"
+#include "falsos.h"
+
+typedef struct {
+    double periodo_ms;
+    double encendido;               // Fracción del frame con un display encendido
+    uint32_t ciclosDisplay[6];      // Ciclos encendido de cada display en un frame
+    uint32_t separacionMin;         // Ciclos todo apagado entre dos displays distintos
+} analisisFrame_t;
+
+static void frameDMA_analizar(const uint8_t indices[6], analisisFrame_t *a) {
+    uint32_t total = lcdFalso_ciclosFrame();
+    uint32_t encendidos = 0;
+    int anterior = -1;
+    uint32_t ultimoEncendido = 0;
+    memset(a, 0, sizeof(*a));
+    a->separacionMin = UINT32_MAX;
+
+    for (uint32_t c = 0; c < 2 * total; c++) {
+        uint16_t salida = lcdFalso_salida(c % total);
+        uint32_t transistores = (salida >> 7) & 0x3F;
+        if (transistores == 0) {
+            COMPROBAR((salida & 0x7F) == 0, "ciclo %lu: segmentos sin display", (unsigned long)c);
+            continue;
+        }
+        int d = __builtin_ctz(transistores);
+        COMPROBAR(transistores == (1u << d), "ciclo %lu: dos displays encendidos (%02lx)", (unsigned long)c,
+                  (unsigned long)transistores);
+        COMPROBAR((salida & 0x7F) == seg7_codigo(indices[d]), "ciclo %lu: display %d muestra %02x, esperado %02x",
+                  (unsigned long)c, d, salida & 0x7F, seg7_codigo(indices[d]));
+        if (anterior >= 0 && anterior != d && c - ultimoEncendido - 1 < a->separacionMin) {
+            a->separacionMin = c - ultimoEncendido - 1;
+        }
+        anterior = d;
+        ultimoEncendido = c;
+        if (c < total) {
+            a->ciclosDisplay[d]++;
+            encendidos++;
+        }
+    }
+    a->periodo_ms = 1000.0 * total / lcdFalsoConfig.timings.pclk_hz;
+    a->encendido = (double)encendidos / total;
+}
+
+// Lo mismo con la distribución anterior: una sola línea con todo el frame y
+// sincronías y porches de un ciclo y de una línea
+static void frameDMA_analizarAnterior(const uint8_t indices[6], analisisFrame_t *a) {
+    esp_lcd_rgb_panel_config_t actual = lcdFalsoConfig;
+    esp_lcd_rgb_timing_t *t = &lcdFalsoConfig.timings;
+    t->h_res = actual.timings.h_res * actual.timings.v_res;
+    t->v_res = 1;
+    t->hsync_pulse_width = t->hsync_back_porch = t->hsync_front_porch = 1;
+    t->vsync_pulse_width = t->vsync_back_porch = t->vsync_front_porch = 1;
+    int fallas = pruebaFallas;
+    frameDMA_analizar(indices, a);
+    pruebaFallas = fallas;
+    lcdFalsoConfig = actual;
+}
+
+static int vsyncsEnEspera;
+
+// El vsync llega mientras displayDMA_publicar() espera: hasta entonces sigue
+// saliendo el frame anterior y el nuevo no se da por libre
+static void frameDMA_vsyncEnEspera(colaFalsa_t *c) {
+    COMPROBAR(lcdFalsoActivo != lcdFalsoPedido, "el frame nuevo salió antes del vsync");
+    COMPROBAR(displayDMA.frames[displayDMA.libre] == lcdFalsoFrames[lcdFalsoPedido],
+              "el frame pedido se dio por libre antes del vsync");
+    vsyncsEnEspera++;
+    lcdFalso_vsync();
+}
+
+// Publica con un vsync viejo ya dado, de antes de pedir el cambio: no cuenta,
+// así que publicar espera exactamente un vsync más y regresa con el frame nuevo saliendo
+static void frameDMA_publicar(const uint8_t indices[6]) {
+    lcdFalso_vsync();
+    int antes = vsyncsEnEspera;
+    colaFalsa_alEsperar = frameDMA_vsyncEnEspera;
+    displayDMA_publicar(indices);
+    colaFalsa_alEsperar = NULL;
+    COMPROBAR(vsyncsEnEspera - antes == 1, "publicar esperó %d vsyncs", vsyncsEnEspera - antes);
+    COMPROBAR(lcdFalsoFrames[lcdFalsoActivo] == displayDMA.frames[displayDMA.libre ^ 1],
+              "el frame publicado no es el que sale");
+}
+
+static void frameDMA_imprimir(const char *titulo, const analisisFrame_t *a) {
+    printf("%s: frame de %.1f ms (%.0f Hz), %.1f%% encendido, %.2f ms por display\n", titulo, a->periodo_ms,
+           1000.0 / a->periodo_ms, 100.0 * a->encendido, a->periodo_ms * a->encendido / 6);
+}
+
+#endif
@@ -0,0 +1,78 @@
+// Antirrebote: un contador por entrada contra los contadores verticales.
+//
+// Antes cada botón o tecla tenía su contador y el tick recorría las entradas
+// una por una; ahora antirrebote32_muestra filtra hasta 32 entradas con unas
+// cuantas operaciones sobre palabras. Se miden 10^7 muestras con 1, 4, 16 y
+// 32 entradas activas (con rebotes) por los dos caminos, que deben terminar
+// con el mismo estado.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../Antirrebote32.h"
+
+#define MUESTRAS 10000000
+#define PATRONES 4096
+
+static uint32_t entradas[PATRONES];
+
+// Camino anterior: contador por entrada, 4 muestras diferentes seguidas para cambiar
+typedef struct {
+    uint8_t cuenta[32];
+    uint32_t estado;
+} porEntrada_t;
+
+static __attribute__((noinline)) uint32_t muestraPorEntrada(porEntrada_t *p, uint32_t entrada, int n) {
+    uint32_t cambios = 0;
+    for (int k = 0; k < n; k++) {
+        uint32_t bit = 1UL << k;
+        if ((entrada ^ p->estado) & bit) {
+            if (++p->cuenta[k] == 4) {
+                p->cuenta[k] = 0;
+                p->estado ^= bit;
+                cambios |= bit;
+            }
+        } else {
+            p->cuenta[k] = 0;
+        }
+    }
+    return cambios;
+}
+
+static __attribute__((noinline)) uint32_t muestraVertical(antirrebote32_t *a, uint32_t entrada, uint32_t mascara) {
+    return antirrebote32_muestra(a, entrada, mascara);
+}
+
+static void medir(int n) {
+    uint32_t mascara = n == 32 ? 0xFFFFFFFF : (1UL << n) - 1;
+
+    porEntrada_t p = {0};
+    uint32_t cambios = 0;
+    uint64_t inicio = reloj_ns();
+    for (uint32_t i = 0; i < MUESTRAS; i++) cambios += muestraPorEntrada(&p, entradas[i % PATRONES] & mascara, n) != 0;
+    uint64_t porEntrada = reloj_ns() - inicio;
+    CONSUMIR(cambios);
+
+    antirrebote32_t a = {0};
+    cambios = 0;
+    inicio = reloj_ns();
+    for (uint32_t i = 0; i < MUESTRAS; i++) cambios += muestraVertical(&a, entradas[i % PATRONES], mascara) != 0;
+    uint64_t vertical = reloj_ns() - inicio;
+    CONSUMIR(cambios);
+
+    COMPROBAR(a.estado == p.estado, "%d entradas: estado %08lx, por entrada %08lx", n, (unsigned long)a.estado,
+              (unsigned long)p.estado);
+    printf("%2d entradas: por entrada %6.2f ns, vertical %5.2f ns por muestra (%.1fx)\n", n,
+           (double)porEntrada / MUESTRAS, (double)vertical / MUESTRAS, (double)porEntrada / vertical);
+}
+
+int main(void) {
+    // Entradas que cambian cada tanto con rebotes de unas cuantas muestras
+    uint32_t firme = 0;
+    for (int i = 0; i < PATRONES; i++) {
+        if (i % 64 == 0) firme ^= rand();
+        entradas[i] = i % 64 < 3 ? firme ^ rand() : firme;
+    }
+    static const int cantidades[] = {1, 4, 16, 32};
+    for (size_t i = 0; i < sizeof(cantidades) / sizeof(cantidades[0]); i++) medir(cantidades[i]);
+    return prueba_fin("medicion_antirrebote32");
+}
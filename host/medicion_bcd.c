@@ -0,0 +1,102 @@
+// Contador de la práctica 5: descomposición con div/mod contra BCD incremental.
+//
+// Antes, cada vuelta del ciclo del display descomponía el contador binario con
+// tres divisiones y dos módulos; ahora el ISR avanza el contador en BCD con
+// acarreo y recalcula el frame solo cuando cambia. Se miden 10^7 actualizaciones
+// de cada camino y 10^7 vueltas del display (el contador cambia cada 100 vueltas),
+// y se comprueba que los dos caminos dan los mismos frames.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../Practica_5.c"
+
+#define ACTUALIZACIONES 10000000
+#define VUELTAS_POR_CAMBIO 100
+
+// Camino anterior: contador binario y descomposición en cada uso
+static volatile uint16_t contadorBinario;
+static volatile uint32_t frameBinario[3];
+
+static void decodifica_Numero(uint16_t numero, uint8_t *centenas_var, uint8_t *decenas_var, uint8_t *unidades_var) {
+    *centenas_var = numero / 100;
+    *decenas_var = (numero % 100) / 10;
+    *unidades_var = numero % 10;
+}
+
+static void actualizaFrameBinario(uint16_t numero) {
+    uint8_t c, d, u;
+    decodifica_Numero(numero, &c, &d, &u);
+    frameBinario[0] = mascaraCatodos[0] | seg7Fuente[SEG7_0 + u].set0;
+    frameBinario[1] = mascaraCatodos[1] | seg7Fuente[SEG7_0 + d].set0;
+    frameBinario[2] = mascaraCatodos[2] | seg7Fuente[SEG7_0 + c].set0;
+}
+
+static void incrementaBinario(void) {
+    uint16_t siguiente = contadorBinario + 1;
+    if (siguiente > 999) siguiente = 0;
+    contadorBinario = siguiente;
+}
+
+int main(void) {
+    // Mismos frames en las 1000 posiciones y en la vuelta 999 -> 000
+    contador = 0;
+    contadorBinario = 0;
+    for (int i = 0; i < 2500; i++) {
+        incrementaBinario();
+        contador = incrementaBCD(contador);
+        actualizaFrameBinario(contadorBinario);
+        actualizaFrame(contador);
+        for (int d = 0; d < 3; d++) {
+            COMPROBAR(frameBinario[d] == frameDisplay[d], "valor %u: dígito %d difiere", contadorBinario, d);
+        }
+    }
+
+    // Actualizaciones: lo que hace el ISR del contador con cada incremento
+    uint64_t inicio = reloj_ns();
+    for (uint32_t i = 0; i < ACTUALIZACIONES; i++) {
+        incrementaBinario();
+        actualizaFrameBinario(contadorBinario);
+    }
+    uint64_t divmod = reloj_ns() - inicio;
+
+    inicio = reloj_ns();
+    for (uint32_t i = 0; i < ACTUALIZACIONES; i++) {
+        uint16_t siguiente = incrementaBCD(contador);
+        contador = siguiente;
+        generacionContador++;
+        actualizaFrame(siguiente);
+    }
+    uint64_t bcd = reloj_ns() - inicio;
+
+    // Vueltas del display: antes se descomponía en todas, ahora solo si cambió la generación
+    inicio = reloj_ns();
+    for (uint32_t i = 0; i < ACTUALIZACIONES; i++) {
+        if (i % VUELTAS_POR_CAMBIO == 0) incrementaBinario();
+        decodifica_Numero(contadorBinario, &centenas, &decenas, &unidades);
+        CONSUMIR(unidades);
+    }
+    uint64_t vueltasDivmod = reloj_ns() - inicio;
+
+    inicio = reloj_ns();
+    uint32_t ultimaGeneracion = generacionContador - 1;
+    for (uint32_t i = 0; i < ACTUALIZACIONES; i++) {
+        if (i % VUELTAS_POR_CAMBIO == 0) {
+            contador = incrementaBCD(contador);
+            generacionContador++;
+        }
+        uint32_t generacion = generacionContador;
+        if (generacion != ultimaGeneracion) {
+            decodifica_BCD(contador, &centenas, &decenas, &unidades);
+            ultimaGeneracion = generacion;
+        }
+        CONSUMIR(unidades);
+    }
+    uint64_t vueltasBcd = reloj_ns() - inicio;
+
+    printf("10^7 actualizaciones: div/mod %.2f ns, BCD incremental %.2f ns (%.2fx)\n",
+           (double)divmod / ACTUALIZACIONES, (double)bcd / ACTUALIZACIONES, (double)divmod / bcd);
+    printf("10^7 vueltas del display: div/mod %.2f ns, generación %.2f ns (%.2fx)\n",
+           (double)vueltasDivmod / ACTUALIZACIONES, (double)vueltasBcd / ACTUALIZACIONES,
+           (double)vueltasDivmod / vueltasBcd);
+    return prueba_fin("medicion_bcd");
+}
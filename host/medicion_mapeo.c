@@ -0,0 +1,65 @@
+// Ángulo a pulso: grados_a_us() con división contra las tablas de MapeoServo.h.
+//
+// Antes cada ángulo (grados enteros) pasaba por una multiplicación y una
+// división entre 180 para dar us; ahora cada ángulo en décimas de grado busca
+// su segmento en la tabla del servo e interpola con divisiones entre 100, que
+// el compilador hace multiplicaciones. Se miden 10^7 conversiones de cada
+// camino sobre ángulos pseudoaleatorios.
+//
+// La división entre 180 tampoco era una división: el compilador la cambia por
+// una multiplicación. La tabla hace unas cuantas operaciones más (buscar el
+// segmento e interpolar) y cuesta alrededor del doble, a cambio de 10 veces
+// la resolución y la forma real de cada servo.
+
+#include "prueba.h"
+#include "falsos.h"
+
+#define MAPEO_CALIBRACIONES { MAPEO_LINEAL(500, 2500) }
+#include "../MapeoServo.h"
+
+#define CONVERSIONES 10000000
+#define ANGULOS 4096
+
+// Camino anterior, tal cual: los extremos eran variables globales (no se pueden
+// volver constantes al compilar) y la división es entre 180
+int tiempoCeroGrados = 500;
+int tiempo180Grados = 2500;
+
+static __attribute__((noinline)) uint32_t grados_a_us(int grados) {
+    return (tiempoCeroGrados + ((tiempo180Grados - tiempoCeroGrados) * grados / 180));
+}
+
+static __attribute__((noinline)) uint32_t ticksServo(int decigrados) {
+    return mapeo_ticks(0, decigrados);
+}
+
+static int grados[ANGULOS], decigrados[ANGULOS];
+
+int main(void) {
+    for (int i = 0; i < ANGULOS; i++) {
+        decigrados[i] = rand() % (MAPEO_MAXIMO + 1);
+        grados[i] = decigrados[i] / 10;
+    }
+
+    uint64_t inicio = reloj_ns();
+    uint32_t suma = 0;
+    for (uint32_t i = 0; i < CONVERSIONES; i++) suma += grados_a_us(grados[i % ANGULOS]);
+    CONSUMIR(suma);
+    uint64_t division = reloj_ns() - inicio;
+
+    inicio = reloj_ns();
+    suma = 0;
+    for (uint32_t i = 0; i < CONVERSIONES; i++) suma += ticksServo(decigrados[i % ANGULOS]);
+    CONSUMIR(suma);
+    uint64_t tabla = reloj_ns() - inicio;
+
+    // La tabla con un servo lineal da lo mismo que la división (a menos de 1 us)
+    for (int g = 0; g <= 180; g++) {
+        int32_t diferencia = (int32_t)MAPEO_TICKS_A_US(ticksServo(g * 10)) - (int32_t)grados_a_us(g);
+        COMPROBAR(abs(diferencia) <= 1, "%d grados: difiere %ld us", g, (long)diferencia);
+    }
+
+    printf("10^7 conversiones: grados_a_us %.2f ns (1 grado, 1 us), tabla %.2f ns (0.1 grados, 0.31 us) (%.2fx)\n",
+           (double)division / CONVERSIONES, (double)tabla / CONVERSIONES, (double)division / tabla);
+    return prueba_fin("medicion_mapeo");
+}
@@ -0,0 +1,51 @@
+// Codificadores de PatronRMT.h: símbolos por segundo.
+//
+// Dos cargas: una tira de 1000 WS2812 (24 bits por LED, un símbolo por bit) con
+// patronRMT_codificarBits y un tren de 4096 pulsos de duraciones al azar con
+// patronRMT_codificarPulsos. Se comparan con lo que saca el RMT: un bit de
+// WS2812 dura 1.25 us (800k símbolos/s), así que codificar una trama completa
+// antes de enviarla debe tomar mucho menos que su transmisión.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../PatronRMT.h"
+
+#define LEDS 1000
+#define BITS_TIRA (LEDS * 24)
+#define PULSOS 4096
+#define VUELTAS 2000
+#define SIMBOLOS_WS2812_S 800000.0
+
+static uint8_t colores[LEDS * 3];
+static rmt_symbol_word_t simbolos[BITS_TIRA];
+static pulsoRMT_t pulsos[PULSOS];
+
+int main(void) {
+    for (int i = 0; i < LEDS * 3; i++) colores[i] = rand();
+    for (int i = 0; i < PULSOS; i++) pulsos[i] = (pulsoRMT_t){i & 1, 1 + rand() % 2000};
+    const rmt_symbol_word_t bit0 = patronRMT_simbolo(PATRON_US(4) / 10, PATRON_US(85) / 10);
+    const rmt_symbol_word_t bit1 = patronRMT_simbolo(PATRON_US(8) / 10, PATRON_US(45) / 10);
+
+    uint64_t inicio = reloj_ns();
+    int n = 0;
+    for (int v = 0; v < VUELTAS; v++) {
+        n = patronRMT_codificarBits(colores, BITS_TIRA, bit0, bit1, simbolos, BITS_TIRA);
+        CONSUMIR(simbolos[v % BITS_TIRA].val);
+    }
+    double bits_s = (double)BITS_TIRA * VUELTAS / ((reloj_ns() - inicio) * 1e-9);
+    COMPROBAR(n == BITS_TIRA, "la tira dio %d símbolos", n);
+
+    inicio = reloj_ns();
+    for (int v = 0; v < VUELTAS; v++) {
+        n = patronRMT_codificarPulsos(pulsos, PULSOS, simbolos, BITS_TIRA);
+        CONSUMIR(simbolos[v % PULSOS].val);
+    }
+    double pulsos_s = (double)n * VUELTAS / ((reloj_ns() - inicio) * 1e-9);
+    COMPROBAR(n == PULSOS / 2, "%d pulsos dieron %d símbolos", PULSOS, n);
+
+    COMPROBAR(bits_s > 10 * SIMBOLOS_WS2812_S, "bits: %.0f símbolos/s, el RMT saca %.0f", bits_s, SIMBOLOS_WS2812_S);
+    printf("Bits (WS2812, %d LEDs): %.1f M símbolos/s, %.1f us por tira (%.1f ms en el cable)\n", LEDS, bits_s / 1e6,
+           BITS_TIRA / bits_s * 1e6, BITS_TIRA / SIMBOLOS_WS2812_S * 1e3);
+    printf("Pulsos (%d al azar): %.1f M símbolos/s\n", PULSOS, pulsos_s / 1e6);
+    return prueba_fin("medicion_patron_rmt");
+}
@@ -0,0 +1,89 @@
+// Un paso del planificador de movimiento: el perfil continuo contra el discreto.
+//
+// Antes plan_paso calculaba la velocidad de frenado con sqrt(2 a d), que en el
+// último paso deja al servo más rápido de lo que puede frenar: se pasaba del
+// objetivo y regresaba. Ahora la velocidad sale de la distancia de frenado en
+// pasos discretos (una raíz, un floor y una división más) y el último paso
+// cae justo en el objetivo. Se miden 10^7 pasos de cada camino con objetivos
+// al azar, como los del banco de servos (6 servos, 50 Hz), y el sobrepaso
+// máximo de cada uno.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../PlanMovimiento.h"
+
+#define PASOS 10000000
+#define SERVOS 6
+#define OBJETIVOS 4096
+#define DT (1.0f / 50)
+
+static float objetivos[OBJETIVOS];
+
+// Camino anterior, tal cual
+static __attribute__((noinline)) float pasoContinuo(planMovimiento_t *plan, float dt) {
+    float distancia = plan->objetivo - plan->posicion;
+    float dv = plan->aMax * dt;
+    if (fabsf(distancia) <= fabsf(plan->velocidad) * dt + 1e-3f && fabsf(plan->velocidad) <= dv) {
+        plan->posicion = plan->objetivo;
+        plan->velocidad = 0.0f;
+        return plan->posicion;
+    }
+    float deseada = sqrtf(2.0f * plan->aMax * fabsf(distancia));
+    if (deseada > plan->vMax) deseada = plan->vMax;
+    if (distancia < 0) deseada = -deseada;
+    float cambio = deseada - plan->velocidad;
+    if (cambio > dv) cambio = dv;
+    if (cambio < -dv) cambio = -dv;
+    plan->velocidad += cambio;
+    plan->posicion += plan->velocidad * dt;
+    return plan->posicion;
+}
+
+static __attribute__((noinline)) float pasoDiscreto(planMovimiento_t *plan, float dt) {
+    return plan_paso(plan, dt);
+}
+
+// Los servos del banco: un objetivo nuevo al llegar; regresa el tiempo y el peor sobrepaso
+static uint64_t medir(float (*paso)(planMovimiento_t *, float), float *sobrepaso) {
+    planMovimiento_t planes[SERVOS];
+    float inicio[SERVOS];
+    for (int k = 0; k < SERVOS; k++) {
+        plan_iniciar(&planes[k], 90.0f, 180.0f, 360.0f);
+        inicio[k] = 90.0f;
+    }
+    uint32_t siguiente = 0;
+    float peor = 0, suma = 0;
+    uint64_t t = reloj_ns();
+    for (uint32_t i = 0; i < PASOS / SERVOS; i++) {
+        for (int k = 0; k < SERVOS; k++) {
+            planMovimiento_t *p = &planes[k];
+            if (!plan_enMovimiento(p)) {
+                inicio[k] = p->posicion;
+                plan_objetivo(p, objetivos[siguiente++ % OBJETIVOS]);
+            }
+            float posicion = paso(p, DT);
+            suma += posicion;
+            float pasado = p->objetivo > inicio[k] ? posicion - p->objetivo : p->objetivo - posicion;
+            if (pasado > peor) peor = pasado;
+        }
+    }
+    t = reloj_ns() - t;
+    CONSUMIR(suma);
+    *sobrepaso = peor;
+    return t;
+}
+
+int main(void) {
+    for (int i = 0; i < OBJETIVOS; i++) objetivos[i] = (rand() % 1801) / 10.0f;
+
+    float sobrepasoContinuo, sobrepasoDiscreto;
+    uint64_t continuo = medir(pasoContinuo, &sobrepasoContinuo);
+    uint64_t discreto = medir(pasoDiscreto, &sobrepasoDiscreto);
+
+    COMPROBAR(sobrepasoDiscreto <= 1e-3f, "el perfil discreto se pasa %.4f grados", sobrepasoDiscreto);
+    printf("10^7 pasos: continuo %.2f ns (sobrepaso hasta %.3f grados), discreto %.2f ns (%.4f grados)\n",
+           (double)continuo / PASOS, sobrepasoContinuo, (double)discreto / PASOS, sobrepasoDiscreto);
+    printf("Banco de %d servos a 50 Hz: %.2f us de cada 20 ms por periodo\n", SERVOS,
+           (double)discreto / PASOS * SERVOS / 1000);
+    return prueba_fin("medicion_plan_paso");
+}
@@ -0,0 +1,81 @@
+// Cambios de un barrido del teclado 4x4: tecla por tecla contra el mapa de bits.
+//
+// Antes cada tecla se comparaba por separado con su estado anterior y cada
+// cambio salía como un evento (tecla, tipo); ahora teclado4x4_diferencia saca
+// todos los cambios del barrido con un XOR y revisa fantasmas. Se miden 10^7
+// barridos de cada camino sobre una secuencia de mapas como la de un teclado
+// en uso: la mayoría de los barridos no cambia nada y de vez en cuando se
+// presiona o se suelta una tecla. Los dos caminos deben contar los mismos
+// cambios mientras no haya fantasmas.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../Teclado4x4.h"
+
+#define BARRIDOS 10000000
+#define MAPAS 4096
+#define BARRIDOS_POR_CAMBIO 20
+
+static uint16_t mapas[MAPAS];
+
+// Camino anterior: un evento por tecla que cambia
+typedef struct {
+    char tecla;
+    uint8_t tipo;
+} eventoAnterior_t;
+
+static const char teclas[17] = "123A456B789C*0#D";
+static eventoAnterior_t eventos[16];
+
+static __attribute__((noinline)) int cambiosPorTecla(uint16_t *anterior, uint16_t leido) {
+    int n = 0;
+    for (int k = 0; k < 16; k++) {
+        uint16_t bit = 1 << k;
+        if ((leido & bit) && !(*anterior & bit)) {
+            *anterior |= bit;
+            eventos[n++] = (eventoAnterior_t){teclas[k], 1};
+        } else if (!(leido & bit) && (*anterior & bit)) {
+            *anterior &= ~bit;
+            eventos[n++] = (eventoAnterior_t){teclas[k], 0};
+        }
+    }
+    return n;
+}
+
+static __attribute__((noinline)) int cambiosMapa(uint16_t *anterior, uint16_t leido) {
+    teclado4x4Cambios_t cambios = teclado4x4_diferencia(*anterior, leido);
+    *anterior = cambios.estado;
+    return __builtin_popcount(cambios.presionadas | cambios.liberadas);
+}
+
+int main(void) {
+    // Hasta dos teclas a la vez, nunca ambiguo
+    uint16_t mapa = 0;
+    for (int i = 0; i < MAPAS; i++) {
+        if (i % BARRIDOS_POR_CAMBIO == 0) {
+            uint16_t bit = 1 << (rand() % 16);
+            if ((mapa & bit) || __builtin_popcount(mapa) < 2) mapa ^= bit;
+        }
+        mapas[i] = mapa;
+    }
+
+    uint16_t anterior = 0;
+    uint32_t cambiosAntes = 0;
+    uint64_t inicio = reloj_ns();
+    for (uint32_t i = 0; i < BARRIDOS; i++) cambiosAntes += cambiosPorTecla(&anterior, mapas[i % MAPAS]);
+    uint64_t porTecla = reloj_ns() - inicio;
+    CONSUMIR(eventos[0].tecla);
+
+    anterior = 0;
+    uint32_t cambiosAhora = 0;
+    inicio = reloj_ns();
+    for (uint32_t i = 0; i < BARRIDOS; i++) cambiosAhora += cambiosMapa(&anterior, mapas[i % MAPAS]);
+    uint64_t porMapa = reloj_ns() - inicio;
+
+    COMPROBAR(cambiosAntes == cambiosAhora, "tecla por tecla %lu cambios, mapa %lu", (unsigned long)cambiosAntes,
+              (unsigned long)cambiosAhora);
+    printf("10^7 barridos (%lu cambios): tecla por tecla %.2f ns, mapa con fantasmas %.2f ns (%.2fx)\n",
+           (unsigned long)cambiosAhora, (double)porTecla / BARRIDOS, (double)porMapa / BARRIDOS,
+           (double)porTecla / porMapa);
+    return prueba_fin("medicion_teclado4x4");
+}
@@ -0,0 +1,83 @@
+// Rueda de tiempo de TimersSoft.h con 10 a 10000 timers.
+//
+// Para cada cantidad se arman timers periódicos con periodos al azar de 10 a
+// 2000 ticks, se dan 100k ticks a la ISR de la rueda y se cancelan todos. Armar
+// y cancelar deben costar lo mismo con cualquier cantidad; el tick cuesta lo
+// que cuestan sus disparos. Como referencia, el mismo trabajo con una tabla que
+// el tick recorre completa (un contador por timer), que crece con la cantidad.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../TimersSoft.h"
+
+#define MAXIMO_TIMERS 10000
+#define TICKS 100000
+
+static timerSoft_t timers[MAXIMO_TIMERS];
+static uint32_t periodos[MAXIMO_TIMERS];
+static uint32_t disparos;
+
+static bool contar(void *arg) {
+    disparos++;
+    return false;
+}
+
+// Referencia: cada tick revisa todos los timers
+typedef struct {
+    uint32_t vence, periodo;
+} timerTabla_t;
+
+static timerTabla_t tabla[MAXIMO_TIMERS];
+
+static __attribute__((noinline)) void tickTabla(uint32_t ahora, int n) {
+    for (int i = 0; i < n; i++) {
+        if (tabla[i].vence == ahora) {
+            tabla[i].vence += tabla[i].periodo;
+            contar(NULL);
+        }
+    }
+}
+
+static void medir(int n) {
+    for (int i = 0; i < n; i++) {
+        periodos[i] = 10 + rand() % 1991;
+        timerSoft_crear(&timers[i], contar, NULL, TIMER_SOFT_ISR);
+    }
+
+    uint64_t inicio = reloj_ns();
+    for (int i = 0; i < n; i++) timerSoft_armar(&timers[i], periodos[i], periodos[i]);
+    uint64_t armar = reloj_ns() - inicio;
+
+    disparos = 0;
+    inicio = reloj_ns();
+    for (int t = 0; t < TICKS; t++) timersSoft_tick(NULL, NULL, NULL);
+    uint64_t ticks = reloj_ns() - inicio;
+    uint32_t disparosRueda = disparos;
+
+    inicio = reloj_ns();
+    for (int i = 0; i < n; i++) timerSoft_cancelar(&timers[i]);
+    uint64_t cancelar = reloj_ns() - inicio;
+
+    for (int i = 0; i < n; i++) tabla[i] = (timerTabla_t){.vence = periodos[i], .periodo = periodos[i]};
+    disparos = 0;
+    inicio = reloj_ns();
+    for (uint32_t t = 1; t <= TICKS; t++) tickTabla(t, n);
+    uint64_t ticksTabla = reloj_ns() - inicio;
+
+    COMPROBAR(disparos == disparosRueda, "%d timers: %lu disparos en la rueda, %lu en la tabla", n,
+              (unsigned long)disparosRueda, (unsigned long)disparos);
+    printf("%6d timers: armar %5.1f ns, cancelar %5.1f ns, tick %8.1f ns (%6.2f disparos, %5.1f ns c/u), "
+           "tabla %9.1f ns por tick\n",
+           n, (double)armar / n, (double)cancelar / n, (double)ticks / TICKS, (double)disparosRueda / TICKS,
+           disparosRueda ? (double)ticks / disparosRueda : 0.0, (double)ticksTabla / TICKS);
+}
+
+int main(void) {
+    COMPROBAR(timersSoft_iniciar() == ESP_OK, "timersSoft_iniciar");
+    static const int cantidades[] = {10, 100, 1000, 10000};
+    for (size_t i = 0; i < sizeof(cantidades) / sizeof(cantidades[0]); i++) {
+        timersSoft.ahora = 0;   // Los dos caminos cuentan desde el tick 0
+        medir(cantidades[i]);
+    }
+    return prueba_fin("medicion_timers_soft");
+}
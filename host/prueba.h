@@ -0,0 +1,39 @@
+#ifndef PRUEBA_H
+#define PRUEBA_H
+
+// Lo mínimo para las pruebas y mediciones en la PC: comprobaciones que cuentan
+// fallas sin detenerse y un reloj monotónico en nanosegundos.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static int pruebaFallas;
+
+#define COMPROBAR(condicion, ...) do {                                   \
+    if (!(condicion)) {                                                  \
+        pruebaFallas++;                                                  \
+        printf("FALLA %s:%d: ", __FILE__, __LINE__);                     \
+        printf(__VA_ARGS__);                                             \
+        printf("\n");                                                    \
+    }                                                                    \
+} while (0)
+
+// Regresa el código de salida del programa de prueba
+static inline int prueba_fin(const char *nombre) {
+    printf("%s: %s\n", nombre, pruebaFallas ? "FALLA" : "bien");
+    return pruebaFallas != 0;
+}
+
+static inline uint64_t reloj_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + t.tv_nsec;
+}
+
+// Evita que el compilador descarte un cálculo cuyo resultado no se usa
+#define CONSUMIR(x) __asm__ volatile("" : : "r"(x) : "memory")
+
+#endif
@@ -0,0 +1,139 @@
+// Antirrebote con contadores verticales de Antirrebote32.h.
+//
+// Casos fijos de una entrada: el cambio se acepta justo en la cuarta muestra
+// diferente seguida, una muestra igual reinicia la cuenta y las entradas fuera
+// de la máscara no cambian ni pierden su cuenta. Después, secuencias de rebote
+// (ráfagas de menos de 4 muestras antes de quedar firme) en 32 entradas con
+// máscaras al azar contra un modelo de un contador por entrada: mismo estado,
+// mismos cambios y mismas entradas ocupadas en cada muestra.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../Antirrebote32.h"
+
+#define MUESTRAS 2000000
+#define MUESTRAS_CAMBIO 4
+
+// Modelo: un contador por entrada
+typedef struct {
+    uint8_t cuenta[32];
+    uint32_t estado;
+} modelo_t;
+
+static uint32_t modelo_muestra(modelo_t *m, uint32_t entrada, uint32_t mascara) {
+    uint32_t cambios = 0;
+    for (int k = 0; k < 32; k++) {
+        uint32_t bit = 1UL << k;
+        if (!(mascara & bit)) continue;
+        if ((entrada ^ m->estado) & bit) {
+            if (++m->cuenta[k] == MUESTRAS_CAMBIO) {
+                m->cuenta[k] = 0;
+                m->estado ^= bit;
+                cambios |= bit;
+            }
+        } else {
+            m->cuenta[k] = 0;
+        }
+    }
+    return cambios;
+}
+
+static uint32_t modelo_ocupadas(const modelo_t *m) {
+    uint32_t ocupadas = 0;
+    for (int k = 0; k < 32; k++) {
+        if (m->cuenta[k]) ocupadas |= 1UL << k;
+    }
+    return ocupadas;
+}
+
+// Una entrada (bit 5) con la secuencia dada; regresa en qué muestra cambió (-1 = no cambió)
+static int cambioEn(antirrebote32_t *a, const char *muestras) {
+    for (int i = 0; muestras[i]; i++) {
+        uint32_t cambios = antirrebote32_muestra(a, muestras[i] == '1' ? 1u << 5 : 0, 1u << 5);
+        if (cambios) return i;
+    }
+    return -1;
+}
+
+static void revisarFijos(void) {
+    antirrebote32_t a = {0};
+    COMPROBAR(cambioEn(&a, "111") == -1 && a.estado == 0, "cambió con 3 muestras");
+    a = (antirrebote32_t){0};
+    COMPROBAR(cambioEn(&a, "1111") == 3 && a.estado == 1u << 5, "no cambió en la cuarta muestra");
+    COMPROBAR(antirrebote32_ocupadas(&a) == 0, "ocupada después de cambiar");
+
+    // Una muestra igual en medio reinicia: hacen falta 4 más
+    a = (antirrebote32_t){0};
+    COMPROBAR(cambioEn(&a, "1110111") == -1, "cambió con la cuenta reiniciada");
+    COMPROBAR(antirrebote32_ocupadas(&a) == 1u << 5, "sin cuenta a media secuencia");
+    a = (antirrebote32_t){0};
+    COMPROBAR(cambioEn(&a, "11101111") == 7, "no cambió 4 muestras después del reinicio");
+    // Y de regreso a 0 con rebote
+    COMPROBAR(cambioEn(&a, "0010100000") == 8, "la liberación no cambió en la cuarta muestra firme");
+    COMPROBAR(a.estado == 0, "estado %08lx después de liberar", (unsigned long)a.estado);
+
+    // Fuera de la máscara: ni estado ni cuenta cambian, aunque la entrada sea distinta
+    a = (antirrebote32_t){0};
+    antirrebote32_muestra(&a, 0xFFFFFFFF, 1u << 5);
+    antirrebote32_muestra(&a, 0xFFFFFFFF, 1u << 5);
+    for (int i = 0; i < 10; i++) {
+        uint32_t cambios = antirrebote32_muestra(&a, 0xFFFFFFFF, 1u << 9);
+        COMPROBAR(!(cambios & (1u << 5)), "la entrada fuera de la máscara cambió");
+    }
+    COMPROBAR(a.estado == 1u << 9, "estado %08lx con la máscara de la entrada 9", (unsigned long)a.estado);
+    COMPROBAR(antirrebote32_ocupadas(&a) == 1u << 5, "la entrada 5 perdió su cuenta fuera de la máscara");
+    antirrebote32_muestra(&a, 0xFFFFFFFF, 1u << 5);
+    COMPROBAR(a.estado == 1u << 9, "la entrada 5 cambió con 3 muestras");
+    COMPROBAR(antirrebote32_muestra(&a, 0xFFFFFFFF, 1u << 5) == 1u << 5, "la entrada 5 no retomó su cuenta");
+}
+
+static uint32_t azar(void) {
+    static uint32_t x = 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// 32 entradas que cambian de vez en cuando; cada cambio llega con una ráfaga
+// de rebotes de 1 a 3 muestras
+static void revisarRebotes(void) {
+    uint32_t firme = 0, rebote[32] = {0};
+    antirrebote32_t a = {0};
+    modelo_t m = {0};
+    uint32_t aceptados = 0;
+    for (int i = 0; i < MUESTRAS; i++) {
+        uint32_t entrada = firme;
+        for (int k = 0; k < 32; k++) {
+            if (rebote[k]) {
+                rebote[k]--;
+                if (azar() & 1) entrada ^= 1UL << k;
+            } else if (azar() % 500 == 0) {
+                firme ^= 1UL << k;
+                entrada ^= 1UL << k;
+                rebote[k] = 1 + azar() % 3;
+            }
+        }
+        // A veces solo se muestrea parte de las entradas
+        uint32_t mascara = azar() % 4 ? 0xFFFFFFFF : azar();
+
+        uint32_t cambios = antirrebote32_muestra(&a, entrada, mascara);
+        uint32_t esperados = modelo_muestra(&m, entrada, mascara);
+        aceptados += __builtin_popcount(cambios);
+        if (cambios != esperados || a.estado != m.estado || antirrebote32_ocupadas(&a) != modelo_ocupadas(&m)) {
+            COMPROBAR(false, "muestra %d: cambios %08lx (modelo %08lx), estado %08lx (modelo %08lx)", i,
+                      (unsigned long)cambios, (unsigned long)esperados, (unsigned long)a.estado,
+                      (unsigned long)m.estado);
+            return;
+        }
+        COMPROBAR((cambios & ~mascara) == 0, "muestra %d: cambió fuera de la máscara", i);
+    }
+    printf("%d muestras de 32 entradas con rebotes: %lu cambios aceptados, igual que un contador por entrada\n",
+           MUESTRAS, (unsigned long)aceptados);
+}
+
+int main(void) {
+    revisarFijos();
+    revisarRebotes();
+    return prueba_fin("prueba_antirrebote32");
+}
@@ -0,0 +1,217 @@
+// Servicio de botones de la práctica 1 con rebotes simulados en GPIO.in.
+//
+// Cada pulsación cambia el nivel del pin varias veces al azar durante unos ms
+// antes de quedar firme; el cambio llama al manejador del pin si su
+// interrupción está activa (flancoBoton) y el gptimer falso da los ticks de
+// tickBotones cada 2 ms. La tarea recibe los eventos en cuanto salen.
+//
+// Se revisa que cada pulsación dé una sola presión y una sola liberación con
+// la marca del primer flanco, que lleguen más de 6 ms después del flanco (8 ms
+// si el flanco arrancó el timer) y a más tardar 8 ms después del último
+// rebote, que el rebote no vuelva a interrumpir (ni un pico de ruido sin
+// cambio), que la pulsación larga llegue a los 800 ms y las repeticiones cada
+// 1000 ms (50 ms con el botón de velocidad) y que el timer se detenga al soltar
+// todo. Al final se imprime el histograma de latencias de la práctica.
+
+#include "prueba.h"
+#include "falsos.h"
+
+#undef ESP_LOGI
+#define ESP_LOGI(tag, ...) ((void)(tag))
+#include "../Practica_1.c"
+
+#define PASO_US 10
+#define PULSACIONES 300
+#define MAXIMO_RECIBIDOS 256
+
+typedef struct {
+    int64_t llegada;
+    eventoBoton_t evento;
+} recibido_t;
+
+static recibido_t recibidos[MAXIMO_RECIBIDOS];
+static int nRecibidos;
+
+static uint32_t azar(void) {
+    static uint32_t x = 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// Avanza el reloj y el gptimer; la tarea de app_main atiende cada evento al llegar
+static void avanzar(int64_t hasta) {
+    while (relojFalso_us < hasta) {
+        relojFalso_us += PASO_US;
+        gptimerFalso_avanzar(timerBotones, PASO_US);
+        eventoBoton_t evento;
+        while (xQueueReceive(colaBotones, &evento, 0) == pdTRUE) {
+            if (evento.tipo == EVENTO_PRESION || evento.tipo == EVENTO_LIBERACION) {
+                registrarLatencia(esp_timer_get_time() - evento.tiempo_us);
+            }
+            if (nRecibidos < MAXIMO_RECIBIDOS) recibidos[nRecibidos++] = (recibido_t){relojFalso_us, evento};
+        }
+    }
+}
+
+// Lleva el pin a "nivel" con rebotes de hasta "rebote_us"; regresa el instante
+// del último cambio (el del primer flanco queda en *flanco)
+static int64_t rebotar(int pin, int nivel, int64_t rebote_us, int64_t *flanco) {
+    *flanco = relojFalso_us;
+    gpioFalso_entrada(pin, nivel);
+    int64_t fin = relojFalso_us + rebote_us, ultimo = relojFalso_us;
+    int actual = nivel;
+    while (rebote_us > 0) {
+        avanzar(relojFalso_us + 50 + azar() % 400);
+        if (relojFalso_us >= fin) break;
+        actual = !actual;
+        gpioFalso_entrada(pin, actual);
+        ultimo = relojFalso_us;
+    }
+    if (actual != nivel) {
+        gpioFalso_entrada(pin, nivel);
+        ultimo = relojFalso_us;
+    }
+    return ultimo;
+}
+
+// Un evento de presión o liberación: uno solo, con la marca del primer flanco
+// y a tiempo. Regresa su índice en recibidos (-1 si no llegó)
+static int revisarCambio(int desde, int boton, uint8_t tipo, int64_t flanco, int64_t firme) {
+    int encontrado = -1, cuantos = 0;
+    for (int i = desde; i < nRecibidos; i++) {
+        if (recibidos[i].evento.boton == boton && recibidos[i].evento.tipo == tipo) {
+            if (encontrado < 0) encontrado = i;
+            cuantos++;
+        }
+    }
+    COMPROBAR(cuantos == 1, "botón %d, %s: %d eventos", boton, nombresEventos[tipo], cuantos);
+    if (encontrado < 0) return -1;
+    const recibido_t *r = &recibidos[encontrado];
+    // Si el timer ya corría, la primera muestra cae hasta un tick antes
+    int64_t minimo = flanco + 3 * TICK_BOTONES_US;
+    if (minimo < firme) minimo = firme;
+    COMPROBAR(r->evento.tiempo_us == flanco, "botón %d, %s: marca %lld, primer flanco %lld", boton,
+              nombresEventos[tipo], (long long)r->evento.tiempo_us, (long long)flanco);
+    COMPROBAR(r->llegada > minimo && r->llegada <= firme + 4 * TICK_BOTONES_US,
+              "botón %d, %s: llegó %lld us después del flanco (firme a los %lld)", boton, nombresEventos[tipo],
+              (long long)(r->llegada - flanco), (long long)(firme - flanco));
+    return encontrado;
+}
+
+// Pulsaciones cortas al azar en los cuatro botones, de una en una
+static void revisarPulsaciones(void) {
+    for (int p = 0; p < PULSACIONES; p++) {
+        int boton = azar() % NUM_BOTONES, pin = pinesBotones[boton];
+        int desde = nRecibidos;
+        uint32_t interrupciones = gpioFalsoInterrupciones;
+        int64_t flancoPresion, flancoLiberacion;
+
+        int64_t firme = rebotar(pin, 0, azar() % 5000, &flancoPresion);
+        avanzar(firme + 20000 + azar() % 300000);   // Menos que la pulsación larga
+        revisarCambio(desde, boton, EVENTO_PRESION, flancoPresion, firme);
+
+        int64_t firmeLiberacion = rebotar(pin, 1, azar() % 5000, &flancoLiberacion);
+        avanzar(firmeLiberacion + 20000 + azar() % 100000);
+        revisarCambio(desde, boton, EVENTO_LIBERACION, flancoLiberacion, firmeLiberacion);
+
+        COMPROBAR(nRecibidos - desde == 2, "pulsación %d: %d eventos", p, nRecibidos - desde);
+        COMPROBAR(gpioFalsoInterrupciones - interrupciones == 2, "pulsación %d: %lu interrupciones con rebotes", p,
+                  (unsigned long)(gpioFalsoInterrupciones - interrupciones));
+        COMPROBAR(gpioFalsoIntrActiva[pin], "pulsación %d: la interrupción quedó apagada", p);
+        COMPROBAR(!timerBotonesActivo && !gptimersFalsos[0].corriendo, "pulsación %d: el timer sigue", p);
+        nRecibidos = 0;
+    }
+}
+
+// Pico de ruido más corto que el antirrebote: ningún evento, una sola
+// interrupción y todo vuelve a escuchar flancos
+static void revisarPico(void) {
+    int pin = pinesBotones[BOTON_INC];
+    nRecibidos = 0;
+    uint32_t interrupciones = gpioFalsoInterrupciones;
+    gpioFalso_entrada(pin, 0);
+    avanzar(relojFalso_us + 300);
+    gpioFalso_entrada(pin, 1);
+    avanzar(relojFalso_us + 2500);
+    gpioFalso_entrada(pin, 0);   // Segundo pico con la interrupción aún apagada
+    avanzar(relojFalso_us + 200);
+    gpioFalso_entrada(pin, 1);
+    avanzar(relojFalso_us + 20000);
+    COMPROBAR(nRecibidos == 0, "el pico dio %d eventos", nRecibidos);
+    COMPROBAR(gpioFalsoInterrupciones - interrupciones == 1, "el pico dio %lu interrupciones",
+              (unsigned long)(gpioFalsoInterrupciones - interrupciones));
+    COMPROBAR(gpioFalsoIntrActiva[pin] && !timerBotonesActivo, "después del pico: interrupción %d, timer %d",
+              gpioFalsoIntrActiva[pin], timerBotonesActivo);
+}
+
+// Sostenido: pulsación larga a los 800 ms y repeticiones cada "periodo"
+static void revisarSostenido(int boton, int64_t sostener_us, int64_t periodo_us, int repeticiones) {
+    int pin = pinesBotones[boton];
+    int64_t flanco, flancoLiberacion;
+    nRecibidos = 0;
+    int64_t firme = rebotar(pin, 0, 2000, &flanco);
+    avanzar(flanco + sostener_us);
+    int64_t firmeLiberacion = rebotar(pin, 1, 2000, &flancoLiberacion);
+    avanzar(firmeLiberacion + 20000);
+
+    int presion = revisarCambio(0, boton, EVENTO_PRESION, flanco, firme);
+    revisarCambio(0, boton, EVENTO_LIBERACION, flancoLiberacion, firmeLiberacion);
+    int64_t anterior = 0;
+    int larga = 0, n = 0;
+    for (int i = presion + 1; i < nRecibidos; i++) {
+        const recibido_t *r = &recibidos[i];
+        if (r->evento.boton != boton) continue;
+        if (r->evento.tipo == EVENTO_LARGA) {
+            larga++;
+            int64_t espera = r->evento.tiempo_us - flanco;
+            COMPROBAR(espera >= PULSACION_LARGA_MS * 1000LL && espera < PULSACION_LARGA_MS * 1000LL + TICK_BOTONES_US,
+                      "botón %d: pulsación larga a los %lld us", boton, (long long)espera);
+        } else if (r->evento.tipo == EVENTO_REPETICION) {
+            int64_t periodo = r->evento.tiempo_us - anterior;
+            COMPROBAR(periodo >= periodo_us && periodo < periodo_us + TICK_BOTONES_US,
+                      "botón %d: repetición %d a los %lld us de la anterior", boton, n, (long long)periodo);
+            n++;
+        }
+        if (r->evento.tipo == EVENTO_LARGA || r->evento.tipo == EVENTO_REPETICION) {
+            COMPROBAR(r->llegada == r->evento.tiempo_us, "botón %d: %s llegó tarde", boton,
+                      nombresEventos[r->evento.tipo]);
+            anterior = r->evento.tiempo_us;
+        }
+    }
+    COMPROBAR(larga == 1 && n == repeticiones, "botón %d sostenido %lld ms: %d largas, %d repeticiones (esperadas %d)",
+              boton, (long long)(sostener_us / 1000), larga, n, repeticiones);
+}
+
+int main(void) {
+    // Pull-up: todos los botones arriba
+    for (int b = 0; b < NUM_BOTONES; b++) gpioFalso_entrada(pinesBotones[b], 1);
+    configurarBotones();
+
+    revisarPulsaciones();
+    revisarPico();
+
+    // inc sostenido 3.5 s: larga a 0.8 s, repeticiones a 1.8 y 2.8 s
+    revisarSostenido(BOTON_INC, 3500000, REPETICION_NORMAL_MS * 1000LL, 2);
+    // 90 grados: larga y nada más
+    revisarSostenido(BOTON_90, 2500000, 0, 0);
+
+    // Con velocidad presionada: larga a 0.8 s y repeticiones cada 50 ms de 0.85 a 1.3 s
+    int64_t flancoVelocidad, flancoFin;
+    gpioFalso_entrada(pinesBotones[BOTON_VELOCIDAD], 0);
+    flancoVelocidad = relojFalso_us;
+    avanzar(relojFalso_us + 20000);
+    revisarSostenido(BOTON_DEC, 1320000, REPETICION_RAPIDA_MS * 1000LL, 10);
+    int64_t firme = rebotar(pinesBotones[BOTON_VELOCIDAD], 1, 1000, &flancoFin);
+    avanzar(firme + 20000);
+    COMPROBAR(flancoFin - flancoVelocidad > PULSACION_LARGA_MS * 1000LL, "velocidad no se sostuvo");
+
+    COMPROBAR(!timerBotonesActivo && !gptimersFalsos[0].corriendo, "el timer sigue con todo suelto");
+    COMPROBAR(eventosPerdidos == 0, "%lu eventos perdidos", (unsigned long)eventosPerdidos);
+    imprimirLatencias();
+    uint32_t lentas = 0;
+    for (int i = 5; i < CUBETAS_LATENCIA; i++) lentas += histogramaLatencia[i];
+    COMPROBAR(lentas == 0, "%lu eventos con 16 ms o más de latencia", (unsigned long)lentas);
+    return prueba_fin("prueba_botones_practica1");
+}
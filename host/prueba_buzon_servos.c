@@ -0,0 +1,166 @@
+// Buzón de órdenes de BancoServos.h con una ISR simulada que lo inunda.
+//
+// La ISR publica ráfagas de objetivos entre periodos y también a media tarea
+// (después de que la tarea ya tomó el buzón). Se revisa que los contadores
+// cuadren (publicadas = combinadas + aplicadas + pendientes), que cada periodo
+// la tarea tome solo el último objetivo de cada servo y que el servo nunca
+// vaya hacia un objetivo intermedio. También que la interrupción del periodo
+// se pida compartida y en IRAM y no despierte a la tarea por otra fuente, que
+// el planificador y los comparadores corran fuera de la sección crítica y que
+// una orden directa que llega a media tarea con los servos quietos no apague
+// la interrupción.
+
+#include <setjmp.h>
+#include "prueba.h"
+#include "falsos.h"
+
+#define MAPEO_CALIBRACIONES { MAPEO_LINEAL(500, 2500), MAPEO_LINEAL(600, 2400) }
+#include "../BancoServos.h"
+
+// Un periodo del PWM: la tarea del banco hace una vuelta y se corta en la siguiente espera
+static jmp_buf fin;
+static int notificaciones;
+
+uint32_t ulTaskNotifyTake(BaseType_t limpiar, TickType_t espera) {
+    if (notificaciones-- == 0) longjmp(fin, 1);
+    return 1;
+}
+
+static void periodo(void) {
+    notificaciones = 1;
+    if (setjmp(fin) == 0) bancoServos_tarea(NULL);
+}
+
+static uint32_t pendientesBuzon(void) {
+    return __builtin_popcount(bancoServos.buzon.pendientes);
+}
+
+static void revisarContadores(const char *caso) {
+    buzonServos_t *b = &bancoServos.buzon;
+    COMPROBAR(b->publicadas == b->combinadas + b->aplicadas + pendientesBuzon(),
+              "%s: %lu publicadas, %lu combinadas, %lu aplicadas, %lu pendientes", caso,
+              (unsigned long)b->publicadas, (unsigned long)b->combinadas, (unsigned long)b->aplicadas,
+              (unsigned long)pendientesBuzon());
+}
+
+// A media tarea, en la primera escritura del periodo: una ISR publica un
+// objetivo para el servo 1 o una tarea da una orden directa al servo 0
+static int32_t objetivoTardio = -1;
+static float directaTardia = -1;
+static uint32_t escriturasConCandado;
+
+static void alEscribir(void) {
+    if (seccionCriticaFalsa) escriturasConCandado++;
+    if (objetivoTardio >= 0) {
+        bancoServos_publicar(1, objetivoTardio);
+        objetivoTardio = -1;
+    }
+    if (directaTardia >= 0) {
+        bancoServos_moverUno(0, directaTardia);
+        directaTardia = -1;
+    }
+}
+
+int main(void) {
+    srand(20);
+    const int pines[] = {14, 15};
+    const float iniciales[] = {0, 90};
+    bancoServos_iniciar(pines, 2, iniciales);
+    mcpwmFalso_alEscribir = alEscribir;
+    COMPROBAR(MCPWM0.int_ena.timer0_tez_int_ena == 0, "interrupción del periodo encendida sin órdenes");
+
+    // Interrupción compartida y en IRAM; solo el cero del timer 0 despierta a la tarea
+    COMPROBAR(intrFalsoFuente == ETS_PWM0_INTR_SOURCE && intrFalsoManejador == bancoServos_inicioPeriodo &&
+                  intrFalsoFlags == (ESP_INTR_FLAG_SHARED | ESP_INTR_FLAG_IRAM),
+              "interrupción: fuente %d, flags %x", intrFalsoFuente, intrFalsoFlags);
+    uint32_t avisos = notificacionesFalsas;
+    intrFalsoManejador(NULL);
+    COMPROBAR(notificacionesFalsas == avisos, "otra fuente de la línea compartida despertó a la tarea");
+    MCPWM0.int_st.timer0_tez_int_st = 1;
+    intrFalsoManejador(NULL);
+    MCPWM0.int_st.timer0_tez_int_st = 0;
+    COMPROBAR(notificacionesFalsas == avisos + 1, "el cero del timer 0 no despertó a la tarea");
+
+    // Ráfaga: 1000 órdenes al servo 0 antes del siguiente periodo, la última a 30 grados
+    for (int i = 0; i < 999; i++) {
+        bancoServos_publicar(0, rand() % (MAPEO_MAXIMO + 1));
+    }
+    bancoServos_publicar(0, 300);
+    buzonServos_t *b = &bancoServos.buzon;
+    COMPROBAR(b->publicadas == 1000 && b->combinadas == 999 && b->aplicadas == 0,
+              "ráfaga: %lu publicadas, %lu combinadas, %lu aplicadas", (unsigned long)b->publicadas,
+              (unsigned long)b->combinadas, (unsigned long)b->aplicadas);
+    COMPROBAR(MCPWM0.int_ena.timer0_tez_int_ena == 1, "la primera orden no encendió la interrupción");
+    revisarContadores("ráfaga");
+
+    periodo();
+    COMPROBAR(b->aplicadas == 1 && b->pendientes == 0, "ráfaga: %lu aplicadas, pendientes %lx",
+              (unsigned long)b->aplicadas, (unsigned long)b->pendientes);
+    COMPROBAR(bancoServos.planes[0].objetivo == 30.0f, "objetivo %.1f en lugar del último (30)",
+              bancoServos.planes[0].objetivo);
+
+    // Ráfagas de 5 órdenes por periodo mientras el servo se mueve; la última
+    // de cada ráfaga es la única que debe llegar al planificador
+    float maximo = 0;
+    for (int p = 0; p < 50; p++) {
+        int32_t ultimo = 0;
+        for (int i = 0; i < 5; i++) {
+            ultimo = 200 + rand() % 200;   // 20 a 40 grados
+            bancoServos_publicar(0, i == 4 ? ultimo : rand() % (MAPEO_MAXIMO + 1));
+        }
+        uint32_t antes = b->aplicadas;
+        periodo();
+        COMPROBAR(b->aplicadas == antes + 1, "periodo %d: %lu aplicadas", p, (unsigned long)(b->aplicadas - antes));
+        COMPROBAR(bancoServos.planes[0].objetivo * 10 == ultimo, "periodo %d: objetivo %.1f, último %ld", p,
+                  bancoServos.planes[0].objetivo, (long)ultimo);
+        if (bancoServos.planes[0].posicion > maximo) maximo = bancoServos.planes[0].posicion;
+    }
+    // Los objetivos intermedios llegan a 180 grados; el servo no pasa de 40
+    COMPROBAR(maximo <= 40.5f, "el servo llegó a %.1f grados siguiendo objetivos intermedios", maximo);
+    revisarContadores("ráfagas por periodo");
+
+    // Orden de la ISR después de que la tarea tomó el buzón: se aplica en el siguiente periodo
+    objetivoTardio = 450;
+    uint32_t antes = b->aplicadas;
+    periodo();
+    COMPROBAR(b->aplicadas == antes && (b->pendientes & 2), "orden tardía: %lu aplicadas, pendientes %lx",
+              (unsigned long)(b->aplicadas - antes), (unsigned long)b->pendientes);
+    COMPROBAR(MCPWM0.int_ena.timer0_tez_int_ena == 1, "orden tardía con la interrupción apagada");
+    periodo();
+    COMPROBAR(b->aplicadas == antes + 1 && bancoServos.planes[1].objetivo == 45.0f,
+              "orden tardía: objetivo %.1f", bancoServos.planes[1].objetivo);
+    revisarContadores("orden tardía");
+
+    // Sin más órdenes: los dos servos llegan y la interrupción se apaga
+    int periodos = 0;
+    while (MCPWM0.int_ena.timer0_tez_int_ena && periodos < 1000) {
+        periodo();
+        periodos++;
+    }
+    COMPROBAR(MCPWM0.int_ena.timer0_tez_int_ena == 0, "la interrupción sigue encendida después de %d periodos",
+              periodos);
+    uint32_t esperado = mapeo_ticks(1, 450);
+    COMPROBAR(mcpwmFalsoComparadores[0][1] == esperado, "servo 1 en %lu ticks, esperado %lu",
+              (unsigned long)mcpwmFalsoComparadores[0][1], (unsigned long)esperado);
+    COMPROBAR(bancoServos.planes[0].posicion * 10 == b->objetivos[0], "servo 0 en %.1f, último objetivo %ld",
+              bancoServos.planes[0].posicion, (long)b->objetivos[0]);
+    revisarContadores("final");
+
+    // Orden directa después de que la tarea copió las órdenes, con los dos servos
+    // quietos: la interrupción sigue encendida y el siguiente periodo la toma
+    bancoServos_refrescar();
+    directaTardia = 60;
+    periodo();
+    COMPROBAR(MCPWM0.int_ena.timer0_tez_int_ena == 1 && bancoServos.planes[0].objetivo != 60.0f,
+              "orden directa tardía: interrupción %d, objetivo %.1f", MCPWM0.int_ena.timer0_tez_int_ena,
+              bancoServos.planes[0].objetivo);
+    periodo();
+    COMPROBAR(bancoServos.planes[0].objetivo == 60.0f, "orden directa tardía: objetivo %.1f",
+              bancoServos.planes[0].objetivo);
+    COMPROBAR(escriturasConCandado == 0 && seccionCriticaFalsa == 0,
+              "%lu escrituras de comparadores dentro de la sección crítica", (unsigned long)escriturasConCandado);
+
+    printf("Buzón: %lu publicadas, %lu combinadas, %lu aplicadas en %lu periodos\n", (unsigned long)b->publicadas,
+           (unsigned long)b->combinadas, (unsigned long)b->aplicadas, (unsigned long)bancoServos.cuadros);
+    return prueba_fin("prueba_buzon_servos");
+}
@@ -0,0 +1,117 @@
+// Display de 74HC595 por SPI con una cadena de registros simulada.
+//
+// Cada transacción que manda task_refresco se pasa bit por bit por la cadena
+// (MSB primero, modo 0) y el final de la transacción (subida del CS) copia los
+// registros a las salidas. Después de cada trama se decodifican las salidas:
+// un solo transistor encendido, el del dígito que toca, con el glifo del texto
+// publicado. También se revisa que cada trama llegue al DMA alineada a 4 bytes
+// y con un largo múltiplo de 4, para que el driver no la copie.
+
+#include <setjmp.h>
+#include "prueba.h"
+#include "falsos.h"
+#include "../Display_595.c"
+
+#define REGISTROS_CADENA BYTES_TRAMA     // 595 de segmentos + 595 de transistores
+
+static uint8_t cadena[REGISTROS_CADENA];   // cadena[0] = 595 #0, bit n = Qn
+static uint8_t salidas[REGISTROS_CADENA];
+static spi_bus_config_t busConfigurado;
+static spi_transaction_t *ultima;
+static uint32_t transacciones, desalineadas;
+
+static void cadena_bit(int bit) {
+    for (int i = REGISTROS_CADENA - 1; i > 0; i--) {
+        cadena[i] = (cadena[i] << 1) | (cadena[i - 1] >> 7);
+    }
+    cadena[0] = (cadena[0] << 1) | bit;
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *bus, int dma) {
+    busConfigurado = *bus;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *dev,
+                             spi_device_handle_t *handle) {
+    return ESP_OK;
+}
+
+// Lo que debe verse: texto publicado y siguiente dígito del barrido
+static const char *textoEsperado;
+static int digitoEsperado;
+
+static void revisarSalidas(void) {
+    int encendidos = 0, encendido = -1;
+    for (int d = 0; d < NUM_DIGITOS; d++) {
+        if (salidas[1 + d / 8] & (1 << (d % 8))) {
+            encendidos++;
+            encendido = d;
+        }
+    }
+    int d = digitoEsperado;
+    uint8_t esperado = seg7_codigo((size_t)d < strlen(textoEsperado) ? seg7_indice(textoEsperado[d]) : SEG7_APAGADO);
+    COMPROBAR(encendidos == 1 && encendido == d, "\"%s\": %d transistores, dígito %d en lugar de %d", textoEsperado,
+              encendidos, encendido, d);
+    COMPROBAR(salidas[0] == esperado, "\"%s\", dígito %d: segmentos %02x, esperados %02x", textoEsperado, d,
+              salidas[0], esperado);
+    digitoEsperado = (d + 1) % NUM_DIGITOS;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans, TickType_t espera) {
+    const uint8_t *datos = trans->tx_buffer;
+    if ((uintptr_t)datos % 4 || trans->length % 32) desalineadas++;
+    COMPROBAR(trans->length <= busConfigurado.max_transfer_sz * 8u, "transacción de %u bits", (unsigned)trans->length);
+    for (size_t b = 0; b < trans->length; b++) {
+        cadena_bit((datos[b / 8] >> (7 - b % 8)) & 1);
+    }
+    memcpy(salidas, cadena, sizeof(salidas));   // Subida del CS = latch
+    revisarSalidas();
+    ultima = trans;
+    transacciones++;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans, TickType_t espera) {
+    *trans = ultima;
+    return ESP_OK;
+}
+
+// Las notificaciones del timer: después de las pedidas, la tarea se corta
+static jmp_buf fin;
+static int notificaciones;
+
+uint32_t ulTaskNotifyTake(BaseType_t limpiar, TickType_t espera) {
+    if (notificaciones-- == 0) longjmp(fin, 1);
+    return 1;
+}
+
+// Dos barridos completos del texto, con la tarea de refresco desde el dígito 0
+static void revisarTexto(const char *texto) {
+    mostrarTexto(texto);
+    textoEsperado = texto;
+    digitoEsperado = 0;
+    notificaciones = 2 * NUM_DIGITOS;
+    uint32_t antes = transacciones;
+    if (setjmp(fin) == 0) task_refresco(NULL);
+    COMPROBAR(transacciones - antes == 2 * NUM_DIGITOS, "\"%s\": %lu tramas", texto,
+              (unsigned long)(transacciones - antes));
+}
+
+int main(void) {
+    // La cadena arranca con basura: la primera trama la reemplaza completa
+    for (int i = 0; i < REGISTROS_CADENA; i++) cadena[i] = rand();
+    configurarSPI();
+
+    revisarTexto("");
+    revisarTexto("SPI-595 12345678");
+    revisarTexto("8888888888888888888888888888888888888888");
+    revisarTexto("HOLA");
+    revisarTexto("0123456789ABCDEF-_=");
+
+    COMPROBAR(desalineadas == 0, "%lu tramas desalineadas para el DMA", (unsigned long)desalineadas);
+    COMPROBAR(PERIODO_DIGITO_US * NUM_DIGITOS <= 1000000 / REFRESCO_DIGITO_HZ, "refresco por dígito");
+    printf("%d dígitos, %d registros en cadena, tramas de %d bytes (%d de relleno), %d us por dígito\n", NUM_DIGITOS,
+           REGISTROS_CADENA, BYTES_REGISTRO, BYTES_RELLENO, PERIODO_DIGITO_US);
+    return prueba_fin("prueba_cadena_595");
+}
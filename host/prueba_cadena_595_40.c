@@ -0,0 +1,3 @@
+// La misma cadena con 40 dígitos: 6 registros, tramas de 8 bytes con 2 de relleno
+#define NUM_DIGITOS 40
+#include "prueba_cadena_595.c"
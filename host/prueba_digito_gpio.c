@@ -0,0 +1,72 @@
+// Escritura de un dígito del display de la práctica 5 con máscaras W1TS/W1TC.
+//
+// Compara contra el camino anterior (gpio_set_level por catodo y por segmento):
+// mismas salidas al final, pero 2 accesos a registros en lugar de 17 llamadas,
+// y nunca se ve medio carácter (la primera escritura deja todo apagado).
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../Practica_5.c"
+
+// Camino anterior, copiado de la práctica 5 antes del cambio (bit 6 = A ... bit 0 = G)
+static const uint8_t codigosAnteriores[11] = {0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70, 0x7F, 0x7B, 0x00};
+
+static void decodificaSegmentosAnterior(uint8_t display) {
+    gpio_set_level(segmento_G, (display & 0b00000001) >> 0);
+    gpio_set_level(segmento_F, (display & 0b00000010) >> 1);
+    gpio_set_level(segmento_E, (display & 0b00000100) >> 2);
+    gpio_set_level(segmento_D, (display & 0b00001000) >> 3);
+    gpio_set_level(segmento_C, (display & 0b00010000) >> 4);
+    gpio_set_level(segmento_B, (display & 0b00100000) >> 5);
+    gpio_set_level(segmento_A, (display & 0b01000000) >> 6);
+}
+
+static void muestraDigitoAnterior(uint8_t display, uint8_t numero) {
+    gpio_set_level(pin_catodo_displayUnidades, display == 0);
+    gpio_set_level(pin_catodo_displayDecenas, display == 1);
+    gpio_set_level(pin_catodo_displayCentenas, display == 2);
+    decodificaSegmentosAnterior(codigosAnteriores[10]);
+    decodificaSegmentosAnterior(codigosAnteriores[numero]);
+}
+
+int main(void) {
+    for (int display = 0; display < 3; display++) {
+        for (int numero = 0; numero < 10; numero++) {
+            for (int previo = 0; previo < 10; previo++) {
+                // El dígito anterior en pantalla no debe dejar rastro
+                gpioFalso_reiniciar();
+                muestraDigitoAnterior((display + 1) % 3, previo);
+                muestraDigitoAnterior(display, numero);
+                uint64_t esperado = gpioFalso_salidas();
+                uint32_t llamadas = gpioFalsoLlamadas / 2;
+
+                gpioFalso_reiniciar();
+                muestraDigito((display + 1) % 3, previo);
+                gpioFalsoAccesos = 0;
+                GPIO.out_w1tc = mascaraDisplay;
+                COMPROBAR((gpioFalso_salidas() & mascaraDisplay) == 0, "el display no queda apagado entre dígitos");
+                muestraDigito(display, numero);
+                uint32_t accesos = gpioFalsoAccesos - 1;
+
+                COMPROBAR(gpioFalso_salidas() == esperado, "display %d, %d: salidas %llx, esperadas %llx", display,
+                          numero, (unsigned long long)gpioFalso_salidas(), (unsigned long long)esperado);
+                COMPROBAR(accesos == 2, "display %d, %d: %lu accesos", display, numero, (unsigned long)accesos);
+                COMPROBAR(llamadas == 17, "el camino anterior hacía %lu llamadas", (unsigned long)llamadas);
+            }
+        }
+    }
+
+    // El ISR de multiplexado escribe el frame precalculado con los mismos dos accesos
+    contador = 0x987;
+    actualizaFrame(contador);
+    gpioFalso_reiniciar();
+    activacionDisplays = 0;
+    for (int display = 0; display < 3; display++) {
+        uint32_t antes = gpioFalsoAccesos;
+        on_timer_alarm(NULL);
+        COMPROBAR(gpioFalsoAccesos - antes == 2, "ISR: %lu accesos", (unsigned long)(gpioFalsoAccesos - antes));
+        COMPROBAR(gpioFalso_salidas() == frameDisplay[display], "ISR: display %d", display);
+    }
+    printf("Un dígito: %d llamadas a gpio_set_level antes, 2 escrituras a registros ahora\n", 17);
+    return prueba_fin("prueba_digito_gpio");
+}
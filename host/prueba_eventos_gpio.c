@@ -0,0 +1,203 @@
+// Cola de eventos de EventosGPIO.h con los registros de estado falsos.
+//
+// Un segundo simulado con un flanco cada 10 us (100k por segundo) repartido al
+// azar entre pines de los dos bancos; cada flanco cambia el nivel en GPIO.in,
+// marca su bit en GPIO.status y llama a la ISR registrada. El consumidor saca
+// por lotes cada 2.56 ms: encuentra la cola justo llena (256 eventos) y no se
+// debe perder ninguno ni cambiar de orden. Los contadores de la cola cruzan la
+// vuelta de los 32 bits a media prueba. Después, varios pines en la misma
+// interrupción, un pin de otra ISR y uno atendido con la interrupción apagada
+// (ninguno se guarda y su estado queda pendiente), una cola que se desborda (se
+// descartan los nuevos, los guardados no se tocan) y un rebote donde el nivel
+// no es el flanco.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../EventosGPIO.h"
+
+#define FLANCOS 100000
+#define PERIODO_FLANCO_US 10
+#define PERIODO_CONSUMIDOR_US (EVENTOS_GPIO_TAM * PERIODO_FLANCO_US)
+#define CICLOS_POR_US 240
+#define LOTE 16
+
+static const uint8_t pines[] = {4, 5, 17, 35, 39, 40, 41, 42};
+#define NUM_PINES (sizeof(pines) / sizeof(pines[0]))
+#define PIN_AJENO 7          // Con la interrupción activa, de otra ISR en la misma línea
+
+static colaEventosGPIO_t cola;
+static eventoGPIO_t esperados[FLANCOS];
+static uint32_t avisos;
+
+static bool avisar(void) {
+    avisos++;
+    return false;
+}
+
+static uint32_t azar(void) {
+    static uint32_t x = 88172645u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+static uint64_t pinesMascara(void) {
+    uint64_t mascara = 0;
+    for (size_t i = 0; i < NUM_PINES; i++) mascara |= 1ULL << pines[i];
+    return mascara;
+}
+
+// Cambia el nivel de entrada del pin y deja su interrupción pendiente (en
+// GPIO.pcpu_int solo si la interrupción del pin está activa)
+static void flanco(int pin, int nivel) {
+    volatile uint32_t *in = pin < 32 ? &gpioFalso.in : &gpioFalso.in1.val;
+    volatile uint32_t *estado = pin < 32 ? &gpioFalso.status : &gpioFalso.status1.val;
+    volatile uint32_t *cpu = pin < 32 ? &gpioFalso.pcpu_int : &gpioFalso.pcpu_int1.val;
+    uint32_t bit = 1UL << (pin & 31);
+    *in = nivel ? (*in | bit) : (*in & ~bit);
+    *estado |= bit;
+    if (gpioFalsoIntrActiva[pin]) *cpu |= bit;
+}
+
+static bool pendiente(int pin) {
+    uint32_t estado = pin < 32 ? GPIO.status : GPIO.status1.val;
+    return (estado >> (pin & 31)) & 1;
+}
+
+static int nivelDe(int pin) {
+    return gpio_get_level(pin);
+}
+
+static void interrupcion(uint32_t us) {
+    ciclosFalsos = us * CICLOS_POR_US;
+    gpioFalsoIsr(gpioFalsoIsrArg);
+    // Lo que la ISR escribió en W1TC se aplica en el siguiente acceso
+    COMPROBAR((GPIO.pcpu_int & cola.mascara0) == 0 && (GPIO.pcpu_int1.val & cola.mascara1) == 0,
+              "la ISR dejó estado pendiente: %08lx %08lx", (unsigned long)gpioFalso.pcpu_int,
+              (unsigned long)gpioFalso.pcpu_int1.val);
+}
+
+// Saca todo lo pendiente y lo compara con lo esperado a partir de *siguiente
+static void consumir(uint32_t *siguiente) {
+    eventoGPIO_t lote[LOTE];
+    int n;
+    while ((n = eventosGPIO_sacar(&cola, lote, LOTE)) > 0) {
+        for (int k = 0; k < n; k++, (*siguiente)++) {
+            const eventoGPIO_t *e = &esperados[*siguiente];
+            if (lote[k].pin != e->pin || lote[k].nivel != e->nivel || lote[k].ciclo != e->ciclo) {
+                COMPROBAR(false, "evento %lu: pin %u nivel %u ciclo %lu, esperado pin %u nivel %u ciclo %lu",
+                          (unsigned long)*siguiente, lote[k].pin, lote[k].nivel, (unsigned long)lote[k].ciclo,
+                          e->pin, e->nivel, (unsigned long)e->ciclo);
+                return;
+            }
+        }
+    }
+}
+
+static void revisarFlujo(void) {
+    // Los contadores de la cola dan la vuelta a mitad del segundo
+    cola.escritura = cola.lectura = UINT32_MAX - FLANCOS / 2;
+
+    uint32_t siguiente = 0, maximoPendientes = 0;
+    for (uint32_t i = 0; i < FLANCOS; i++) {
+        uint32_t us = (i + 1) * PERIODO_FLANCO_US;
+        int pin = pines[azar() % NUM_PINES];
+        int nivel = !nivelDe(pin);
+        flanco(pin, nivel);
+        esperados[i] = (eventoGPIO_t){.ciclo = us * CICLOS_POR_US, .pin = pin, .nivel = nivel};
+        interrupcion(us);
+
+        uint32_t pendientes = cola.escritura - cola.lectura;
+        if (pendientes > maximoPendientes) maximoPendientes = pendientes;
+        if (us % PERIODO_CONSUMIDOR_US == 0) consumir(&siguiente);
+    }
+    consumir(&siguiente);
+
+    COMPROBAR(siguiente == FLANCOS, "%lu de %d eventos recibidos", (unsigned long)siguiente, FLANCOS);
+    COMPROBAR(cola.perdidos == 0, "%lu eventos perdidos", (unsigned long)cola.perdidos);
+    COMPROBAR(maximoPendientes == EVENTOS_GPIO_TAM, "la cola llegó a %lu, no a su capacidad",
+              (unsigned long)maximoPendientes);
+    COMPROBAR(avisos == FLANCOS, "%lu avisos para %d interrupciones", (unsigned long)avisos, FLANCOS);
+    printf("%d flancos en 1 s en %d pines: %lu recibidos en orden, hasta %lu en la cola, %lu perdidos\n", FLANCOS,
+           (int)NUM_PINES, (unsigned long)siguiente, (unsigned long)maximoPendientes, (unsigned long)cola.perdidos);
+}
+
+// Varios pines en la misma interrupción salen en orden de pin con el mismo
+// ciclo. El pin de otra ISR y el atendido con la interrupción apagada no se
+// guardan, y su estado queda para quien lo atiende
+static void revisarSimultaneos(void) {
+    gpio_intr_disable(17);
+    flanco(42, 1);
+    flanco(5, 0);
+    flanco(PIN_AJENO, 1);
+    flanco(17, 1);
+    flanco(35, 1);
+    interrupcion(2000000);
+    COMPROBAR(pendiente(PIN_AJENO) && pendiente(17), "se limpió el estado del pin ajeno (%d) o del apagado (%d)",
+              pendiente(PIN_AJENO), pendiente(17));
+    GPIO.status_w1tc = (1UL << PIN_AJENO) | (1UL << 17);
+    gpio_intr_enable(17);
+    static const eventoGPIO_t esperado[] = {
+        {.ciclo = 2000000 * CICLOS_POR_US, .pin = 5, .nivel = 0},
+        {.ciclo = 2000000 * CICLOS_POR_US, .pin = 35, .nivel = 1},
+        {.ciclo = 2000000 * CICLOS_POR_US, .pin = 42, .nivel = 1},
+    };
+    eventoGPIO_t lote[LOTE];
+    int n = eventosGPIO_sacar(&cola, lote, LOTE);
+    COMPROBAR(n == 3, "%d eventos de una interrupción con 3 pines atendidos", n);
+    for (int k = 0; k < n && k < 3; k++) {
+        COMPROBAR(lote[k].pin == esperado[k].pin && lote[k].nivel == esperado[k].nivel &&
+                      lote[k].ciclo == esperado[k].ciclo,
+                  "simultáneos, evento %d: pin %u nivel %u", k, lote[k].pin, lote[k].nivel);
+    }
+}
+
+// Sin consumidor: los primeros EVENTOS_GPIO_TAM se guardan tal cual y cada
+// flanco de más se cuenta como perdido
+static void revisarDesborde(void) {
+    const uint32_t demas = 40;
+    uint32_t inicio = 3000000;
+    for (uint32_t i = 0; i < EVENTOS_GPIO_TAM + demas; i++) {
+        int pin = pines[i % NUM_PINES];
+        int nivel = !nivelDe(pin);
+        flanco(pin, nivel);
+        if (i < EVENTOS_GPIO_TAM) {
+            esperados[i] = (eventoGPIO_t){.ciclo = (inicio + i) * CICLOS_POR_US, .pin = pin, .nivel = nivel};
+        }
+        interrupcion(inicio + i);
+    }
+    COMPROBAR(cola.perdidos == demas, "%lu perdidos, esperados %lu", (unsigned long)cola.perdidos,
+              (unsigned long)demas);
+    uint32_t siguiente = 0;
+    consumir(&siguiente);
+    COMPROBAR(siguiente == EVENTOS_GPIO_TAM, "%lu eventos tras el desborde", (unsigned long)siguiente);
+    cola.perdidos = 0;
+}
+
+// Bajada que rebota: cuando la ISR lee GPIO.in el pin ya volvió a 1. El
+// evento trae el nivel leído, no el flanco
+static void revisarRebote(void) {
+    flanco(4, 1);
+    interrupcion(4000000);
+    flanco(4, 0);
+    gpioFalso.in |= 1UL << 4;
+    interrupcion(4000001);
+    eventoGPIO_t lote[LOTE];
+    int n = eventosGPIO_sacar(&cola, lote, LOTE);
+    COMPROBAR(n == 2 && lote[1].pin == 4 && lote[1].nivel == EVENTO_GPIO_ALTO,
+              "rebote: %d eventos, el último con nivel %u", n, n ? lote[n - 1].nivel : 0);
+}
+
+int main(void) {
+    gpioFalso_reiniciar();
+    COMPROBAR(eventosGPIO_instalar(&cola, pinesMascara(), avisar) == ESP_OK, "eventosGPIO_instalar");
+    for (size_t i = 0; i < NUM_PINES; i++) gpio_intr_enable(pines[i]);
+    gpio_intr_enable(PIN_AJENO);
+    COMPROBAR(gpioFalsoIsr == eventosGPIO_isr && gpioFalsoIsrArg == &cola, "la ISR no quedó registrada");
+    revisarFlujo();
+    revisarSimultaneos();
+    revisarDesborde();
+    revisarRebote();
+    return prueba_fin("prueba_eventos_gpio");
+}
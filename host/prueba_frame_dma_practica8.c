@@ -0,0 +1,58 @@
+// Frame DMA de la práctica 8: contenido y tiempos de salida.
+//
+// displayDMA_generarFrame() llena cada display con su glifo y un hueco apagado, y
+// con los tiempos de la práctica el frame sale en menos de 32 ms
+// con los displays encendidos más del 90% del tiempo. Con la distribución
+// anterior (una línea y porches de una línea) salía a 8 Hz y apagado 3/4 del tiempo.
+// Cada publicación regresa hasta el vsync con el que sale el frame nuevo.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../Práctica_8.c"
+#include "frameDMA.h"     // Después del programa: usa su Fuente7Seg.h
+
+static void revisarGenerador(const uint8_t indices[6]) {
+    uint16_t frame[DMA_MUESTRAS_FRAME];
+    displayDMA_generarFrame(frame, indices);
+    for (int d = 0; d < 6; d++) {
+        for (int k = 0; k < DMA_MUESTRAS_DIGITO; k++) {
+            uint16_t esperado = k < DMA_MUESTRAS_APAGADO ? 0 : seg7_codigo(indices[d]) | 1 << (7 + d);
+            COMPROBAR(frame[d * DMA_MUESTRAS_DIGITO + k] == esperado, "display %d, muestra %d: %04x", d, k,
+                      frame[d * DMA_MUESTRAS_DIGITO + k]);
+        }
+    }
+}
+
+static void revisarSalida(const uint8_t indices[6], bool imprimir) {
+    frameDMA_publicar(indices);
+
+    analisisFrame_t a;
+    frameDMA_analizar(indices, &a);
+    if (imprimir) frameDMA_imprimir("Ahora", &a);
+    COMPROBAR(lcdFalso_ciclosFrame() == DMA_CICLOS_FRAME, "%lu ciclos por frame", (unsigned long)lcdFalso_ciclosFrame());
+    COMPROBAR(a.periodo_ms <= 32.0, "frame de %.1f ms", a.periodo_ms);
+    COMPROBAR(a.encendido >= 0.9, "encendido %.1f%%", 100 * a.encendido);
+    COMPROBAR(a.separacionMin >= DMA_MUESTRAS_APAGADO, "solo %lu ciclos apagado entre displays",
+              (unsigned long)a.separacionMin);
+    for (int d = 0; d < 6; d++) {
+        COMPROBAR(a.ciclosDisplay[d] == DMA_MUESTRAS_DIGITO - DMA_MUESTRAS_APAGADO, "display %d encendido %lu ciclos", d,
+                  (unsigned long)a.ciclosDisplay[d]);
+    }
+
+    if (imprimir) {
+        frameDMA_analizarAnterior(indices, &a);
+        frameDMA_imprimir("Antes", &a);
+    }
+}
+
+int main(void) {
+    const uint8_t ochos[6] = {SEG7_8, SEG7_8, SEG7_8, SEG7_8, SEG7_8, SEG7_8};
+    revisarGenerador(Letras);
+    revisarGenerador(ochos);
+
+    displayDMA_iniciar(DisplayPins, TransPins);
+    COMPROBAR(lcdFalsoConfig.timings.h_res * lcdFalsoConfig.timings.v_res == DMA_MUESTRAS_FRAME, "tamaño del frame");
+    revisarSalida(Letras, true);
+    revisarSalida(ochos, false);     // El segundo frame sale del otro buffer
+    return prueba_fin("prueba_frame_dma_practica8");
+}
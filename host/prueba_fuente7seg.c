@@ -0,0 +1,107 @@
+// Fuente7Seg.h contra los códigos escritos a mano que tenía cada práctica.
+//
+// Cada tabla vieja se pasa al orden de la fuente (bit 0 = A) y se compara
+// carácter por carácter. Las únicas diferencias permitidas son las que se
+// corrigieron a propósito al unificar la fuente. Además se revisan las máscaras
+// de la práctica 2, que tiene segmentos en los dos bancos de GPIO, contra el
+// camino anterior con gpio_set_level.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../Practica_2.c"
+
+_Static_assert(__builtin_types_compatible_p(__typeof__(seg7Fuente), const seg7Mascara_t[SEG7_TOTAL]),
+               "la fuente debe ser const para quedar en flash");
+
+// Bit 6 = A ... bit 0 = G (prácticas 2, 3, 5 y 6) a bit 0 = A ... bit 6 = G
+static uint8_t invertirOrden(uint8_t codigo) {
+    uint8_t r = 0;
+    for (int i = 0; i < 7; i++) {
+        if (codigo & (1 << (6 - i))) r |= 1 << i;
+    }
+    return r;
+}
+
+static int compararTabla(const char *origen, const uint8_t *codigos, int n, bool msb, const uint8_t *indices,
+                         const char *corregidos) {
+    int diferencias = 0;
+    for (int i = 0; i < n; i++) {
+        uint8_t viejo = msb ? invertirOrden(codigos[i]) : codigos[i];
+        uint8_t nuevo = seg7_codigo(indices[i]);
+        bool esperado = corregidos && strchr(corregidos, i < 10 ? '0' + i : 'A' + i - 10);
+        if (viejo != nuevo) diferencias++;
+        COMPROBAR((viejo != nuevo) == esperado, "%s[%d]: viejo %02x, fuente %02x%s", origen, i, viejo, nuevo,
+                  esperado ? " (debía diferir)" : "");
+    }
+    return diferencias;
+}
+
+int main(void) {
+    uint8_t hex[20];
+    for (int i = 0; i < 20; i++) hex[i] = SEG7_0 + i;
+
+    // Prácticas 2 y 3: 0-9 y A-J. 6 y 9 no tenían un segmento, B y D se veían
+    // como 8 y 0, G no tenía forma de G y J no tenía el segmento E
+    const uint8_t practica2[20] = {0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x1F, 0x70, 0x7F, 0x73,
+                                   0x77, 0x7F, 0x4E, 0x7E, 0x4F, 0x47, 0x5F, 0x37, 0x30, 0x38};
+    compararTabla("Practica_2/3", practica2, 20, true, hex, "69BDGJ");
+
+    // Prácticas 5 y 6: dígitos iguales a la fuente
+    const uint8_t practica5[10] = {0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70, 0x7f, 0x7b};
+    compararTabla("Practica_5/6", practica5, 10, true, hex, NULL);
+
+    // Práctica 6: letras del teclado; B se veía como 8
+    const uint8_t letras6[7] = {0x77, 0x7F, 0x4E, 0x3D, 0x4F, 0x47, 0x01};
+    const uint8_t indices6[7] = {SEG7_A, SEG7_B, SEG7_C, SEG7_D, SEG7_E, SEG7_F, SEG7_GUION};
+    compararTabla("Practica_6 letras", letras6, 7, true, indices6, "1");
+
+    // Práctica 7, Proyecto_SemiEm y Práctica 8 ya usaban bit 0 = A
+    const uint8_t practica7[10] = {0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F};
+    compararTabla("Practica_7", practica7, 10, false, hex, NULL);
+    const uint8_t proyecto[10] = {0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F};
+    compararTabla("Proyecto_SemiEm", proyecto, 10, false, hex, NULL);
+    const uint8_t letras8[6] = {0x1E, 0x79, 0x6D, 0x3E, 0x6D, 0x66};
+    const uint8_t indices8[6] = {SEG7_J, SEG7_E, SEG7_S, SEG7_U, SEG7_S, SEG7_4};
+    compararTabla("Práctica_8", letras8, 6, false, indices8, NULL);
+
+    // Máscaras de la práctica 2 (A en el banco 0, B-G en el banco 1)
+    const int pines[7] = {A, B, C, D, E, F, G};
+    uint64_t todos = 0;
+    for (int s = 0; s < 7; s++) todos |= 1ULL << pines[s];
+    for (int i = 0; i < SEG7_TOTAL; i++) {
+        const seg7Mascara_t *m = &seg7Fuente[i];
+        uint64_t set = m->set0 | (uint64_t)m->set1 << 32;
+        uint64_t clr = m->clr0 | (uint64_t)m->clr1 << 32;
+        uint64_t esperado = 0;
+        for (int s = 0; s < 7; s++) {
+            if (seg7_codigo(i) & (1 << s)) esperado |= 1ULL << pines[s];
+        }
+        COMPROBAR(set == esperado, "carácter %d: set %llx, esperado %llx", i, (unsigned long long)set,
+                  (unsigned long long)esperado);
+        COMPROBAR(clr == (todos & ~esperado), "carácter %d: clr %llx", i, (unsigned long long)clr);
+    }
+    COMPROBAR((SEG7_SEGMENTOS0 | (uint64_t)SEG7_SEGMENTOS1 << 32) == todos, "máscara de todos los segmentos");
+
+    // mostrarNumero() contra el camino anterior en los glifos que no cambiaron
+    for (int n = 0; n < 20; n++) {
+        if (strchr("69BDGJ", n < 10 ? '0' + n : 'A' + n - 10)) continue;
+        gpioFalso_reiniciar();
+        for (int s = 0; s < 7; s++) gpio_set_level(pines[s], (practica2[n] >> (6 - s)) & 1);
+        uint64_t anterior = gpioFalso_salidas();
+
+        gpioFalso_reiniciar();
+        mostrarNumero(8);   // Todo encendido antes, para ver que se apaga lo que sobra
+        mostrarNumero(n);
+        COMPROBAR(gpioFalso_salidas() == anterior, "mostrarNumero(%d): %llx, antes %llx", n,
+                  (unsigned long long)gpioFalso_salidas(), (unsigned long long)anterior);
+    }
+
+    // Búsqueda por ASCII
+    COMPROBAR(seg7_indice('7') == SEG7_7, "'7'");
+    COMPROBAR(seg7_indice('h') == SEG7_H && seg7_indice('H') == SEG7_H, "minúsculas");
+    COMPROBAR(seg7_indice('-') == SEG7_GUION, "'-'");
+    COMPROBAR(seg7_indice('K') == SEG7_APAGADO && seg7_indice('\n') == SEG7_APAGADO, "sin glifo");
+    COMPROBAR(seg7_codigo(SEG7_APAGADO) == 0, "apagado");
+
+    return prueba_fin("prueba_fuente7seg");
+}
@@ -0,0 +1,155 @@
+// Señal de Blink.c: ciclo con usleep() contra el LEDC de GeneradorSenal.h.
+//
+// Primero las cuentas: 833 us en alto y 7500 en bajo dan 120 Hz y 1638 de 2^14
+// cuentas, con el redondeo de la frecuencia y el tope de las cuentas.
+//
+// Después se generan las marcas de tiempo de los flancos de 10 s de señal por
+// los dos caminos y se comparan periodo, tiempo en alto, jitter y deriva contra
+// la señal ideal (un flanco de subida cada 8333 us):
+//
+// - El ciclo anterior, tal cual: gpio_set_level + usleep(833) + gpio_set_level
+//   + usleep(7500). usleep() del ESP-IDF espera activo si el retardo es menor a
+//   un tick (833 us: el núcleo ocupado) y si no duerme vTaskDelay(ticks
+//   redondeados hacia arriba), que despierta en el borde de un tick más la
+//   latencia del planificador (se toma entre 2 y 15 us al azar).
+// - El LEDC con lo que Blink.c le programa: divisor de 80 MHz con 8 bits de
+//   fracción, 2^14 cuentas por periodo y el alto en cuentas.
+
+#include <math.h>
+#include "prueba.h"
+#include "falsos.h"
+#include "../Blink.c"
+
+#define PERIODO_IDEAL_NS ((tiempoAlto + tiempoBajo) * 1000LL)
+#define DURACION_NS 10000000000LL
+#define MAXIMO_PERIODOS 2000
+#define TICK_NS (portTICK_PERIOD_MS * 1000000LL)
+#define COSTO_SET_LEVEL_NS 400        // gpio_set_level() por el driver
+#define RELOJ_LEDC_HZ 80000000LL
+
+typedef struct {
+    int64_t subida[MAXIMO_PERIODOS + 1], bajada[MAXIMO_PERIODOS + 1];
+    int n;                // Periodos completos
+    int64_t ocupado_ns;   // Tiempo de CPU esperando activo
+} traza_t;
+
+static traza_t conUsleep, conLedc;
+
+static uint32_t azar(void) {
+    static uint32_t x = 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// usleep() del ESP-IDF sobre el reloj simulado
+static int64_t usleepSimulado(traza_t *t, int64_t ahora, uint32_t us) {
+    const int64_t us_por_tick = portTICK_PERIOD_MS * 1000;
+    if (us < us_por_tick) {
+        t->ocupado_ns += us * 1000LL;
+        return ahora + us * 1000LL;
+    }
+    int64_t ticks = (us + us_por_tick - 1) / us_por_tick;
+    return (ahora / TICK_NS + ticks) * TICK_NS + 2000 + azar() % 13000;
+}
+
+static void trazarUsleep(traza_t *t) {
+    int64_t ahora = 300000;   // El ciclo arranca a media ventana de un tick
+    t->n = -1;
+    while (t->n < MAXIMO_PERIODOS && ahora < DURACION_NS) {
+        ahora += COSTO_SET_LEVEL_NS;
+        t->subida[++t->n] = ahora;
+        ahora = usleepSimulado(t, ahora, tiempoAlto);
+        ahora += COSTO_SET_LEVEL_NS;
+        t->bajada[t->n] = ahora;
+        ahora = usleepSimulado(t, ahora, tiempoBajo);
+    }
+}
+
+// Flancos del LEDC con la frecuencia y cuentas que quedaron programadas
+static void trazarLedc(traza_t *t) {
+    int64_t cuentas = 1LL << GENERADOR_BITS;
+    int64_t divisor = (RELOJ_LEDC_HZ * 256 + ledcFalsoFrecuencia * cuentas / 2) / (ledcFalsoFrecuencia * cuentas);
+    // Periodo en 1/256 de ns para no perder la fracción del divisor
+    int64_t periodo = divisor * cuentas * 1000000000LL / RELOJ_LEDC_HZ;
+    int64_t alto = periodo * ledcFalsoDuty / cuentas;
+    t->n = 0;
+    for (int64_t k = 0; t->n < MAXIMO_PERIODOS && k * periodo / 256 < DURACION_NS; k++, t->n++) {
+        t->subida[t->n] = k * periodo / 256;
+        t->bajada[t->n] = (k * periodo + alto) / 256;
+    }
+    t->n--;
+}
+
+typedef struct {
+    double periodo_us, alto_us, jitter_us, deriva_ms, ocupado;
+} resumen_t;
+
+static resumen_t resumir(const char *nombre, const traza_t *t) {
+    int64_t minimo = INT64_MAX, maximo = 0, altos = 0;
+    for (int k = 0; k < t->n; k++) {
+        // El primer periodo depende de dónde cae el arranque: el jitter se mide después
+        int64_t p = t->subida[k + 1] - t->subida[k];
+        if (k > 0 && p < minimo) minimo = p;
+        if (k > 0 && p > maximo) maximo = p;
+        altos += t->bajada[k] - t->subida[k];
+    }
+    int64_t total = t->subida[t->n] - t->subida[0];
+    resumen_t r = {
+        .periodo_us = total / 1000.0 / t->n,
+        .alto_us = altos / 1000.0 / t->n,
+        .jitter_us = (maximo - minimo) / 1000.0,
+        .deriva_ms = (total - (int64_t)t->n * PERIODO_IDEAL_NS) / 1e6,
+        .ocupado = (double)t->ocupado_ns / total,
+    };
+    printf("%-7s %4d periodos: %7.1f us (%5.1f Hz), alto %6.1f us, jitter %5.1f us, deriva %+8.2f ms, "
+           "CPU ocupado %4.1f%%\n",
+           nombre, t->n, r.periodo_us, 1e6 / r.periodo_us, r.alto_us, r.jitter_us, r.deriva_ms, 100 * r.ocupado);
+    return r;
+}
+
+static void revisarCuentas(void) {
+    COMPROBAR(generadorSenal_frecuencia(833, 7500) == 120, "833/7500 us: %lu Hz",
+              (unsigned long)generadorSenal_frecuencia(833, 7500));
+    COMPROBAR(generadorSenal_cuentas(833, 120) == 1638, "833 us a 120 Hz: %lu cuentas",
+              (unsigned long)generadorSenal_cuentas(833, 120));
+    // Redondeo a la frecuencia más cercana: 1/8400 us = 119.05 Hz, 1/8300 us = 120.48 Hz
+    COMPROBAR(generadorSenal_frecuencia(900, 7500) == 119, "900/7500 us: %lu Hz",
+              (unsigned long)generadorSenal_frecuencia(900, 7500));
+    COMPROBAR(generadorSenal_frecuencia(800, 7500) == 120, "800/7500 us: %lu Hz",
+              (unsigned long)generadorSenal_frecuencia(800, 7500));
+    COMPROBAR(generadorSenal_cuentas(0, 120) == 0, "0 us en alto: %lu cuentas",
+              (unsigned long)generadorSenal_cuentas(0, 120));
+    COMPROBAR(generadorSenal_cuentas(9000, 120) == 1u << GENERADOR_BITS, "más alto que el periodo: %lu cuentas",
+              (unsigned long)generadorSenal_cuentas(9000, 120));
+    COMPROBAR(generadorSenal_cuentas(200000, 1000) == 1u << GENERADOR_BITS, "sin desborde de 32 bits: %lu cuentas",
+              (unsigned long)generadorSenal_cuentas(200000, 1000));
+}
+
+int main(void) {
+    revisarCuentas();
+
+    app_main();
+    COMPROBAR(ledcFalsoPin == pinLED && ledcFalsoFrecuencia == 120 && ledcFalsoDuty == 1638,
+              "Blink.c programó pin %d, %lu Hz, %lu cuentas", ledcFalsoPin, (unsigned long)ledcFalsoFrecuencia,
+              (unsigned long)ledcFalsoDuty);
+
+    trazarUsleep(&conUsleep);
+    trazarLedc(&conLedc);
+    printf("Ideal: %d us en alto, %d us en bajo, %.1f us por periodo, 10 s de señal\n", tiempoAlto, tiempoBajo,
+           PERIODO_IDEAL_NS / 1000.0);
+    resumen_t antes = resumir("usleep", &conUsleep);
+    resumen_t ahora = resumir("LEDC", &conLedc);
+
+    COMPROBAR(ahora.jitter_us < 0.01, "LEDC con jitter de %.3f us", ahora.jitter_us);
+    COMPROBAR(ahora.periodo_us > PERIODO_IDEAL_NS / 1000.0 - 1 && ahora.periodo_us < PERIODO_IDEAL_NS / 1000.0 + 1,
+              "LEDC: periodo de %.2f us", ahora.periodo_us);
+    COMPROBAR(ahora.alto_us > tiempoAlto - 0.5 && ahora.alto_us < tiempoAlto + 0.5, "LEDC: %.2f us en alto",
+              ahora.alto_us);
+    COMPROBAR(ahora.ocupado == 0, "el LEDC no ocupa CPU");
+    COMPROBAR(antes.jitter_us > ahora.jitter_us, "usleep sin jitter");
+    COMPROBAR(fabs(antes.deriva_ms) > 100 * fabs(ahora.deriva_ms), "usleep deriva %.2f ms, LEDC %.2f ms",
+              antes.deriva_ms, ahora.deriva_ms);
+    return prueba_fin("prueba_generador_senal");
+}
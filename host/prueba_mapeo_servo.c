@@ -0,0 +1,125 @@
+// Mapeo de ángulo a pulso de MapeoServo.h y la calibración de la práctica 1.
+//
+// Se revisa el mapeo lineal contra la recta exacta en todas las décimas de
+// grado, una tabla no lineal en sus puntos y entre ellos, el recorte fuera de
+// 0-180 grados y que a grados enteros el pulso quede a menos de 1 us del de
+// grados_a_us(). Después se sostienen inc y dec en los dos pasos de la
+// calibración: los extremos no salen de la ventana segura ni se cruzan.
+// Por último, el banco no toma más servos que filas tiene la tabla.
+
+#include "prueba.h"
+#include "falsos.h"
+
+// Los miles de ajustes sostenidos no se imprimen
+#undef ESP_LOGI
+#define ESP_LOGI(tag, ...) ((void)(tag))
+#include "../Practica_1.c"
+
+// Lo que hacía la práctica 1 antes de las tablas: grados enteros a us
+static uint32_t grados_a_us(int grados) {
+    return 500 + (2500 - 500) * grados / 180;
+}
+
+static void revisarMonotono(const char *caso) {
+    for (int d = 1; d <= MAPEO_MAXIMO; d++) {
+        COMPROBAR(mapeo_ticks(0, d) >= mapeo_ticks(0, d - 1), "%s: %d décimas baja de %lu a %lu ticks", caso, d,
+                  (unsigned long)mapeo_ticks(0, d - 1), (unsigned long)mapeo_ticks(0, d));
+    }
+}
+
+static void revisarLineal(void) {
+    // 500 us = 1600 ticks, 2500 us = 8000 ticks
+    for (int d = 0; d <= MAPEO_MAXIMO; d++) {
+        double exacto = 1600 + 6400.0 * d / MAPEO_MAXIMO;
+        double error = mapeo_ticks(0, d) - exacto;
+        COMPROBAR(error > -1 && error < 1, "lineal, %d décimas: %lu ticks, exacto %.2f", d,
+                  (unsigned long)mapeo_ticks(0, d), exacto);
+    }
+    for (int g = 0; g <= 180; g++) {
+        int32_t us = MAPEO_TICKS_A_US(mapeo_ticks(0, g * 10));
+        COMPROBAR(abs(us - (int32_t)grados_a_us(g)) <= 1, "%d grados: %ld us, grados_a_us %lu", g, (long)us,
+                  (unsigned long)grados_a_us(g));
+    }
+    COMPROBAR(mapeo_ticks(0, -50) == mapeo_ticks(0, 0), "no recorta abajo de 0 grados");
+    COMPROBAR(mapeo_ticks(0, 5000) == mapeo_ticks(0, MAPEO_MAXIMO), "no recorta arriba de 180 grados");
+    revisarMonotono("lineal");
+}
+
+// Servo medido con respuesta no lineal: los puntos salen tal cual y entre
+// puntos el pulso queda entre los dos vecinos
+static void revisarTabla(void) {
+    static const uint16_t medida[MAPEO_PUNTOS] =
+        MAPEO_TABLA(540, 610, 700, 800, 905, 1010, 1120, 1230, 1345, 1460, 1575, 1690, 1800, 1910, 2015, 2120,
+                    2220, 2320, 2410);
+    memcpy(mapeoTablas[0], medida, sizeof(medida));
+    for (int i = 0; i < MAPEO_PUNTOS; i++) {
+        COMPROBAR(mapeo_ticks(0, i * MAPEO_PASO) == medida[i], "tabla, punto %d: %lu ticks, medido %u", i,
+                  (unsigned long)mapeo_ticks(0, i * MAPEO_PASO), medida[i]);
+    }
+    for (int d = 0; d < MAPEO_MAXIMO; d++) {
+        int i = d / MAPEO_PASO;
+        uint32_t t = mapeo_ticks(0, d);
+        COMPROBAR(t >= medida[i] && t <= medida[i + 1], "tabla, %d décimas: %lu fuera de %u-%u", d,
+                  (unsigned long)t, medida[i], medida[i + 1]);
+    }
+    revisarMonotono("tabla");
+}
+
+// Sostiene un botón en el paso de calibración: n ajustes iguales
+static void sostener(int ticks, int n) {
+    for (int i = 0; i < n; i++) {
+        ajustarExtremo(ticks);
+        COMPROBAR(extremo0 >= EXTREMO_MIN_TICKS && extremo180 <= EXTREMO_MAX_TICKS, "extremos %u-%u fuera de %u-%u",
+                  extremo0, extremo180, EXTREMO_MIN_TICKS, EXTREMO_MAX_TICKS);
+        COMPROBAR(extremo0 + SEPARACION_MIN_TICKS <= extremo180, "extremos %u-%u cruzados", extremo0, extremo180);
+        COMPROBAR(mapeoTablas[0][0] == extremo0 && mapeoTablas[0][MAPEO_PUNTOS - 1] == extremo180,
+                  "la tabla no sigue a los extremos");
+    }
+}
+
+static void revisarCalibracion(void) {
+    memcpy(mapeoTablas[0], mapeoFabrica[0], sizeof(mapeoTablas[0]));
+    extremo0 = mapeoTablas[0][0];
+    extremo180 = mapeoTablas[0][MAPEO_PUNTOS - 1];
+
+    // 0 grados: dec sostenido con el botón de velocidad (32 ticks cada 50 ms) por 3 minutos
+    pasoCalibracion = CALIBRACION_0;
+    sostener(-PASO_CALIBRACION_RAPIDO, 3600);
+    COMPROBAR(extremo0 == EXTREMO_MIN_TICKS, "dec sostenido deja el extremo de 0 en %u", extremo0);
+    sostener(PASO_CALIBRACION_RAPIDO, 3600);
+    COMPROBAR(extremo0 == extremo180 - SEPARACION_MIN_TICKS, "inc sostenido deja el extremo de 0 en %u", extremo0);
+    sostener(-PASO_CALIBRACION, 100);
+    COMPROBAR(extremo0 == extremo180 - SEPARACION_MIN_TICKS - 100 * PASO_CALIBRACION, "paso fino: %u", extremo0);
+
+    // 180 grados
+    pasoCalibracion = CALIBRACION_180;
+    sostener(PASO_CALIBRACION_RAPIDO, 3600);
+    COMPROBAR(extremo180 == EXTREMO_MAX_TICKS, "inc sostenido deja el extremo de 180 en %u", extremo180);
+    COMPROBAR(mapeo_ticks(0, MAPEO_MAXIMO) < MAPEO_TICKS_PERIODO, "pulso más largo que el periodo");
+    sostener(-PASO_CALIBRACION_RAPIDO, 3600);
+    COMPROBAR(extremo180 == extremo0 + SEPARACION_MIN_TICKS, "dec sostenido deja el extremo de 180 en %u",
+              extremo180);
+    pasoCalibracion = CALIBRACION_NO;
+
+    // La forma de fábrica (lineal) se conserva al estirarla
+    mapeo_calibrarExtremos(0, MAPEO_US_A_TICKS(600), MAPEO_US_A_TICKS(2400));
+    for (int i = 0; i < MAPEO_PUNTOS; i++) {
+        int32_t exacto = MAPEO_L(600, 2400, i);
+        COMPROBAR(abs((int32_t)mapeoTablas[0][i] - exacto) <= 1, "recalibrada, punto %d: %u, recta %ld", i,
+                  mapeoTablas[0][i], (long)exacto);
+    }
+}
+
+int main(void) {
+    revisarLineal();
+    revisarTabla();
+    revisarCalibracion();
+
+    // La práctica 1 tiene una sola tabla: el banco no debe tomar seis servos
+    const int pines[BANCO_SERVOS_MAX] = {14, 15, 16, 17, 18, 19};
+    const float angulos[BANCO_SERVOS_MAX] = {0};
+    bancoServos_iniciar(pines, BANCO_SERVOS_MAX, angulos);
+    COMPROBAR(bancoServos.n == MAPEO_SERVOS, "%d servos con %d tablas", bancoServos.n, MAPEO_SERVOS);
+
+    return prueba_fin("prueba_mapeo_servo");
+}
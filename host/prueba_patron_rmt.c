@@ -0,0 +1,202 @@
+// Codificadores de PatronRMT.h: pulsos y bits a símbolos del RMT.
+//
+// Los símbolos se vuelven a expandir a (nivel, duración) juntando mitades
+// seguidas del mismo nivel y se comparan con los pulsos: mismo tren, ninguna
+// mitad de duración 0 (el RMT la toma como fin) y ninguna de más de 32767
+// ticks. Casos fijos para el corte en 32767, los pulsos de duración 0, la
+// mitad sola al final y la falta de espacio; después miles de trenes al azar.
+// Para los bits: orden MSB primero, símbolos tal cual y el límite de espacio.
+// Al iniciar: si falla el codificador o rmt_enable, no queda nada creado.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../PatronRMT.h"
+
+#define MAXIMO_SIMBOLOS 256
+#define MAXIMO_PULSOS 64
+#define TRENES 20000
+#define CENTINELA 0xDEADBEEF
+
+static rmt_symbol_word_t simbolos[MAXIMO_SIMBOLOS + 1];
+
+// Tren expandido: pulsos juntados por nivel, sin duraciones 0
+typedef struct {
+    pulsoRMT_t pulsos[MAXIMO_SIMBOLOS * 2];
+    int n;
+} tren_t;
+
+static void tren_agregar(tren_t *t, uint8_t nivel, uint32_t duracion) {
+    if (duracion == 0) return;
+    if (t->n > 0 && t->pulsos[t->n - 1].nivel == nivel) {
+        t->pulsos[t->n - 1].duracion += duracion;
+    } else {
+        t->pulsos[t->n++] = (pulsoRMT_t){nivel, duracion};
+    }
+}
+
+static void tren_dePulsos(tren_t *t, const pulsoRMT_t *pulsos, int n) {
+    t->n = 0;
+    for (int i = 0; i < n; i++) tren_agregar(t, pulsos[i].nivel & 1, pulsos[i].duracion);
+}
+
+// false si alguna mitad tiene duración 0
+static bool tren_deSimbolos(tren_t *t, const rmt_symbol_word_t *s, int n) {
+    t->n = 0;
+    bool bien = true;
+    for (int i = 0; i < n; i++) {
+        bien &= s[i].duration0 > 0 && s[i].duration1 > 0;
+        tren_agregar(t, s[i].level0, s[i].duration0);
+        tren_agregar(t, s[i].level1, s[i].duration1);
+    }
+    return bien;
+}
+
+// El tren que sale del RMT es el pedido. Solo si quedó media mitad sola y el
+// último pulso era de 1 tick, ese pulso crece a 2
+static bool revisar(const char *caso, const pulsoRMT_t *pulsos, int n, int maximo) {
+    simbolos[maximo].val = CENTINELA;
+    int escritos = patronRMT_codificarPulsos(pulsos, n, simbolos, maximo);
+    COMPROBAR(simbolos[maximo].val == CENTINELA, "%s: escribió después de %d símbolos", caso, maximo);
+    if (escritos < 0) return false;
+
+    tren_t pedido, salida;
+    tren_dePulsos(&pedido, pulsos, n);
+    bool sinCeros = tren_deSimbolos(&salida, simbolos, escritos);
+    COMPROBAR(sinCeros, "%s: una mitad con duración 0", caso);
+
+    // Cada pulso se corta por separado, aunque el anterior sea del mismo nivel
+    uint32_t mitades = 0, ultimaMitad = 0;
+    for (int i = 0; i < n; i++) {
+        if (pulsos[i].duracion == 0) continue;
+        mitades += (pulsos[i].duracion + PATRON_MITAD_MAX - 1) / PATRON_MITAD_MAX;
+        ultimaMitad = pulsos[i].duracion % PATRON_MITAD_MAX;
+    }
+    COMPROBAR(escritos == (int)(mitades + 1) / 2, "%s: %d símbolos para %lu mitades", caso, escritos,
+              (unsigned long)mitades);
+    if (mitades % 2 && ultimaMitad == 1) pedido.pulsos[pedido.n - 1].duracion++;
+    bool igual = pedido.n == salida.n;
+    for (int i = 0; igual && i < pedido.n; i++) {
+        igual = pedido.pulsos[i].nivel == salida.pulsos[i].nivel &&
+                pedido.pulsos[i].duracion == salida.pulsos[i].duracion;
+    }
+    COMPROBAR(igual, "%s: el tren de símbolos no es el de pulsos (%d pulsos, %d salen)", caso, pedido.n, salida.n);
+    return true;
+}
+
+static void revisarFijos(void) {
+    // Corte en 32767: justo el máximo es una mitad, uno más son dos
+    const pulsoRMT_t justo[] = {{1, PATRON_MITAD_MAX}, {0, PATRON_MITAD_MAX}};
+    COMPROBAR(revisar("32767", justo, 2, 8), "32767 no cupo");
+    COMPROBAR(simbolos[0].duration0 == PATRON_MITAD_MAX && simbolos[0].duration1 == PATRON_MITAD_MAX,
+              "32767: %u + %u", simbolos[0].duration0, simbolos[0].duration1);
+    const pulsoRMT_t largo[] = {{1, PATRON_MITAD_MAX + 1}, {0, 3 * PATRON_MITAD_MAX + 2}};
+    COMPROBAR(revisar("32768", largo, 2, 8), "32768 no cupo");
+    COMPROBAR(simbolos[0].duration0 == PATRON_MITAD_MAX && simbolos[0].duration1 == 1 && simbolos[0].level1 == 1,
+              "32768: %u + %u", simbolos[0].duration0, simbolos[0].duration1);
+
+    // Los pulsos de duración 0 no dejan mitades
+    const pulsoRMT_t ceros[] = {{1, 0}, {0, 5}, {1, 0}, {0, 0}, {1, 7}, {0, 0}};
+    COMPROBAR(revisar("ceros", ceros, 6, 8), "ceros no cupo");
+    COMPROBAR(patronRMT_codificarPulsos(ceros, 6, simbolos, 8) == 1, "ceros: más de un símbolo");
+    COMPROBAR(patronRMT_codificarPulsos(ceros, 1, simbolos, 8) == 0, "solo un pulso de 0: hay símbolos");
+
+    // Media mitad sola al final: el último pulso cede un tick
+    const pulsoRMT_t impar[] = {{1, 10}, {0, 20}, {1, 30}};
+    COMPROBAR(revisar("impar", impar, 3, 8), "impar no cupo");
+    COMPROBAR(simbolos[1].level0 == 1 && simbolos[1].duration0 == 29 && simbolos[1].level1 == 1 &&
+                  simbolos[1].duration1 == 1,
+              "impar: último símbolo %u/%u + %u/%u", simbolos[1].level0, simbolos[1].duration0, simbolos[1].level1,
+              simbolos[1].duration1);
+    const pulsoRMT_t unTick[] = {{0, 1}};
+    COMPROBAR(revisar("1 tick", unTick, 1, 8), "1 tick no cupo");
+
+    // Sin espacio: justo cabe, uno menos es -1 (también si lo que no cabe es un corte)
+    const pulsoRMT_t cuatro[] = {{1, 1}, {0, 2}, {1, 3}, {0, 4}};
+    COMPROBAR(revisar("cabe justo", cuatro, 4, 2), "4 mitades no caben en 2 símbolos");
+    COMPROBAR(!revisar("no cabe", cuatro, 4, 1), "4 mitades cupieron en 1 símbolo");
+    COMPROBAR(!revisar("impar no cabe", impar, 3, 1), "3 mitades cupieron en 1 símbolo");
+    const pulsoRMT_t corte[] = {{1, 2 * PATRON_MITAD_MAX + 1}};
+    COMPROBAR(!revisar("corte no cabe", corte, 1, 1), "3 mitades de corte cupieron en 1 símbolo");
+    COMPROBAR(patronRMT_codificarPulsos(cuatro, 4, simbolos, 0) == -1, "sin espacio no es -1");
+
+    // El parpadeo de Blink.c: 833 us alto, 7500 us bajo
+    const pulsoRMT_t blink[] = {{1, PATRON_US(833)}, {0, PATRON_US(7500)}};
+    COMPROBAR(revisar("blink", blink, 2, 8), "blink no cupo en 8");
+    uint32_t periodo = 0;
+    for (int i = 0; i < 2; i++) periodo += simbolos[i].duration0 + simbolos[i].duration1;
+    COMPROBAR(periodo == PATRON_US(833 + 7500), "blink: periodo de %lu ticks", (unsigned long)periodo);
+}
+
+static uint32_t azar(void) {
+    static uint32_t x = 123456789u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+static void revisarAzar(void) {
+    pulsoRMT_t pulsos[MAXIMO_PULSOS];
+    int cupieron = 0;
+    for (int t = 0; t < TRENES; t++) {
+        int n = 1 + azar() % MAXIMO_PULSOS;
+        for (int i = 0; i < n; i++) {
+            uint32_t duracion;
+            switch (azar() % 4) {
+            case 0: duracion = azar() % 3; break;                                // 0, 1 o 2
+            case 1: duracion = PATRON_MITAD_MAX - 1 + azar() % 3; break;         // Alrededor del corte
+            case 2: duracion = azar() % (4 * PATRON_MITAD_MAX); break;
+            default: duracion = azar() % 1000; break;
+            }
+            pulsos[i] = (pulsoRMT_t){azar() & 1, duracion};
+        }
+        cupieron += revisar("azar", pulsos, n, 1 + azar() % MAXIMO_SIMBOLOS);
+    }
+    printf("%d trenes al azar, %d cupieron en su espacio\n", TRENES, cupieron);
+}
+
+static void revisarBits(void) {
+    const rmt_symbol_word_t bit0 = patronRMT_simbolo(4, 8), bit1 = patronRMT_simbolo(8, 4);
+    const uint8_t datos[] = {0xA5, 0x0F, 0x80};
+    static const char esperado[] = "101001010000111110";
+    const int bits = sizeof(esperado) - 1;
+
+    simbolos[bits].val = CENTINELA;
+    COMPROBAR(patronRMT_codificarBits(datos, bits, bit0, bit1, simbolos, bits) == bits, "bits: no cupieron justos");
+    COMPROBAR(simbolos[bits].val == CENTINELA, "bits: escribió de más");
+    for (int i = 0; i < bits; i++) {
+        uint32_t quiero = esperado[i] == '1' ? bit1.val : bit0.val;
+        COMPROBAR(simbolos[i].val == quiero, "bit %d: símbolo %08lx, esperado %08lx", i, (unsigned long)simbolos[i].val,
+                  (unsigned long)quiero);
+    }
+    COMPROBAR(bit0.level0 == 1 && bit0.duration0 == 4 && bit0.level1 == 0 && bit0.duration1 == 8,
+              "patronRMT_simbolo: %u/%u + %u/%u", bit0.level0, bit0.duration0, bit0.level1, bit0.duration1);
+    COMPROBAR(patronRMT_codificarBits(datos, bits, bit0, bit1, simbolos, bits - 1) == -1, "bits: cupieron sin espacio");
+    COMPROBAR(patronRMT_codificarBits(datos, 0, bit0, bit1, simbolos, 0) == 0, "0 bits no son 0 símbolos");
+}
+
+// Cada paso de patronRMT_iniciar falla por turno: regresa el error y libera lo creado
+static void revisarIniciar(void) {
+    for (int falla = 0; falla <= 3; falla++) {
+        patronRMT_t patron;
+        rmtFalso_reiniciar(falla);
+        esp_err_t err = patronRMT_iniciar(&patron, 12, false);
+        COMPROBAR(err == (falla ? ESP_ERR_NO_MEM : ESP_OK), "iniciar, falla en la llamada %d: error %d", falla, err);
+        int vivos = falla ? 0 : 1;
+        COMPROBAR(rmtFalsoCanales == vivos && rmtFalsoCodificadores == vivos,
+                  "iniciar, falla en la llamada %d: %d canales y %d codificadores vivos", falla, rmtFalsoCanales,
+                  rmtFalsoCodificadores);
+        if (!falla) {
+            rmt_del_encoder(patron.copia);
+            rmt_del_channel(patron.canal);
+        }
+    }
+}
+
+int main(void) {
+    revisarFijos();
+    revisarAzar();
+    revisarBits();
+    revisarIniciar();
+    return prueba_fin("prueba_patron_rmt");
+}
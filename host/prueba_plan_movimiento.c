@@ -0,0 +1,116 @@
+// Perfil trapezoidal de PlanMovimiento.h, paso por paso.
+//
+// Desde el reposo, a cada distancia de 0.1 a 180 grados (en décimas) y con
+// varias velocidades, aceleraciones y periodos: ningún sobrepaso del objetivo,
+// la velocidad nunca pasa de vMax ni cambia más de aMax * dt por paso (tampoco
+// en el último, que deja al servo en reposo) y llega al objetivo a más tardar
+// un paso después del perfil continuo ideal. Después, objetivos nuevos
+// al azar a mitad del movimiento: mismos límites, llega exacto al último
+// objetivo y se asienta a tiempo desde donde estaba al cambiar.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../PlanMovimiento.h"
+
+#define CAMBIOS_AZAR 20000
+
+typedef struct {
+    float vMax, aMax, dt;
+} parametros_t;
+
+static const parametros_t casos[] = {
+    {180.0f, 360.0f, 1.0f / 50},    // Los del banco de servos
+    {60.0f, 1000.0f, 1.0f / 50},
+    {300.0f, 200.0f, 1.0f / 200},
+    {90.0f, 90.0f, 1.0f / 50},
+};
+
+static uint32_t azar(void) {
+    static uint32_t x = 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// Tiempo del perfil continuo desde el reposo hasta el reposo
+static float tiempoIdeal(const parametros_t *c, float distancia) {
+    if (distancia >= c->vMax * c->vMax / c->aMax) return distancia / c->vMax + c->vMax / c->aMax;
+    return 2.0f * sqrtf(distancia / c->aMax);
+}
+
+// Un paso dentro de los límites de velocidad y aceleración
+static bool pasoValido(const parametros_t *c, float antes, float despues) {
+    return fabsf(despues) <= c->vMax && fabsf(despues - antes) <= c->aMax * c->dt + PLAN_TOLERANCIA / c->dt;
+}
+
+static void revisarDesdeReposo(const parametros_t *c) {
+    float peorSobrepaso = 0;
+    int peorExtra = -1000;
+    for (int d = 1; d <= 1800; d++) {
+        float objetivo = 90.0f + (d & 1 ? d : -d) / 10.0f;   // Hacia los dos lados desde 90 grados
+        planMovimiento_t plan;
+        plan_iniciar(&plan, 90.0f, c->vMax, c->aMax);
+        plan_objetivo(&plan, objetivo);
+        float sentido = objetivo > 90.0f ? 1.0f : -1.0f, sobrepaso = 0;
+        int pasos = 0, llegada = -1;
+        bool valido = true;
+        while (plan_enMovimiento(&plan) && pasos < 100000) {
+            float antes = plan.velocidad;
+            float posicion = plan_paso(&plan, c->dt);
+            valido &= pasoValido(c, antes, plan.velocidad);
+            if ((posicion - objetivo) * sentido > sobrepaso) sobrepaso = (posicion - objetivo) * sentido;
+            pasos++;
+            if (posicion != objetivo) llegada = -1;
+            else if (llegada < 0) llegada = pasos;
+        }
+        int ideal = (int)ceilf(tiempoIdeal(c, d / 10.0f) / c->dt);
+        COMPROBAR(valido, "vMax %.0f, aMax %.0f, %.1f grados: velocidad o aceleración fuera de límite", c->vMax,
+                  c->aMax, d / 10.0f);
+        COMPROBAR(sobrepaso <= 1e-3f, "vMax %.0f, aMax %.0f, %.1f grados: sobrepaso de %.3f grados", c->vMax, c->aMax,
+                  d / 10.0f, sobrepaso);
+        // Llega a más tardar un paso después del ideal y el paso siguiente solo termina de frenar
+        COMPROBAR(llegada >= 0 && llegada <= ideal + 1 && pasos <= llegada + 1 && plan.posicion == objetivo,
+                  "vMax %.0f, aMax %.0f, %.1f grados: llega en %d pasos (ideal %d), en reposo en %d, termina en %.4f",
+                  c->vMax, c->aMax, d / 10.0f, llegada, ideal, pasos, plan.posicion);
+        if (sobrepaso > peorSobrepaso) peorSobrepaso = sobrepaso;
+        if (llegada - ideal > peorExtra) peorExtra = llegada - ideal;
+    }
+    printf("vMax %3.0f, aMax %4.0f, dt %4.1f ms: sobrepaso máximo %.4f grados, llega hasta %+d pasos del ideal\n",
+           c->vMax, c->aMax, c->dt * 1000, peorSobrepaso, peorExtra);
+}
+
+// Objetivos nuevos a mitad del movimiento: el perfil se recalcula sin saltos
+static void revisarCambios(const parametros_t *c) {
+    planMovimiento_t plan;
+    plan_iniciar(&plan, 90.0f, c->vMax, c->aMax);
+    for (int i = 0; i < CAMBIOS_AZAR; i++) {
+        plan_objetivo(&plan, (azar() % 1801) / 10.0f);
+        // Frenar desde la velocidad actual y volver hasta el objetivo desde donde se detuvo
+        float v = fabsf(plan.velocidad), frenado = v * v / (2.0f * c->aMax);
+        float limite = v / c->aMax + tiempoIdeal(c, fabsf(plan.objetivo - plan.posicion) + 2.0f * frenado);
+        int maximo = (int)ceilf(limite / c->dt) + 2;
+        // A veces el objetivo cambia otra vez antes de llegar
+        int pasos = azar() % 3 ? maximo : (int)(azar() % (maximo + 1));
+        bool valido = true;
+        int n = 0;
+        for (; n < pasos && plan_enMovimiento(&plan); n++) {
+            float antes = plan.velocidad;
+            plan_paso(&plan, c->dt);
+            valido &= pasoValido(c, antes, plan.velocidad);
+        }
+        COMPROBAR(valido, "cambio %d: velocidad o aceleración fuera de límite", i);
+        if (pasos == maximo) {
+            COMPROBAR(!plan_enMovimiento(&plan), "cambio %d: sigue en %.3f (objetivo %.1f, v %.1f) tras %d pasos", i,
+                      plan.posicion, plan.objetivo, plan.velocidad, n);
+        }
+    }
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+        revisarDesdeReposo(&casos[i]);
+        revisarCambios(&casos[i]);
+    }
+    return prueba_fin("prueba_plan_movimiento");
+}
@@ -0,0 +1,118 @@
+// Refresco del display de la práctica 7 contra un ADC simulado.
+//
+// El tiempo es simulado: el ISR de refresco corre en cada alarma del timer,
+// también en medio de una conversión del ADC. Con cualquier periodo de
+// muestreo y cualquier duración de conversión, cada dígito se enciende cada
+// 3 ms exactos (333 Hz, el mínimo pedido es 200 Hz) y muestra el dígito del
+// último número publicado.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../Practica_7.c"
+
+static int crudo;                   // Siguiente lectura del ADC
+static int64_t conversion_us;       // Lo que tarda cada lectura
+static int64_t siguienteAlarma;
+static int numeroPublicado;
+static int64_t ultimoEncendido[3];
+static int64_t intervaloMin[3], intervaloMax[3];
+static uint32_t refrescos;
+
+static int digitoEncendido(uint32_t salidas) {
+    for (int d = 0; d < 3; d++) {
+        if ((salidas & MASCARA_DISPLAY & ~SEG7_SEGMENTOS0) == mascaraCatodos[d]) return d;
+    }
+    return -1;
+}
+
+static int glifo(uint32_t salidas) {
+    for (int n = 0; n < 10; n++) {
+        if ((salidas & SEG7_SEGMENTOS0) == seg7Fuente[SEG7_0 + n].set0) return n;
+    }
+    return -1;
+}
+
+static void revisarSalidas(void) {
+    uint32_t salidas = (uint32_t)gpioFalso_salidas();
+    int d = digitoEncendido(salidas);
+    COMPROBAR(d >= 0, "t=%lld: catodos %lx", (long long)relojFalso_us, (unsigned long)salidas);
+    if (d < 0) return;
+
+    static const int potencias[3] = {1, 10, 100};
+    int esperado = (numeroPublicado / potencias[d]) % 10;
+    COMPROBAR(glifo(salidas) == esperado, "t=%lld: dígito %d muestra %d, publicado %d", (long long)relojFalso_us, d,
+              glifo(salidas), numeroPublicado);
+
+    if (ultimoEncendido[d] >= 0) {
+        int64_t intervalo = relojFalso_us - ultimoEncendido[d];
+        if (intervalo < intervaloMin[d]) intervaloMin[d] = intervalo;
+        if (intervalo > intervaloMax[d]) intervaloMax[d] = intervalo;
+    }
+    ultimoEncendido[d] = relojFalso_us;
+    refrescos++;
+}
+
+// Avanza el reloj simulado atendiendo las alarmas del timer de refresco
+static void avanzar(int64_t us) {
+    int64_t fin = relojFalso_us + us;
+    while (siguienteAlarma <= fin) {
+        relojFalso_us = siguienteAlarma;
+        refrescarDisplay(NULL, NULL, NULL);
+        revisarSalidas();
+        siguienteAlarma += INTERVALO_REFRESCO_US;
+    }
+    relojFalso_us = fin;
+}
+
+int adc1_get_raw(int canal) {
+    avanzar(conversion_us);
+    return crudo;
+}
+
+static void escenario(int periodo_ms, int64_t conversion, bool celsius) {
+    gpioFalso_reiniciar();
+    relojFalso_us = 0;
+    siguienteAlarma = INTERVALO_REFRESCO_US;
+    conversion_us = conversion;
+    mostrarCelsius = celsius;
+    refrescos = 0;
+    for (int d = 0; d < 3; d++) {
+        ultimoEncendido[d] = -1;
+        intervaloMin[d] = INT64_MAX;
+        intervaloMax[d] = 0;
+    }
+    numeroPublicado = 0;
+    mostrarNumero(0);
+
+    uint32_t muestras = 0;
+    srand(periodo_ms * 7919 + (int)conversion);
+    while (relojFalso_us < 2000000) {
+        // Lo mismo que task_temperatura, con el ADC simulado
+        crudo = rand() % 4096;
+        float t = leerTemperatura();
+        int mostrar = (int)(mostrarCelsius ? t : (t * 9.0 / 5.0) + 32.0);
+        mostrarNumero(mostrar);
+        numeroPublicado = mostrar;
+        muestras++;
+        avanzar(periodo_ms * 1000);
+    }
+
+    for (int d = 0; d < 3; d++) {
+        COMPROBAR(intervaloMin[d] == 3 * INTERVALO_REFRESCO_US && intervaloMax[d] == 3 * INTERVALO_REFRESCO_US,
+                  "muestreo %d ms, conversión %lld us: dígito %d cada %lld-%lld us", periodo_ms, (long long)conversion,
+                  d, (long long)intervaloMin[d], (long long)intervaloMax[d]);
+        COMPROBAR(1000000 / intervaloMax[d] >= 200, "dígito %d a %lld Hz", d, (long long)(1000000 / intervaloMax[d]));
+    }
+    printf("Muestreo cada %3d ms + %4lld us de conversión: %5lu muestras, %lu refrescos, %lld Hz por dígito\n",
+           periodo_ms, (long long)conversion, (unsigned long)muestras, (unsigned long)refrescos,
+           (long long)(1000000 / intervaloMax[0]));
+}
+
+int main(void) {
+    escenario(PERIODO_MUESTREO_MS, 50, true);
+    escenario(1, 900, true);
+    escenario(0, 2500, false);     // Muestreo continuo con conversiones lentas
+    escenario(500, 10, false);
+    escenario(7, 333, true);
+    return prueba_fin("prueba_refresco_temperatura");
+}
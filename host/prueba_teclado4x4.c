@@ -0,0 +1,129 @@
+// Núcleo del teclado 4x4 de Teclado4x4.h.
+//
+// teclado4x4_fantasma se compara en los 65536 mapas con una búsqueda directa de
+// rectángulos (dos filas y dos columnas con las cuatro esquinas). Una matriz
+// sin diodos simulada enciende la cuarta esquina de cada rectángulo de tres, y
+// se revisan los casos del teclado: la tecla nueva se retiene mientras la
+// lectura es ambigua (anterior & leido), las que se sueltan durante el
+// fantasma salen enseguida y la retenida sale cuando el patrón se aclara.
+// Después, las invariantes de teclado4x4_diferencia sobre pares al azar y
+// teclado4x4_texto.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../Teclado4x4.h"
+
+#define PARES 1000000
+
+static const char teclas[17] = "123A456B789C*0#D";
+
+#define TECLA(fila, columna) (1u << ((fila) * 4 + (columna)))
+
+static bool fantasmaDirecto(uint16_t mapa) {
+    for (int a = 0; a < 4; a++)
+        for (int b = a + 1; b < 4; b++)
+            for (int c = 0; c < 4; c++)
+                for (int d = c + 1; d < 4; d++) {
+                    uint16_t esquinas = TECLA(a, c) | TECLA(a, d) | TECLA(b, c) | TECLA(b, d);
+                    if ((mapa & esquinas) == esquinas) return true;
+                }
+    return false;
+}
+
+// Lo que lee el barrido de una matriz sin diodos: por cada rectángulo con tres
+// esquinas presionadas la cuarta también se lee abajo (hasta que no cambie)
+static uint16_t leerMatriz(uint16_t presionadas) {
+    uint16_t leido = presionadas, antes;
+    do {
+        antes = leido;
+        for (int a = 0; a < 4; a++)
+            for (int b = 0; b < 4; b++) {
+                if (a == b) continue;
+                uint8_t comunes = TECLADO4X4_FILA(leido, a) & TECLADO4X4_FILA(leido, b);
+                // Dos filas unidas por una columna común comparten todas sus columnas
+                if (comunes) leido |= TECLADO4X4_FILA(leido, a) << (b * 4);
+            }
+    } while (leido != antes);
+    return leido;
+}
+
+static void revisarFantasma(void) {
+    int ambiguos = 0;
+    for (uint32_t m = 0; m <= 0xFFFF; m++) {
+        bool directo = fantasmaDirecto(m);
+        ambiguos += directo;
+        COMPROBAR(teclado4x4_fantasma(m) == directo, "mapa %04lx: fantasma %d, directo %d", (unsigned long)m,
+                  teclado4x4_fantasma(m), directo);
+    }
+    printf("%d de 65536 mapas son ambiguos\n", ambiguos);
+
+    // Tres esquinas presionadas de verdad: se leen cuatro y el mapa es ambiguo
+    uint16_t tres = TECLA(0, 0) | TECLA(0, 1) | TECLA(1, 0);
+    COMPROBAR(leerMatriz(tres) == (tres | TECLA(1, 1)), "la matriz no enciende la cuarta esquina: %04x",
+              leerMatriz(tres));
+    COMPROBAR(teclado4x4_fantasma(leerMatriz(tres)), "tres esquinas no son ambiguas");
+    // Dos teclas en la misma columna, o '*' + un dígito, no lo son
+    COMPROBAR(!teclado4x4_fantasma(leerMatriz(TECLA(0, 0) | TECLA(1, 0))), "misma columna ambigua");
+    COMPROBAR(!teclado4x4_fantasma(leerMatriz(TECLA(3, 0) | TECLA(1, 1))), "'*' + 5 ambiguo");
+}
+
+static void revisarDiferencia(void) {
+    const uint16_t uno = TECLA(0, 0), dos = TECLA(0, 1), cuatro = TECLA(1, 0), cinco = TECLA(1, 1);
+    const uint16_t ce = TECLA(2, 3);
+
+    // '1' y '2' aceptadas, se presiona '4': se lee también '5' y nada cambia
+    teclado4x4Cambios_t c = teclado4x4_diferencia(uno | dos, leerMatriz(uno | dos | cuatro));
+    COMPROBAR(c.fantasma && c.presionadas == 0 && c.liberadas == 0 && c.estado == (uno | dos),
+              "'4' con '1' y '2': fantasma %d, presionadas %04x, liberadas %04x, estado %04x", c.fantasma,
+              c.presionadas, c.liberadas, c.estado);
+
+    // Se suelta '1': el patrón se aclara y sale '4' (retenido) junto con la liberación
+    c = teclado4x4_diferencia(c.estado, leerMatriz(dos | cuatro));
+    COMPROBAR(!c.fantasma && c.presionadas == cuatro && c.liberadas == uno && c.estado == (dos | cuatro),
+              "se suelta '1': presionadas %04x, liberadas %04x, estado %04x", c.presionadas, c.liberadas, c.estado);
+
+    // Con 'C' aceptada, se suelta 'C' y a la vez se forma un fantasma: la liberación sale
+    c = teclado4x4_diferencia(uno | dos | ce, leerMatriz(uno | dos | cuatro));
+    COMPROBAR(c.fantasma && c.liberadas == ce && c.presionadas == 0 && c.estado == (uno | dos),
+              "suelta 'C' en fantasma: liberadas %04x, presionadas %04x, estado %04x", c.liberadas, c.presionadas,
+              c.estado);
+
+    // La cuarta esquina presionada de verdad tampoco se acepta mientras haya ambigüedad
+    c = teclado4x4_diferencia(uno | dos | cuatro, leerMatriz(uno | dos | cuatro | cinco));
+    COMPROBAR(c.fantasma && c.presionadas == 0 && c.estado == (uno | dos | cuatro), "cuarta esquina aceptada: %04x",
+              c.estado);
+
+    // Invariantes sobre pares al azar
+    srand(7);
+    for (int i = 0; i < PARES; i++) {
+        // Un mapa aceptado nunca es ambiguo
+        uint16_t anterior, leido = rand() & rand();
+        do anterior = rand() & rand(); while (teclado4x4_fantasma(anterior));
+        c = teclado4x4_diferencia(anterior, leido);
+        bool bien = (c.presionadas & c.liberadas) == 0 && !teclado4x4_fantasma(c.estado) &&
+                    c.estado == (uint16_t)((anterior | c.presionadas) & ~c.liberadas) &&
+                    c.fantasma == teclado4x4_fantasma(leido) &&
+                    (c.fantasma ? (c.presionadas == 0 && c.estado == (anterior & leido)) : c.estado == leido);
+        if (!bien) {
+            COMPROBAR(false, "anterior %04x, leido %04x: presionadas %04x, liberadas %04x, estado %04x", anterior,
+                      leido, c.presionadas, c.liberadas, c.estado);
+            break;
+        }
+    }
+}
+
+static void revisarTexto(void) {
+    char texto[17];
+    COMPROBAR(teclado4x4_texto(0, teclas, texto) == 0 && texto[0] == '\0', "mapa vacío: \"%s\"", texto);
+    COMPROBAR(teclado4x4_texto(TECLA(3, 0) | TECLA(1, 1), teclas, texto) == 2 && strcmp(texto, "5*") == 0,
+              "'*' + 5: \"%s\"", texto);
+    COMPROBAR(teclado4x4_texto(0xFFFF, teclas, texto) == 16 && strcmp(texto, teclas) == 0, "todas: \"%s\"", texto);
+    COMPROBAR(teclado4x4_texto(TECLA(3, 3), teclas, texto) == 1 && strcmp(texto, "D") == 0, "D: \"%s\"", texto);
+}
+
+int main(void) {
+    revisarFantasma();
+    revisarDiferencia();
+    revisarTexto();
+    return prueba_fin("prueba_teclado4x4");
+}
@@ -0,0 +1,171 @@
+// Escaneo del teclado de la práctica 6 con una matriz simulada.
+//
+// Las filas falsas se calculan de las columnas que el escaneo deja en bajo en
+// GPIO.out1 y de las teclas presionadas: una fila baja si alguna tecla suya está
+// en una columna activa. Los cambios de fila pasan por la interrupción de
+// EventosGPIO (despertar del reposo) y dos gptimers falsos dan los ticks del
+// escaneo y de la rueda del display. Las teclas rebotan unos ms al presionar y al soltar.
+//
+// Cada una de las 16 teclas, sola, debe dar exactamente un evento de presión y
+// uno de liberación con su bit, a tiempo, sin eventos perdidos; entre teclas el
+// teclado vuelve al reposo y el escaneo deja de despertar al CPU. Los
+// despertares se cuentan en los gptimers y en la interrupción de GPIO: en
+// reposo solo queda el tick del display. Después un
+// '*' sostenido con un dígito encima: el dígito sale en su propio evento.
+
+#include "prueba.h"
+#include "falsos.h"
+
+#undef ESP_LOGI
+#define ESP_LOGI(tag, ...) ((void)(tag))
+#pragma GCC diagnostic ignored "-Wunused-variable"   // Variables que solo usa el log de app_main
+#include "../Practica_6.c"
+#pragma GCC diagnostic warning "-Wunused-variable"
+
+#define PASO_US 100
+#define CONSUMO_US 10000          // app_main revisa la cola cada tiempoRetardo ms
+#define MAXIMO_ESPERA_US 30000    // Rebote + 4 muestras por tecla + un barrido
+
+static uint16_t presionadas;      // Teclas abajo de verdad
+static int64_t rebotaHasta;       // Mientras tanto las teclas que cambian parpadean
+static uint16_t rebotando;
+static eventoTecla_t eventos[64];
+static int nEventos;
+
+static uint32_t azar(void) {
+    static uint32_t x = 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// Una fila baja si alguna de sus teclas está en una columna en bajo
+static void actualizarFilas(void) {
+    uint32_t columnasBajas = ~(uint32_t)(gpioFalso_salidas() >> 32) & MASCARA_COLUMNAS;
+    uint16_t leidas = presionadas;
+    if (relojFalso_us < rebotaHasta) leidas ^= rebotando & azar();
+    for (int fila = 0; fila < 4; fila++) {
+        bool baja = false;
+        for (int columna = 0; columna < 4; columna++) {
+            baja |= (leidas & (1 << (fila * 4 + columna))) && (columnasBajas & mascaraColumna[columna]);
+        }
+        gpioFalso_entrada(filas[fila], !baja);
+    }
+}
+
+static void avanzar(int64_t us) {
+    int64_t fin = relojFalso_us + us;
+    while (relojFalso_us < fin) {
+        relojFalso_us += PASO_US;
+        actualizarFilas();
+        gptimerFalso_avanzar(timerEscaneo, PASO_US);
+        gptimerFalso_avanzar(timersSoft.timer, PASO_US);
+        if (relojFalso_us % CONSUMO_US == 0) {
+            while (nEventos < 64 && sacarEvento(&eventos[nEventos])) nEventos++;
+        }
+    }
+}
+
+static void cambiar(uint16_t nuevas) {
+    rebotando = presionadas ^ nuevas;
+    rebotaHasta = relojFalso_us + 500 + azar() % 4000;
+    presionadas = nuevas;
+}
+
+// Un solo evento con exactamente estos cambios, dentro del tiempo
+static void revisarEvento(int desde, const char *caso, uint16_t presion, uint16_t liberacion, int64_t inicio) {
+    int cuantos = 0;
+    for (int i = desde; i < nEventos; i++) {
+        if (eventos[i].presionadas || eventos[i].liberadas) {
+            cuantos++;
+            COMPROBAR(eventos[i].presionadas == presion && eventos[i].liberadas == liberacion && !eventos[i].fantasma,
+                      "%s: presionadas %04x, liberadas %04x (esperadas %04x, %04x)", caso, eventos[i].presionadas,
+                      eventos[i].liberadas, presion, liberacion);
+            COMPROBAR(eventos[i].tiempo_us - inicio <= MAXIMO_ESPERA_US, "%s: salió %lld us después", caso,
+                      (long long)(eventos[i].tiempo_us - inicio));
+        }
+    }
+    COMPROBAR(cuantos == 1, "%s: %d eventos", caso, cuantos);
+}
+
+static void revisarTeclas(void) {
+    for (int k = 0; k < 16; k++) {
+        char caso[32];
+        COMPROBAR(tecladoEnReposo, "tecla %c: el teclado no estaba en reposo", mapaTeclado[k / 4][k % 4]);
+        uint32_t ticks = ticksEscaneo, despertares = despertaresFilas;
+
+        nEventos = 0;
+        int64_t inicio = relojFalso_us;
+        cambiar(1 << k);
+        avanzar(60000 + azar() % 100000);
+        snprintf(caso, sizeof(caso), "tecla %c, presión", mapaTeclado[k / 4][k % 4]);
+        revisarEvento(0, caso, 1 << k, 0, inicio);
+        COMPROBAR(despertaresFilas - despertares == 1, "tecla %d: %lu despertares", k,
+                  (unsigned long)(despertaresFilas - despertares));
+
+        int desde = nEventos;
+        inicio = relojFalso_us;
+        cambiar(0);
+        avanzar(300000);   // Más que tiempoQuieto_ms: de regreso al reposo
+        snprintf(caso, sizeof(caso), "tecla %c, liberación", mapaTeclado[k / 4][k % 4]);
+        revisarEvento(desde, caso, 0, 1 << k, inicio);
+
+        // En reposo el CPU solo despierta por el display: ni el gptimer del escaneo ni las filas
+        gptimerFalso_t *escaneo = timerEscaneo, *rueda = timersSoft.timer;
+        uint32_t alarmas = escaneo->alarmas, display = rueda->alarmas, gpio = gpioFalsoInterrupciones;
+        avanzar(100000);
+        uint32_t enReposo = (escaneo->alarmas - alarmas) + (rueda->alarmas - display) +
+                            (gpioFalsoInterrupciones - gpio);
+        COMPROBAR(enReposo == 100000 / intervaloTimer_us && rueda->alarmas - display == enReposo,
+                  "tecla %d: %lu despertares en reposo (%lu del escaneo, %lu del display, %lu de GPIO)", k,
+                  (unsigned long)enReposo, (unsigned long)(escaneo->alarmas - alarmas),
+                  (unsigned long)(rueda->alarmas - display), (unsigned long)(gpioFalsoInterrupciones - gpio));
+        COMPROBAR(ticksEscaneo == escaneo->alarmas, "tecla %d: %lu ticks de escaneo contados, %lu interrupciones",
+                  k, (unsigned long)ticksEscaneo, (unsigned long)escaneo->alarmas);
+        COMPROBAR(ticksEscaneo - ticks < 400, "tecla %d: %lu ticks para una pulsación", k,
+                  (unsigned long)(ticksEscaneo - ticks));
+    }
+}
+
+// '*' sostenido y un dígito encima, luego se sueltan en orden inverso
+static void revisarCombinacion(void) {
+    const uint16_t asterisco = 1 << 12, cinco = 1 << 5;
+    nEventos = 0;
+    int64_t inicio = relojFalso_us;
+    cambiar(asterisco);
+    avanzar(80000);
+    revisarEvento(0, "'*'", asterisco, 0, inicio);
+    int desde = nEventos;
+    inicio = relojFalso_us;
+    cambiar(asterisco | cinco);
+    avanzar(80000);
+    revisarEvento(desde, "'*' + '5'", cinco, 0, inicio);
+    COMPROBAR(teclasPresionadas == (asterisco | cinco), "mapa aceptado %04x", teclasPresionadas);
+    desde = nEventos;
+    inicio = relojFalso_us;
+    cambiar(asterisco);
+    avanzar(80000);
+    revisarEvento(desde, "suelta '5'", 0, cinco, inicio);
+    desde = nEventos;
+    inicio = relojFalso_us;
+    cambiar(0);
+    avanzar(300000);
+    revisarEvento(desde, "suelta '*'", 0, asterisco, inicio);
+}
+
+int main(void) {
+    gpioFalso_reiniciar();
+    for (int i = 0; i < 4; i++) gpioFalso_entrada(filas[i], 1);   // Pull-up
+    configurarTeclado();
+    configurarTimer();
+    configurarDisplays();
+
+    revisarTeclas();
+    revisarCombinacion();
+    COMPROBAR(eventosPerdidos == 0, "%lu eventos perdidos", (unsigned long)eventosPerdidos);
+    COMPROBAR(flancosFilas.perdidos == 0, "%lu flancos de fila perdidos", (unsigned long)flancosFilas.perdidos);
+    printf("16 teclas y una combinación: %lu ticks de escaneo, %lu despertares por fila, %lu eventos perdidos\n",
+           (unsigned long)ticksEscaneo, (unsigned long)despertaresFilas, (unsigned long)eventosPerdidos);
+    return prueba_fin("prueba_teclado_practica6");
+}
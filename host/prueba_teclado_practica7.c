@@ -0,0 +1,193 @@
+// task_teclado de la práctica 7 con el consumidor detenido.
+//
+// La tarea corre en la prueba: vTaskDelayUntil y ulTaskNotifyTake avanzan el
+// mundo de milisegundo en milisegundo y las filas falsas siguen a las columnas
+// (fila baja si una tecla presionada está en una columna en bajo), así el
+// reposo despierta con el flanco de verdad.
+//
+// Primero se inunda colaTeclado: '5' sostenida 3 s y una ráfaga de teclas
+// sin nadie que lea. El barrido no debe bloquearse nunca (ningún envío con
+// espera), debe seguir cada 10 ms y los mensajes que no caben se cuentan en
+// teclasPerdidas; los 10 que quedan son los más viejos, en orden. Después, con
+// el consumidor leyendo, la autorrepetición sale 500 ms después de la presión
+// y luego cada 100 ms exactos, sin pérdidas.
+
+#include <setjmp.h>
+#include "prueba.h"
+#include "falsos.h"
+
+#undef ESP_LOGI
+#define ESP_LOGI(tag, ...) ((void)(tag))
+#include "../Practica_7.c"
+
+#define LARGO_COLA 10            // El de app_main
+#define MAXIMO_RECIBIDOS 256
+
+typedef struct {
+    int64_t inicio_ms, fin_ms;   // Tecla abajo en [inicio, fin)
+    uint16_t teclas;
+} pulsacion_t;
+
+static const pulsacion_t *guion;
+static int largoGuion;
+static int64_t finEscena_ms;
+static bool consumidorActivo;
+static jmp_buf fin;
+
+static teclado4x4Cambios_t recibidos[MAXIMO_RECIBIDOS];
+static int64_t llegadas[MAXIMO_RECIBIDOS];
+static int nRecibidos;
+static uint32_t avisosTomados, msDormida, barridosAtrasados;
+
+static int64_t ahora_ms(void) { return relojFalso_us / 1000; }
+
+// Una fila baja si alguna de sus teclas presionadas está en una columna en bajo
+static void actualizarFilas(void) {
+    static const uint8_t columnas[4] = {COL_1, COL_2, COL_3, COL_4};
+    uint16_t presionadas = 0;
+    for (int i = 0; i < largoGuion; i++) {
+        if (ahora_ms() >= guion[i].inicio_ms && ahora_ms() < guion[i].fin_ms) presionadas |= guion[i].teclas;
+    }
+    uint64_t salidas = gpioFalso_salidas();
+    for (int fila = 0; fila < 4; fila++) {
+        bool baja = false;
+        for (int columna = 0; columna < 4; columna++) {
+            baja |= (presionadas & (1 << (fila * 4 + columna))) && !((salidas >> columnas[columna]) & 1);
+        }
+        gpioFalso_entrada(filasTeclado[fila], !baja);
+    }
+}
+
+static void vaciarCola(void) {
+    while (nRecibidos < MAXIMO_RECIBIDOS && xQueueReceive(colaTeclado, &recibidos[nRecibidos], 0) == pdTRUE) {
+        llegadas[nRecibidos++] = ahora_ms();
+    }
+}
+
+// Un milisegundo del mundo: teclas, filas y el consumidor si está leyendo
+static void pasoMundo(void) {
+    relojFalso_us += 1000;
+    if (ahora_ms() >= finEscena_ms) longjmp(fin, 1);
+    actualizarFilas();
+    if (consumidorActivo) vaciarCola();
+}
+
+TickType_t xTaskGetTickCount(void) { return (TickType_t)ahora_ms(); }
+
+void vTaskDelayUntil(TickType_t *anterior, TickType_t incremento) {
+    *anterior += incremento;
+    if ((int64_t)*anterior * 1000 <= relojFalso_us) barridosAtrasados++;
+    while (relojFalso_us < (int64_t)*anterior * 1000) pasoMundo();
+}
+
+// Dormida hasta que la ISR de las filas avise
+uint32_t ulTaskNotifyTake(BaseType_t limpiar, TickType_t espera) {
+    while (espera && notificacionesFalsas == avisosTomados) {
+        pasoMundo();
+        msDormida++;
+    }
+    uint32_t avisos = notificacionesFalsas - avisosTomados;
+    avisosTomados = notificacionesFalsas;
+    return avisos;
+}
+
+static void correr(const pulsacion_t *g, int largo, int64_t duracion_ms) {
+    guion = g;
+    largoGuion = largo;
+    finEscena_ms = ahora_ms() + duracion_ms;
+    for (int i = 0; i < 4; i++) gpio_intr_disable(filasTeclado[i]);
+    actualizarFilas();
+    if (setjmp(fin) == 0) task_teclado(NULL);
+}
+
+static void revisarInundacion(void) {
+    colaFalsa_t *cola = colaTeclado;
+    int64_t t0 = ahora_ms();
+    const uint16_t cinco = 1 << 5;
+    pulsacion_t g[17] = {{t0 + 100, t0 + 3100, cinco}};
+    for (int i = 0; i < 16; i++) {
+        int64_t inicio = t0 + 3300 + i * 120;
+        g[1 + i] = (pulsacion_t){inicio, inicio + 60, 1 << i};
+    }
+    uint32_t barridos = barridosTeclado;
+    consumidorActivo = false;
+    correr(g, 17, 5600);
+
+    // '5': presión + repeticiones + liberación; cada tecla de la ráfaga: presión + liberación
+    COMPROBAR(cola->bloqueos == 0, "el barrido esperó %lu veces en colaTeclado", (unsigned long)cola->bloqueos);
+    COMPROBAR(cola->cuenta == LARGO_COLA, "%lu mensajes en la cola", (unsigned long)cola->cuenta);
+    COMPROBAR(teclasPerdidas == cola->llenas && teclasPerdidas + LARGO_COLA >= 2 + 25 + 2 * 16,
+              "%lu mensajes perdidos, %lu envíos rechazados", (unsigned long)teclasPerdidas,
+              (unsigned long)cola->llenas);
+    COMPROBAR(barridosAtrasados == 0, "%lu barridos atrasados", (unsigned long)barridosAtrasados);
+    // Despierto de la presión de '5' al final de la ráfaga: un barrido cada 10 ms
+    uint32_t despierta_ms = 5600 - msDormida;
+    COMPROBAR(barridosTeclado - barridos >= despierta_ms / PERIODO_TECLADO_MS - 1 &&
+                  barridosTeclado - barridos <= despierta_ms / PERIODO_TECLADO_MS + 2,
+              "%lu barridos en %lu ms despierto", (unsigned long)(barridosTeclado - barridos),
+              (unsigned long)despierta_ms);
+
+    // Lo que quedó: la presión de '5' y sus primeras repeticiones, en orden
+    nRecibidos = 0;
+    vaciarCola();
+    COMPROBAR(nRecibidos == LARGO_COLA, "%d mensajes al vaciar la cola", nRecibidos);
+    for (int i = 0; i < nRecibidos; i++) {
+        COMPROBAR(recibidos[i].presionadas == cinco && recibidos[i].liberadas == 0 && recibidos[i].estado == cinco,
+                  "mensaje %d: presionadas %04x, liberadas %04x, estado %04x", i, recibidos[i].presionadas,
+                  recibidos[i].liberadas, recibidos[i].estado);
+    }
+}
+
+// Con el consumidor al día: presión, repeticiones a 500 ms y cada 100 ms, liberación
+static void revisarRepeticion(int tecla, int64_t sostener_ms) {
+    const uint16_t bit = 1 << tecla;
+    uint32_t perdidas = teclasPerdidas;
+    int64_t t0 = ahora_ms();
+    const pulsacion_t g[] = {{t0 + 50, t0 + 50 + sostener_ms, bit}};
+    nRecibidos = 0;
+    consumidorActivo = true;
+    correr(g, 1, sostener_ms + 500);
+
+    COMPROBAR(teclasPerdidas == perdidas, "tecla %c: %lu perdidas", mapaTeclado[tecla],
+              (unsigned long)(teclasPerdidas - perdidas));
+    COMPROBAR(nRecibidos >= 2 && recibidos[0].presionadas == bit && recibidos[nRecibidos - 1].liberadas == bit,
+              "tecla %c: %d mensajes sin presión y liberación", mapaTeclado[tecla], nRecibidos);
+    if (nRecibidos < 2) return;
+    // Presión con el antirrebote: a más tardar 5 barridos después del flanco
+    COMPROBAR(llegadas[0] - (t0 + 50) <= 5 * PERIODO_TECLADO_MS, "tecla %c: presión a los %lld ms",
+              mapaTeclado[tecla], (long long)(llegadas[0] - (t0 + 50)));
+    int repeticiones = nRecibidos - 2;
+    int64_t anterior = llegadas[0];
+    for (int i = 1; i <= repeticiones; i++) {
+        int64_t esperado = i == 1 ? REPETICION_RETARDO_MS : REPETICION_PERIODO_MS;
+        COMPROBAR(recibidos[i].presionadas == bit && recibidos[i].liberadas == 0,
+                  "tecla %c, repetición %d: presionadas %04x", mapaTeclado[tecla], i, recibidos[i].presionadas);
+        COMPROBAR(llegadas[i] - anterior == esperado, "tecla %c, repetición %d a %lld ms de la anterior",
+                  mapaTeclado[tecla], i, (long long)(llegadas[i] - anterior));
+        anterior = llegadas[i];
+    }
+    // Ninguna repetición faltante antes de soltar
+    int64_t soltada = llegadas[nRecibidos - 1];
+    int esperadas = soltada - llegadas[0] > REPETICION_RETARDO_MS
+                        ? 1 + (soltada - llegadas[0] - REPETICION_RETARDO_MS - 1) / REPETICION_PERIODO_MS
+                        : 0;
+    COMPROBAR(repeticiones == esperadas, "tecla %c sostenida %lld ms: %d repeticiones, esperadas %d",
+              mapaTeclado[tecla], (long long)sostener_ms, repeticiones, esperadas);
+}
+
+int main(void) {
+    for (int i = 0; i < 4; i++) gpioFalso_entrada(filasTeclado[i], 1);   // Pull-up
+    configurarGPIO();
+    configurarReposoTeclado();
+    colaTeclado = xQueueCreate(LARGO_COLA, sizeof(teclado4x4Cambios_t));
+    gpioFalso_alEscribir = actualizarFilas;
+
+    revisarInundacion();
+    int64_t t0 = ahora_ms();
+    revisarRepeticion(9, 1500);
+    revisarRepeticion(0, 400);
+    revisarRepeticion(15, 2345);
+    printf("Inundación: %lu mensajes perdidos, 0 esperas; repeticiones de 500 + 100 ms exactas en %lld ms\n",
+           (unsigned long)(((colaFalsa_t *)colaTeclado)->llenas), (long long)(ahora_ms() - t0));
+    return prueba_fin("prueba_teclado_practica7");
+}
@@ -0,0 +1,199 @@
+// Rueda de tiempo de TimersSoft.h con el gptimer falso.
+//
+// 2000 timers al azar (una vez y periódicos, en la ISR y en la tarea) corren
+// 400k ticks que cruzan la vuelta de los 32 bits del contador de ticks. Los
+// callbacks rearman su timer o cancelan otro al azar. Cada disparo debe caer en
+// su tick exacto, fuera de la sección crítica, y ningún timer cancelado debe
+// dispararse. Con la rueda vacía el gptimer se detiene y armar lo arranca.
+// Después, retardos más largos que lo que cubre la rueda (RUEDA_MAXIMO): no
+// deben adelantarse. Al iniciar, sin memoria para la cola o la tarea, el error
+// es ESP_ERR_NO_MEM.
+
+#include "prueba.h"
+#include "falsos.h"
+#include "../TimersSoft.h"
+
+#define TIMERS 2000
+#define TICKS 400000
+
+typedef struct {
+    timerSoft_t timer;
+    uint64_t esperado;    // Tick simulado (64 bits) del siguiente disparo, 0 = desarmado
+    uint32_t periodo;
+    uint32_t disparos;
+} prueba_t;
+
+static prueba_t timers[TIMERS];
+static uint64_t tickActual;        // Tick que se está atendiendo, sin vuelta de 32 bits
+static uint32_t enTarea;           // Disparos recibidos por la cola
+static uint32_t rearmados, cancelados;
+static bool accionesAzar;          // Los callbacks rearman y cancelan timers al azar
+
+static uint32_t azar(void) {
+    static uint32_t x = 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+static uint32_t retardoAzar(void) {
+    switch (azar() % 4) {
+    case 0: return 1 + azar() % RUEDA_CASILLAS0;           // Nivel 0
+    case 1: return 1 + azar() % (1 << 14);                 // Nivel 1
+    case 2: return 1 + azar() % (1 << 18);                 // Nivel 2
+    default: return 1 + azar() % (TICKS / 2);
+    }
+}
+
+// "ahora" es el siguiente tick por atender; un timer armado fuera de la ISR vence
+// en el tick ahora + retardo - 1, y dentro de un callback en tickActual + retardo
+static void armar(prueba_t *p, uint32_t retardo, uint32_t periodo, uint64_t base) {
+    p->periodo = periodo;
+    p->esperado = base + retardo;
+    timerSoft_armar(&p->timer, retardo, periodo);
+}
+
+static bool disparo(void *arg) {
+    prueba_t *p = arg;
+    // Un disparo de tarea que ya estaba en la cola se ejecuta aunque lo hayan cancelado
+    if (p->esperado == 0 && p->timer.modo == TIMER_SOFT_TAREA) return false;
+    COMPROBAR(p->esperado == tickActual, "timer %d: disparó en %llu, esperado %llu", (int)(p - timers),
+              (unsigned long long)tickActual, (unsigned long long)p->esperado);
+    COMPROBAR(seccionCriticaFalsa == 0, "timer %d: callback dentro de la sección crítica", (int)(p - timers));
+    p->disparos++;
+    p->esperado = p->periodo ? p->esperado + p->periodo : 0;
+    if (!accionesAzar) return false;
+
+    switch (azar() % 8) {
+    case 0:   // Se rearma a sí mismo con otro retardo
+        armar(p, retardoAzar(), azar() % 2 ? retardoAzar() : 0, tickActual);
+        rearmados++;
+        break;
+    case 1: { // Cancela a otro
+        prueba_t *otro = &timers[azar() % TIMERS];
+        timerSoft_cancelar(&otro->timer);
+        otro->esperado = 0;
+        cancelados++;
+        break;
+    }
+    }
+    return false;
+}
+
+// Un tick de la rueda: el gptimer llega a su alarma y los disparos de tarea se atienden enseguida
+static void tick(void) {
+    tickActual++;
+    gptimerFalso_avanzar(timersSoft.timer, TIMERS_SOFT_TICK_US);
+    timerSoft_t *t;
+    while (xQueueReceive(timersSoft.cola, &t, 0) == pdTRUE) {
+        enTarea++;
+        t->funcion(t->arg);
+    }
+}
+
+static void revisarAleatorio(void) {
+    // El contador de 32 bits da la vuelta a mitad de la prueba
+    timersSoft.ahora = UINT32_MAX - TICKS / 2;
+    tickActual = (uint64_t)timersSoft.ahora - 1;
+    accionesAzar = true;
+    for (int i = 0; i < TIMERS; i++) {
+        timerSoft_crear(&timers[i].timer, disparo, &timers[i], i % 3 ? TIMER_SOFT_ISR : TIMER_SOFT_TAREA);
+        armar(&timers[i], retardoAzar(), i % 2 ? retardoAzar() : 0, tickActual);
+    }
+
+    uint32_t disparos = 0;
+    for (int n = 0; n < TICKS; n++) tick();
+    for (int i = 0; i < TIMERS; i++) {
+        disparos += timers[i].disparos;
+        COMPROBAR(timers[i].esperado == 0 || timers[i].esperado > tickActual,
+                  "timer %d no disparó en %llu (ahora %llu)", i, (unsigned long long)timers[i].esperado,
+                  (unsigned long long)tickActual);
+        COMPROBAR(timerSoft_armado(&timers[i].timer) == (timers[i].esperado != 0), "timer %d: armado %d, esperado %llu",
+                  i, timerSoft_armado(&timers[i].timer), (unsigned long long)timers[i].esperado);
+    }
+    COMPROBAR(disparos == timersSoft.disparos, "%lu disparos vistos, la rueda contó %lu", (unsigned long)disparos,
+              (unsigned long)timersSoft.disparos);
+    COMPROBAR(timersSoft.perdidos == 0, "%lu disparos de tarea perdidos", (unsigned long)timersSoft.perdidos);
+    printf("%d timers, %d ticks: %lu disparos (%lu en la tarea), %lu rearmados, %lu cancelados, hasta %lu por tick\n",
+           TIMERS, TICKS, (unsigned long)disparos, (unsigned long)enTarea, (unsigned long)rearmados,
+           (unsigned long)cancelados, (unsigned long)timersSoft.maximoPorTick);
+
+    for (int i = 0; i < TIMERS; i++) timerSoft_cancelar(&timers[i].timer);
+}
+
+// Sin timers armados el gptimer se detiene en el siguiente tick y ya no
+// interrumpe; armar uno lo arranca, el disparo cae en su tick y la rueda se
+// vuelve a detener
+static void revisarDetenido(void) {
+    gptimerFalso_t *g = timersSoft.timer;
+    accionesAzar = false;
+    tick();
+    COMPROBAR(!g->corriendo, "el gptimer sigue corriendo sin timers armados");
+    uint32_t alarmas = g->alarmas;
+    for (int n = 0; n < 1000; n++) gptimerFalso_avanzar(g, TIMERS_SOFT_TICK_US);
+    COMPROBAR(g->alarmas == alarmas, "%lu ticks con la rueda vacía", (unsigned long)(g->alarmas - alarmas));
+
+    prueba_t *p = &timers[0];
+    p->disparos = 0;
+    timerSoft_crear(&p->timer, disparo, p, TIMER_SOFT_ISR);
+    armar(p, 10, 0, tickActual);
+    COMPROBAR(g->corriendo, "armar no arrancó el gptimer");
+    for (int n = 0; n < 20; n++) tick();
+    COMPROBAR(p->disparos == 1 && !g->corriendo && g->alarmas - alarmas == 10,
+              "una vez a 10 ticks: %lu disparos, %lu ticks, corriendo %d", (unsigned long)p->disparos,
+              (unsigned long)(g->alarmas - alarmas), g->corriendo);
+}
+
+// Sin memoria para la cola o para la tarea
+static void revisarSinMemoria(void) {
+    for (int memoria = 0; memoria < 2; memoria++) {
+        memoriaFalsa = memoria;
+        esp_err_t err = timersSoft_iniciar();
+        COMPROBAR(err == ESP_ERR_NO_MEM && timersSoft.cola == NULL, "iniciar con %d creaciones: error %d",
+                  memoria, err);
+    }
+    memoriaFalsa = -1;
+}
+
+// Más allá de RUEDA_MAXIMO: una vez justo después del límite, una con millones
+// de ticks de sobra y una que necesita dos vueltas extra; y uno periódico. Los
+// ticks se dan directo a la ISR de la rueda: son 134 millones
+static void revisarLargos(void) {
+    static const uint32_t retardos[] = {RUEDA_MAXIMO, RUEDA_MAXIMO + 1, RUEDA_MAXIMO + 3000000,
+                                        2 * RUEDA_MAXIMO + 777};
+    const int n = sizeof(retardos) / sizeof(retardos[0]);
+    timersSoft.ahora = 0x00123457;   // A media casilla de todos los niveles
+    tickActual = (uint64_t)timersSoft.ahora - 1;
+    for (int i = 0; i < n; i++) {
+        timers[i].disparos = 0;
+        timerSoft_crear(&timers[i].timer, disparo, &timers[i], TIMER_SOFT_ISR);
+        armar(&timers[i], retardos[i], 0, tickActual);
+    }
+    prueba_t *periodico = &timers[n];
+    periodico->disparos = 0;
+    timerSoft_crear(&periodico->timer, disparo, periodico, TIMER_SOFT_ISR);
+    armar(periodico, 5, RUEDA_MAXIMO + 12345, tickActual);
+
+    accionesAzar = false;
+    uint64_t fin = tickActual + 2 * (uint64_t)RUEDA_MAXIMO + 1000;
+    while (tickActual < fin) {
+        tickActual++;
+        timersSoft_tick(NULL, NULL, NULL);
+    }
+    for (int i = 0; i < n; i++) {
+        COMPROBAR(timers[i].disparos == 1, "retardo de %lu ticks: %lu disparos", (unsigned long)retardos[i],
+                  (unsigned long)timers[i].disparos);
+    }
+    COMPROBAR(periodico->disparos == 2, "periodo de %lu ticks: %lu disparos", (unsigned long)periodico->periodo,
+              (unsigned long)periodico->disparos);
+}
+
+int main(void) {
+    revisarSinMemoria();
+    COMPROBAR(timersSoft_iniciar() == ESP_OK, "timersSoft_iniciar");
+    revisarAleatorio();
+    revisarDetenido();
+    revisarLargos();
+    return prueba_fin("prueba_timers_soft");
+}
@@ -0,0 +1,235 @@
+#pragma once
+// Declaraciones mínimas del ESP-IDF para compilar los programas en la PC.
+// Solo tipos, constantes y prototipos: las funciones que una prueba llega a
+// usar están en falsos.c, las demás se descartan al enlazar (--gc-sections).
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define DMA_ATTR WORD_ALIGNED_ATTR
+#define WORD_ALIGNED_ATTR __attribute__((aligned(4)))
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_TIMEOUT 0x107
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_STATE 0x103
+typedef int esp_err_t;
+#define ESP_ERROR_CHECK(x) (void)(x)
+#define ESP_ERROR_CHECK_WITHOUT_ABORT(x) (x)
+/* freertos */
+typedef uint32_t TickType_t; typedef long BaseType_t; typedef unsigned long UBaseType_t;
+typedef void* TaskHandle_t; typedef void* QueueHandle_t; typedef void* EventGroupHandle_t; typedef uint32_t EventBits_t;
+typedef void* SemaphoreHandle_t;
+typedef struct { int x; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+extern int seccionCriticaFalsa;   // Profundidad de las secciones críticas abiertas (falsos.c)
+#define portENTER_CRITICAL(m) ((void)(m), seccionCriticaFalsa++)
+#define portEXIT_CRITICAL(m) ((void)(m), seccionCriticaFalsa--)
+#define portENTER_CRITICAL_ISR(m) portENTER_CRITICAL(m)
+#define portEXIT_CRITICAL_ISR(m) portEXIT_CRITICAL(m)
+#define portENTER_CRITICAL_SAFE(m) portENTER_CRITICAL(m)
+#define portEXIT_CRITICAL_SAFE(m) portEXIT_CRITICAL(m)
+#define portMAX_DELAY 0xffffffffUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(x) ((TickType_t)(x))
+#define pdTICKS_TO_MS(x) ((uint32_t)(x))
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define configTICK_RATE_HZ 1000
+#define tskIDLE_PRIORITY 0
+#define configMAX_PRIORITIES 25
+#define portYIELD_FROM_ISR(...) (void)0
+#define portNUM_PROCESSORS 2
+typedef enum { eNoAction, eSetBits, eIncrement, eSetValueWithOverwrite, eSetValueWithoutOverwrite } eNotifyAction;
+typedef void (*TaskFunction_t)(void*);
+void vTaskDelay(TickType_t); void vTaskDelayUntil(TickType_t*, TickType_t); BaseType_t xTaskDelayUntil(TickType_t*, TickType_t);
+TickType_t xTaskGetTickCount(void); TickType_t xTaskGetTickCountFromISR(void);
+BaseType_t xTaskCreate(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*, BaseType_t);
+void vTaskDelete(TaskHandle_t); TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskNotifyFromISR(TaskHandle_t, uint32_t, eNotifyAction, BaseType_t*);
+BaseType_t xTaskNotify(TaskHandle_t, uint32_t, eNotifyAction);
+BaseType_t xTaskNotifyWait(uint32_t, uint32_t, uint32_t*, TickType_t);
+void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t*); BaseType_t xTaskNotifyGive(TaskHandle_t);
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t);
+void vTaskGetRunTimeStats(char*); void vTaskList(char*);
+uint32_t ulTaskGetIdleRunTimeCounter(void);
+typedef struct { TaskHandle_t xHandle; const char* pcTaskName; uint32_t ulRunTimeCounter; BaseType_t xCoreID; UBaseType_t uxCurrentPriority; } TaskStatus_t;
+UBaseType_t uxTaskGetNumberOfTasks(void); UBaseType_t uxTaskGetSystemState(TaskStatus_t*, UBaseType_t, uint32_t*);
+TaskHandle_t xTaskGetIdleTaskHandleForCPU(BaseType_t); TaskHandle_t xTaskGetIdleTaskHandleForCore(BaseType_t);
+QueueHandle_t xQueueCreate(UBaseType_t, UBaseType_t);
+void vQueueDelete(QueueHandle_t);
+BaseType_t xQueueSend(QueueHandle_t, const void*, TickType_t); BaseType_t xQueueReceive(QueueHandle_t, void*, TickType_t);
+BaseType_t xQueueSendFromISR(QueueHandle_t, const void*, BaseType_t*); BaseType_t xQueueOverwrite(QueueHandle_t, const void*);
+BaseType_t xQueueOverwriteFromISR(QueueHandle_t, const void*, BaseType_t*); BaseType_t xQueuePeek(QueueHandle_t, void*, TickType_t);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t);
+SemaphoreHandle_t xSemaphoreCreateBinary(void); BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t); BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t, BaseType_t*);
+EventGroupHandle_t xEventGroupCreate(void); EventBits_t xEventGroupWaitBits(EventGroupHandle_t, EventBits_t, BaseType_t, BaseType_t, TickType_t);
+BaseType_t xEventGroupSetBitsFromISR(EventGroupHandle_t, EventBits_t, BaseType_t*); EventBits_t xEventGroupSetBits(EventGroupHandle_t, EventBits_t);
+/* esp */
+int64_t esp_timer_get_time(void);
+typedef void* esp_timer_handle_t;
+typedef enum { ESP_TIMER_TASK, ESP_TIMER_ISR } esp_timer_dispatch_t;
+typedef struct { void (*callback)(void*); void* arg; esp_timer_dispatch_t dispatch_method; const char* name; bool skip_unhandled_events; } esp_timer_create_args_t;
+esp_err_t esp_timer_create(const esp_timer_create_args_t*, esp_timer_handle_t*);
+esp_err_t esp_timer_start_once(esp_timer_handle_t, uint64_t); esp_err_t esp_timer_start_periodic(esp_timer_handle_t, uint64_t);
+esp_err_t esp_timer_stop(esp_timer_handle_t); bool esp_timer_is_active(esp_timer_handle_t);
+esp_err_t esp_task_wdt_deinit(void); esp_err_t esp_task_wdt_add(TaskHandle_t); esp_err_t esp_task_wdt_reset(void);
+typedef struct { uint32_t timeout_ms; uint32_t idle_core_mask; bool trigger_panic; } esp_task_wdt_config_t;
+esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t*); esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t*);
+uint32_t esp_cpu_get_cycle_count(void);
+void *heap_caps_malloc(size_t, uint32_t); void *heap_caps_calloc(size_t, size_t, uint32_t);
+#define MALLOC_CAP_DMA 8
+#define MALLOC_CAP_INTERNAL 16
+#define MALLOC_CAP_8BIT 4
+int esp_rom_printf(const char*, ...);
+#define ESP_LOGI(tag, fmt, ...) ((void)(tag), printf(fmt "\n", ##__VA_ARGS__))
+#define ESP_LOGW(tag, fmt, ...) ((void)(tag), printf(fmt "\n", ##__VA_ARGS__))
+#define ESP_LOGE(tag, fmt, ...) ((void)(tag), printf(fmt "\n", ##__VA_ARGS__))
+/* gpio */
+typedef int gpio_num_t;
+typedef enum { GPIO_MODE_DISABLE, GPIO_MODE_INPUT, GPIO_MODE_OUTPUT, GPIO_MODE_INPUT_OUTPUT } gpio_mode_t;
+typedef enum { GPIO_INTR_DISABLE, GPIO_INTR_POSEDGE, GPIO_INTR_NEGEDGE, GPIO_INTR_ANYEDGE, GPIO_INTR_LOW_LEVEL, GPIO_INTR_HIGH_LEVEL } gpio_int_type_t;
+typedef enum { GPIO_PULLUP_ONLY, GPIO_PULLDOWN_ONLY, GPIO_PULLUP_PULLDOWN, GPIO_FLOATING } gpio_pull_mode_t;
+#define GPIO_PULLUP_ENABLE 1
+#define GPIO_PULLUP_DISABLE 0
+#define GPIO_PULLDOWN_DISABLE 0
+typedef struct { uint64_t pin_bit_mask; gpio_mode_t mode; int pull_up_en; int pull_down_en; gpio_int_type_t intr_type; } gpio_config_t;
+esp_err_t gpio_config(const gpio_config_t*); esp_err_t gpio_reset_pin(gpio_num_t);
+esp_err_t gpio_set_direction(gpio_num_t, gpio_mode_t); esp_err_t gpio_set_level(gpio_num_t, uint32_t); int gpio_get_level(gpio_num_t);
+esp_err_t gpio_set_intr_type(gpio_num_t, gpio_int_type_t); esp_err_t gpio_set_pull_mode(gpio_num_t, gpio_pull_mode_t);
+esp_err_t gpio_pullup_en(gpio_num_t); esp_err_t gpio_install_isr_service(int);
+typedef void (*gpio_isr_t)(void*);
+esp_err_t gpio_isr_handler_add(gpio_num_t, gpio_isr_t, void*); esp_err_t gpio_isr_handler_remove(gpio_num_t);
+esp_err_t gpio_intr_enable(gpio_num_t); esp_err_t gpio_intr_disable(gpio_num_t);
+typedef void* gpio_isr_handle_t;
+esp_err_t gpio_isr_register(void (*fn)(void*), void*, int, gpio_isr_handle_t*);
+#define ESP_INTR_FLAG_SHARED (1<<8)
+#define ESP_INTR_FLAG_IRAM (1<<10)
+#define ESP_INTR_FLAG_LEVEL1 (1<<1)
+typedef struct { uint32_t val; } gpio_reg1_t;
+typedef struct {
+  uint32_t out; uint32_t out_w1ts; uint32_t out_w1tc; gpio_reg1_t out1; gpio_reg1_t out1_w1ts; gpio_reg1_t out1_w1tc;
+  uint32_t in; gpio_reg1_t in1; uint32_t status; uint32_t status_w1tc; gpio_reg1_t status1; gpio_reg1_t status1_w1tc;
+  uint32_t pcpu_int; gpio_reg1_t pcpu_int1; uint32_t enable_w1ts; uint32_t enable_w1tc;
+} gpio_dev_t;
+// Cada mención de GPIO cuenta un acceso al bloque de registros y aplica las
+// escrituras W1TS/W1TC anteriores a "out", como el hardware
+extern volatile gpio_dev_t gpioFalso;
+volatile gpio_dev_t *gpioFalso_registro(void);
+#define GPIO (*gpioFalso_registro())
+/* gptimer */
+typedef void* gptimer_handle_t;
+typedef enum { GPTIMER_CLK_SRC_DEFAULT } gptimer_clock_source_t;
+typedef enum { GPTIMER_COUNT_DOWN, GPTIMER_COUNT_UP } gptimer_count_direction_t;
+typedef struct { gptimer_clock_source_t clk_src; gptimer_count_direction_t direction; uint32_t resolution_hz; int intr_priority; } gptimer_config_t;
+typedef struct { uint64_t alarm_count; uint64_t reload_count; struct { uint32_t auto_reload_on_alarm:1; } flags; } gptimer_alarm_config_t;
+typedef struct { uint64_t count_value; uint64_t alarm_value; } gptimer_alarm_event_data_t;
+typedef bool (*gptimer_alarm_cb_t)(gptimer_handle_t, const gptimer_alarm_event_data_t*, void*);
+typedef struct { gptimer_alarm_cb_t on_alarm; } gptimer_event_callbacks_t;
+esp_err_t gptimer_new_timer(const gptimer_config_t*, gptimer_handle_t*); esp_err_t gptimer_set_alarm_action(gptimer_handle_t, const gptimer_alarm_config_t*);
+esp_err_t gptimer_register_event_callbacks(gptimer_handle_t, const gptimer_event_callbacks_t*, void*);
+esp_err_t gptimer_enable(gptimer_handle_t); esp_err_t gptimer_start(gptimer_handle_t); esp_err_t gptimer_stop(gptimer_handle_t);
+esp_err_t gptimer_get_raw_count(gptimer_handle_t, uint64_t*); esp_err_t gptimer_set_raw_count(gptimer_handle_t, uint64_t);
+/* mcpwm legacy */
+typedef enum { MCPWM_UNIT_0, MCPWM_UNIT_1, MCPWM_UNIT_MAX } mcpwm_unit_t;
+typedef enum { MCPWM_TIMER_0, MCPWM_TIMER_1, MCPWM_TIMER_2, MCPWM_TIMER_MAX } mcpwm_timer_t;
+typedef enum { MCPWM_OPR_A, MCPWM_OPR_B, MCPWM_OPR_MAX } mcpwm_generator_t;
+#define mcpwm_operator_t mcpwm_generator_t
+typedef enum { MCPWM0A, MCPWM0B, MCPWM1A, MCPWM1B, MCPWM2A, MCPWM2B } mcpwm_io_signals_t;
+typedef enum { MCPWM_UP_COUNTER=1 } mcpwm_counter_type_t; typedef enum { MCPWM_DUTY_MODE_0 } mcpwm_duty_type_t;
+typedef struct { uint32_t frequency; float cmpr_a; float cmpr_b; mcpwm_duty_type_t duty_mode; mcpwm_counter_type_t counter_mode; } mcpwm_config_t;
+esp_err_t mcpwm_gpio_init(mcpwm_unit_t, mcpwm_io_signals_t, int); esp_err_t mcpwm_init(mcpwm_unit_t, mcpwm_timer_t, const mcpwm_config_t*);
+esp_err_t mcpwm_set_duty_in_us(mcpwm_unit_t, mcpwm_timer_t, mcpwm_generator_t, uint32_t);
+esp_err_t mcpwm_set_duty_type(mcpwm_unit_t, mcpwm_timer_t, mcpwm_generator_t, mcpwm_duty_type_t);
+/* adc legacy */
+typedef enum { ADC_CHANNEL_9 = 9 } adc_channel_t; typedef int adc1_channel_t;
+typedef enum { ADC_WIDTH_BIT_12 } adc_bits_width_t; typedef enum { ADC_ATTEN_DB_11 } adc_atten_t;
+int adc1_get_raw(int); esp_err_t adc1_config_width(adc_bits_width_t); esp_err_t adc1_config_channel_atten(int, adc_atten_t);
+/* i2c */
+typedef enum { I2C_NUM_0 } i2c_port_t; typedef enum { I2C_MODE_MASTER } i2c_mode_t; typedef void* i2c_cmd_handle_t;
+#define I2C_MASTER_WRITE 0
+#define I2C_MASTER_READ 1
+#define I2C_MASTER_LAST_NACK 2
+typedef struct { i2c_mode_t mode; int sda_io_num; int scl_io_num; int sda_pullup_en; int scl_pullup_en; struct { uint32_t clk_speed; } master; } i2c_config_t;
+esp_err_t i2c_param_config(i2c_port_t, const i2c_config_t*); esp_err_t i2c_driver_install(i2c_port_t, i2c_mode_t, size_t, size_t, int);
+i2c_cmd_handle_t i2c_cmd_link_create(void); void i2c_cmd_link_delete(i2c_cmd_handle_t);
+esp_err_t i2c_master_start(i2c_cmd_handle_t); esp_err_t i2c_master_stop(i2c_cmd_handle_t);
+esp_err_t i2c_master_write_byte(i2c_cmd_handle_t, uint8_t, bool); esp_err_t i2c_master_read(i2c_cmd_handle_t, uint8_t*, size_t, int);
+esp_err_t i2c_master_cmd_begin(i2c_port_t, i2c_cmd_handle_t, TickType_t);
+/* esp_lcd rgb */
+typedef void* esp_lcd_panel_handle_t;
+typedef enum { LCD_CLK_SRC_DEFAULT, LCD_CLK_SRC_PLL160M, LCD_CLK_SRC_XTAL } lcd_clock_source_t;
+typedef struct { uint32_t pclk_hz; uint32_t h_res; uint32_t v_res; uint32_t hsync_pulse_width; uint32_t hsync_back_porch; uint32_t hsync_front_porch; uint32_t vsync_pulse_width; uint32_t vsync_back_porch; uint32_t vsync_front_porch; struct { uint32_t hsync_idle_low:1; uint32_t vsync_idle_low:1; uint32_t de_idle_high:1; uint32_t pclk_active_neg:1; uint32_t pclk_idle_high:1; } flags; } esp_lcd_rgb_timing_t;
+typedef struct { lcd_clock_source_t clk_src; esp_lcd_rgb_timing_t timings; size_t data_width; size_t bits_per_pixel; size_t num_fbs; size_t bounce_buffer_size_px; size_t sram_trans_align; size_t psram_trans_align; int hsync_gpio_num; int vsync_gpio_num; int de_gpio_num; int pclk_gpio_num; int disp_gpio_num; int data_gpio_nums[16]; struct { uint32_t disp_active_low:1; uint32_t refresh_on_demand:1; uint32_t fb_in_psram:1; uint32_t double_fb:1; uint32_t no_fb:1; uint32_t bb_invalidate_cache:1; } flags; } esp_lcd_rgb_panel_config_t;
+esp_err_t esp_lcd_new_rgb_panel(const esp_lcd_rgb_panel_config_t*, esp_lcd_panel_handle_t*);
+esp_err_t esp_lcd_rgb_panel_get_frame_buffer(esp_lcd_panel_handle_t, uint32_t, void**, ...);
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t); esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t);
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t, int, int, int, int, const void*);
+typedef struct { int x; } esp_lcd_rgb_panel_event_data_t;
+typedef bool (*esp_lcd_rgb_panel_vsync_cb_t)(esp_lcd_panel_handle_t, const esp_lcd_rgb_panel_event_data_t*, void*);
+typedef struct { esp_lcd_rgb_panel_vsync_cb_t on_vsync; esp_lcd_rgb_panel_vsync_cb_t on_bounce_empty; esp_lcd_rgb_panel_vsync_cb_t on_bounce_frame_finish; } esp_lcd_rgb_panel_event_callbacks_t;
+esp_err_t esp_lcd_rgb_panel_register_event_callbacks(esp_lcd_panel_handle_t, const esp_lcd_rgb_panel_event_callbacks_t*, void*);
+#define GPIO_NUM_NC (-1)
+/* spi */
+typedef enum { SPI1_HOST, SPI2_HOST, SPI3_HOST } spi_host_device_t;
+#define SPI_DMA_CH_AUTO 3
+typedef void* spi_device_handle_t;
+typedef struct { int mosi_io_num; int miso_io_num; int sclk_io_num; int quadwp_io_num; int quadhd_io_num; int max_transfer_sz; uint32_t flags; } spi_bus_config_t;
+typedef struct { uint8_t mode; int clock_speed_hz; int spics_io_num; uint32_t flags; int queue_size; void (*pre_cb)(void*); void (*post_cb)(void*); } spi_device_interface_config_t;
+typedef struct { uint32_t flags; size_t length; size_t rxlength; void *user; const void *tx_buffer; void *rx_buffer; } spi_transaction_t;
+esp_err_t spi_bus_initialize(spi_host_device_t, const spi_bus_config_t*, int);
+esp_err_t spi_bus_add_device(spi_host_device_t, const spi_device_interface_config_t*, spi_device_handle_t*);
+esp_err_t spi_device_queue_trans(spi_device_handle_t, spi_transaction_t*, TickType_t);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t, spi_transaction_t**, TickType_t);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t, spi_transaction_t*);
+BaseType_t xPortGetCoreID(void);
+typedef struct { struct { uint32_t timer0_tez_int_ena:1; uint32_t timer1_tez_int_ena:1; uint32_t timer2_tez_int_ena:1; } int_ena; struct { uint32_t timer0_tez_int_clr:1; uint32_t timer1_tez_int_clr:1; uint32_t timer2_tez_int_clr:1; } int_clr; struct { uint32_t timer0_tez_int_st:1; } int_st; } mcpwm_dev_t;
+extern volatile mcpwm_dev_t MCPWM0, MCPWM1;
+void mcpwm_ll_operator_set_compare_value(volatile mcpwm_dev_t *, int, int, uint32_t);
+typedef void* intr_handle_t;
+esp_err_t esp_intr_alloc(int, int, void (*)(void*), void*, intr_handle_t*);
+#define ETS_PWM0_INTR_SOURCE 31
+#define ETS_PWM1_INTR_SOURCE 32
+typedef enum { MCPWM_SELECT_NO_INPUT, MCPWM_SELECT_TIMER0_SYNC, MCPWM_SELECT_TIMER1_SYNC, MCPWM_SELECT_TIMER2_SYNC } mcpwm_sync_signal_t;
+typedef enum { MCPWM_SWSYNC_SOURCE_SYNCIN, MCPWM_SWSYNC_SOURCE_TEZ, MCPWM_SWSYNC_SOURCE_TEP, MCPWM_SWSYNC_SOURCE_DISABLED } mcpwm_timer_sync_trigger_t;
+typedef enum { MCPWM_TIMER_DIRECTION_UP, MCPWM_TIMER_DIRECTION_DOWN } mcpwm_timer_direction_t;
+typedef struct { mcpwm_sync_signal_t sync_sig; uint32_t timer_val; mcpwm_timer_direction_t count_direction; } mcpwm_sync_config_t;
+esp_err_t mcpwm_sync_configure(mcpwm_unit_t, mcpwm_timer_t, const mcpwm_sync_config_t*);
+esp_err_t mcpwm_set_timer_sync_output(mcpwm_unit_t, mcpwm_timer_t, mcpwm_timer_sync_trigger_t);
+esp_err_t mcpwm_group_set_resolution(mcpwm_unit_t, unsigned long int);
+esp_err_t mcpwm_timer_set_resolution(mcpwm_unit_t, mcpwm_timer_t, unsigned long int);
+typedef enum { LEDC_LOW_SPEED_MODE } ledc_mode_t;
+typedef enum { LEDC_TIMER_0, LEDC_TIMER_1 } ledc_timer_t;
+typedef enum { LEDC_CHANNEL_0, LEDC_CHANNEL_1 } ledc_channel_t;
+typedef enum { LEDC_TIMER_14_BIT = 14 } ledc_timer_bit_t;
+typedef enum { LEDC_AUTO_CLK } ledc_clk_cfg_t;
+typedef enum { LEDC_INTR_DISABLE } ledc_intr_type_t;
+typedef struct { ledc_mode_t speed_mode; ledc_timer_bit_t duty_resolution; ledc_timer_t timer_num; uint32_t freq_hz; ledc_clk_cfg_t clk_cfg; } ledc_timer_config_t;
+typedef struct { int gpio_num; ledc_mode_t speed_mode; ledc_channel_t channel; ledc_intr_type_t intr_type; ledc_timer_t timer_sel; uint32_t duty; int hpoint; } ledc_channel_config_t;
+esp_err_t ledc_timer_config(const ledc_timer_config_t *);
+esp_err_t ledc_channel_config(const ledc_channel_config_t *);
+esp_err_t ledc_set_freq(ledc_mode_t, ledc_timer_t, uint32_t);
+uint32_t ledc_get_freq(ledc_mode_t, ledc_timer_t);
+esp_err_t ledc_set_duty(ledc_mode_t, ledc_channel_t, uint32_t);
+esp_err_t ledc_update_duty(ledc_mode_t, ledc_channel_t);
+typedef union { struct { uint16_t duration0 : 15; uint16_t level0 : 1; uint16_t duration1 : 15; uint16_t level1 : 1; }; uint32_t val; } rmt_symbol_word_t;
+typedef struct rmt_channel_t *rmt_channel_handle_t;
+typedef struct rmt_encoder_t *rmt_encoder_handle_t;
+typedef enum { RMT_CLK_SRC_DEFAULT } rmt_clock_source_t;
+typedef struct { int gpio_num; rmt_clock_source_t clk_src; uint32_t resolution_hz; size_t mem_block_symbols; size_t trans_queue_depth; struct { uint32_t invert_out:1; uint32_t with_dma:1; } flags; } rmt_tx_channel_config_t;
+typedef struct { int loop_count; struct { uint32_t eot_level:1; } flags; } rmt_transmit_config_t;
+typedef struct { int dummy; } rmt_copy_encoder_config_t;
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *, rmt_channel_handle_t *);
+esp_err_t rmt_new_copy_encoder(const rmt_copy_encoder_config_t *, rmt_encoder_handle_t *);
+esp_err_t rmt_enable(rmt_channel_handle_t);
+esp_err_t rmt_disable(rmt_channel_handle_t);
+esp_err_t rmt_del_channel(rmt_channel_handle_t);
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t);
+esp_err_t rmt_transmit(rmt_channel_handle_t, rmt_encoder_handle_t, const void *, size_t, const rmt_transmit_config_t *);
+esp_err_t rmt_tx_wait_all_done(rmt_channel_handle_t, int);